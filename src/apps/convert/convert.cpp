@@ -36,12 +36,19 @@
 #include <string>
 #include <iostream>
 
+#include <vector>
+#include <utility>
+
 #include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
 #include <boost/program_options.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include <chemkit/chemkit.h>
+#include <chemkit/foreach.h>
+#include <chemkit/molecule.h>
 #include <chemkit/moleculefile.h>
+#include <chemkit/moleculehash.h>
 
 void printHelp(char *argv[], const boost::program_options::options_description &options)
 {
@@ -75,6 +82,8 @@ int main(int argc, char *argv[])
         ("output-format,o",
             boost::program_options::value<std::string>(&outputFormatName),
             "Sets the output format.")
+        ("unique,u",
+            "Removes duplicate molecules.")
         ("help,h",
             "Shows this help message");
 
@@ -128,21 +137,67 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // remove duplicates
+    chemkit::MoleculeFile *outputFile = &inputFile;
+    chemkit::MoleculeFile uniqueFile;
+
+    if(variables.count("unique")){
+        // molecules are kept in the order they are read. molecules with
+        // the same hash are compared by their canonical form so that
+        // collisions are not dropped. each kept molecule's canonical form
+        // is computed once, the first time another molecule hashes to it.
+        // stereochemistry is included so that stereoisomers are kept
+        typedef std::vector<boost::uint64_t> CanonicalForm;
+        typedef std::pair<const chemkit::Molecule *, CanonicalForm> UniqueMolecule;
+
+        const int flags = chemkit::MoleculeHash::IncludeStereochemistry;
+        boost::unordered_map<chemkit::MoleculeHash, std::vector<UniqueMolecule> > molecules;
+
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, inputFile.molecules()){
+            std::vector<UniqueMolecule> &matches = molecules[chemkit::MoleculeHash(molecule.get(), flags)];
+
+            CanonicalForm form;
+            if(!matches.empty()){
+                form = chemkit::MoleculeHash::canonicalForm(molecule.get(), flags);
+            }
+
+            bool duplicate = false;
+            for(size_t i = 0; i < matches.size(); i++){
+                UniqueMolecule &match = matches[i];
+                if(match.second.empty()){
+                    match.second = chemkit::MoleculeHash::canonicalForm(match.first, flags);
+                }
+
+                if(match.second == form){
+                    duplicate = true;
+                    break;
+                }
+            }
+
+            if(!duplicate){
+                matches.push_back(UniqueMolecule(molecule.get(), form));
+                uniqueFile.addMolecule(molecule);
+            }
+        }
+
+        outputFile = &uniqueFile;
+    }
+
     // write output
     if(outputFormatName.empty()){
-        ok = inputFile.write(outputFileName);
+        ok = outputFile->write(outputFileName);
     }
     else{
         if(outputFileName == "-"){
-            ok = inputFile.write(std::cout, outputFormatName);
+            ok = outputFile->write(std::cout, outputFormatName);
         }
         else{
-            ok = inputFile.write(outputFileName, outputFormatName);
+            ok = outputFile->write(outputFileName, outputFormatName);
         }
     }
 
     if(!ok){
-        std::cerr << "Error: failed to write output file: " << inputFile.errorString() << std::endl;
+        std::cerr << "Error: failed to write output file: " << outputFile->errorString() << std::endl;
         return -1;
     }
 
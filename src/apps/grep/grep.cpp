@@ -81,6 +81,8 @@ int main(int argc, char *argv[])
             "Return only non-matching molecules.")
         ("names-only,n",
             "Output only the names of matching molecules.")
+        ("screen,s",
+            "Screen molecules with a path fingerprint before searching.")
         ("help,h",
             "Shows this help message");
 
@@ -145,6 +147,7 @@ int main(int argc, char *argv[])
     bool exactMatch = variables.find("exact-match") != variables.end();
     bool invertMatch = variables.find("invert-match") != variables.end();
     bool namesOnly = variables.find("names-only") != variables.end();
+    bool screen = variables.find("screen") != variables.end();
 
     int flags = 0;
     if(compositionOnly){
@@ -157,6 +160,7 @@ int main(int argc, char *argv[])
     chemkit::SubstructureQuery query;
     query.setMolecule(patternMolecule);
     query.setFlags(flags);
+    query.setScreeningEnabled(screen);
 
     chemkit::MoleculeFile outputFile;
 
@@ -101,6 +101,7 @@ void Atom::setAtomicNumber(AtomicNumberType atomicNumber)
     }
 
     m_molecule->m_elements[m_index].setAtomicNumber(atomicNumber);
+    m_molecule->setAromaticityPerceived(false);
     m_molecule->notifyWatchers(this, MoleculeWatcher::AtomElementChanged);
 }
 
@@ -157,6 +158,7 @@ void Atom::setType(const std::string &type)
     }
 
     atomTypes[m_index] = type;
+    m_molecule->d->version++;
 }
 
 /// Returns the symbolic type for the atom or an empty string if no
@@ -401,56 +403,38 @@ Ring* Atom::ring(size_t index) const
 /// \see Molecule::rings()
 Atom::RingRange Atom::rings() const
 {
-    // range of all rings in the molecule
-    const Molecule::RingRange moleculeRings = m_molecule->rings();
+    // ensure rings have been perceived
+    m_molecule->rings();
 
-    // predicate function to check if a ring contains this atom
-    boost::function<bool (const Ring *)> ringContainsThisAtom =
-        boost::bind(static_cast<bool (Ring::*)(const Atom *) const>(&Ring::contains), _1, this);
+    const MoleculePrivate *d = m_molecule->d;
 
-    return boost::make_iterator_range(
-               boost::make_filter_iterator<
-                   boost::function<bool (const Ring *)> >(ringContainsThisAtom,
-                                                          moleculeRings.begin(),
-                                                          moleculeRings.end()),
-               boost::make_filter_iterator<
-                    boost::function<bool (const Ring *)> >(ringContainsThisAtom,
-                                                           moleculeRings.end(),
-                                                           moleculeRings.end()));
+    // atoms added after ring perception are not in any rings
+    if(m_index + 1 >= d->atomRingOffsets.size()){
+        return boost::make_iterator_range(d->atomRings.end(), d->atomRings.end());
+    }
+
+    return boost::make_iterator_range(d->atomRings.begin() + d->atomRingOffsets[m_index],
+                                      d->atomRings.begin() + d->atomRingOffsets[m_index + 1]);
 }
 
 /// Returns the number of rings that contain the atom.
 size_t Atom::ringCount() const
 {
-    size_t count = 0;
-
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->contains(this)){
-            count++;
-        }
-    }
-
-    return count;
+    return rings().size();
 }
 
 /// Returns \c true if the atom is a member of at least one ring
 /// (i.e. ringCount() >= 1).
 bool Atom::isInRing() const
 {
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->contains(this)){
-            return true;
-        }
-    }
-
-    return false;
+    return !rings().empty();
 }
 
 /// Returns \c true if the atom is a member of a ring of given size.
 bool Atom::isInRing(size_t size) const
 {
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->size() == size && ring->contains(this)){
+    foreach(const Ring *ring, rings()){
+        if(ring->size() == size){
             return true;
         }
     }
@@ -462,27 +446,20 @@ bool Atom::isInRing(size_t size) const
 /// atom is not in a ring.
 Ring* Atom::smallestRing() const
 {
-    Ring *smallest = 0;
-
-    foreach(Ring *ring, rings()){
-        if(!smallest || ring->size() < smallest->size()){
-            smallest = ring;
-        }
+    if(!isInRing()){
+        return 0;
     }
 
-    return smallest;
+    return m_molecule->d->atomSmallestRings[m_index];
 }
 
-/// Returns \c true if the atom is in an aromatic ring.
+/// Returns \c true if the atom is aromatic. By default this is
+/// \c true if the atom is in an aromatic ring.
+///
+/// \see Molecule::setAromaticityModel()
 bool Atom::isAromatic() const
 {
-    foreach(const Ring *ring, rings()){
-        if(ring->isAromatic()){
-            return true;
-        }
-    }
-
-    return false;
+    return m_molecule->isAromaticAtom(this);
 }
 
 // --- Geometry ------------------------------------------------------------ //
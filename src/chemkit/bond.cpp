@@ -35,8 +35,6 @@
 
 #include "bond.h"
 
-#include <boost/bind.hpp>
-
 #include "atom.h"
 #include "ring.h"
 #include "foreach.h"
@@ -108,6 +106,7 @@ Atom* Bond::otherAtom(const Atom *atom) const
 void Bond::setOrder(BondOrderType order)
 {
     m_molecule->d->bondOrders[m_index] = order;
+    m_molecule->setAromaticityPerceived(false);
 
     molecule()->notifyWatchers(this, MoleculeWatcher::BondOrderChanged);
 }
@@ -208,56 +207,33 @@ Ring* Bond::ring(size_t index) const
 /// \see Molecule::rings()
 Bond::RingRange Bond::rings() const
 {
-    // range of all rings in the molecule
-    const Molecule::RingRange moleculeRings = m_molecule->rings();
-
-    // predicate function to check if a ring contains this bond
-    boost::function<bool (const Ring *)> ringContainsThisBond =
-        boost::bind(static_cast<bool (Ring::*)(const Bond *) const>(&Ring::contains), _1, this);
-
-    return boost::make_iterator_range(
-               boost::make_filter_iterator<
-                   boost::function<bool (const Ring *)> >(ringContainsThisBond,
-                                                          moleculeRings.begin(),
-                                                          moleculeRings.end()),
-               boost::make_filter_iterator<
-                    boost::function<bool (const Ring *)> >(ringContainsThisBond,
-                                                           moleculeRings.end(),
-                                                           moleculeRings.end()));
+    // ensure rings have been perceived
+    m_molecule->rings();
+
+    const MoleculePrivate *d = m_molecule->d;
+
+    return boost::make_iterator_range(d->bondRings.begin() + d->bondRingOffsets[m_index],
+                                      d->bondRings.begin() + d->bondRingOffsets[m_index + 1]);
 }
 
 /// Returns the number of rings that contain the bond.
 size_t Bond::ringCount() const
 {
-    size_t count = 0;
-
-    foreach(const Ring *ring, m_molecule->rings()){
-        if(ring->contains(this)){
-            count++;
-        }
-    }
-
-    return count;
+    return rings().size();
 }
 
 /// Returns \c true if the bond is a member of at least one ring.
 /// (i.e. ringCount() >= 1).
 bool Bond::isInRing() const
 {
-    foreach(const Ring *ring, molecule()->rings()){
-        if(ring->contains(this)){
-            return true;
-        }
-    }
-
-    return false;
+    return !rings().empty();
 }
 
 /// Returns \c true if the bond is in a ring of given size.
 bool Bond::isInRing(size_t size) const
 {
-    foreach(const Ring *ring, molecule()->rings()){
-        if(ring->size() == size && ring->contains(this)){
+    foreach(const Ring *ring, rings()){
+        if(ring->size() == size){
             return true;
         }
     }
@@ -269,29 +245,20 @@ bool Bond::isInRing(size_t size) const
 /// bond is not in a ring.
 Ring* Bond::smallestRing() const
 {
-    Ring *smallest = 0;
-
-    foreach(Ring *ring, rings()){
-        if(!smallest || ring->size() < smallest->size()){
-            smallest = ring;
-        }
+    if(!isInRing()){
+        return 0;
     }
 
-    return smallest;
+    return m_molecule->d->bondSmallestRings[m_index];
 }
 
-/// Returns \c true if the bond is in an aromatic ring.
+/// Returns \c true if the bond is aromatic. By default this is
+/// \c true if the bond is in an aromatic ring.
 ///
-/// \see Ring::isAromatic()
+/// \see Ring::isAromatic(), Molecule::setAromaticityModel()
 bool Bond::isAromatic() const
 {
-    foreach(const Ring *ring, rings()){
-        if(ring->isAromatic()){
-            return true;
-        }
-    }
-
-    return false;
+    return m_molecule->isAromaticBond(this);
 }
 
 // --- Geometry ------------------------------------------------------------ //
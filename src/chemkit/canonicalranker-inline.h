@@ -0,0 +1,88 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_CANONICALRANKER_INLINE_H
+#define CHEMKIT_CANONICALRANKER_INLINE_H
+
+#include "canonicalranker.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the molecule the ranks were calculated for.
+inline const Molecule* CanonicalRanker::molecule() const
+{
+    return m_molecule;
+}
+
+/// Returns the number of atoms ranked.
+inline size_t CanonicalRanker::size() const
+{
+    return m_ranks.size();
+}
+
+// --- Ranks --------------------------------------------------------------- //
+/// Returns the canonical rank of the atom at index \p atom. Ranks
+/// are unique and range from \c 0 to \c size() - 1.
+inline size_t CanonicalRanker::rank(size_t atom) const
+{
+    return m_ranks[atom];
+}
+
+/// Returns the canonical rank for each atom in the molecule.
+inline const std::vector<size_t>& CanonicalRanker::ranks() const
+{
+    return m_ranks;
+}
+
+// --- Symmetry ------------------------------------------------------------ //
+/// Returns the symmetry class of the atom at index \p atom. Atoms
+/// with the same symmetry class could not be distinguished by their
+/// invariants or those of their neighbors.
+inline size_t CanonicalRanker::symmetryClass(size_t atom) const
+{
+    return m_symmetryClasses[atom];
+}
+
+/// Returns the number of distinct symmetry classes.
+inline size_t CanonicalRanker::symmetryClassCount() const
+{
+    return m_symmetryClassCount;
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_CANONICALRANKER_INLINE_H
@@ -0,0 +1,781 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "canonicalranker.h"
+
+#include <algorithm>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+#include "atom.h"
+#include "bond.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculeview.h"
+#include "stereoparity.h"
+
+namespace chemkit {
+
+namespace {
+
+// Bond codes used in the neighbor invariants. Aromatic bonds get their
+// own code so that different kekule structures rank identically. When
+// stereochemistry is included it is stored above the bond type.
+enum {
+    AromaticBondCode = 5,
+    BondTypeCount = 8,
+    BondCodeCount = 64
+};
+
+// Compares two rows in a flat array of invariants.
+class InvariantCompare
+{
+public:
+    InvariantCompare(const std::vector<size_t> &invariants, size_t width)
+        : m_invariants(invariants),
+          m_width(width)
+    {
+    }
+
+    bool operator()(size_t a, size_t b) const
+    {
+        const size_t *rowA = &m_invariants[a * m_width];
+        const size_t *rowB = &m_invariants[b * m_width];
+
+        return std::lexicographical_compare(rowA, rowA + m_width, rowB, rowB + m_width);
+    }
+
+private:
+    const std::vector<size_t> &m_invariants;
+    size_t m_width;
+};
+
+// Sets the rank of each atom to the number of distinct invariant rows
+// that sort before its own row. Returns the number of distinct rows.
+size_t rankInvariants(const std::vector<size_t> &invariants,
+                      size_t width,
+                      std::vector<size_t> &order,
+                      std::vector<size_t> &ranks)
+{
+    if(order.empty()){
+        return 0;
+    }
+
+    InvariantCompare compare(invariants, width);
+    std::sort(order.begin(), order.end(), compare);
+
+    size_t rank = 0;
+    ranks[order[0]] = 0;
+
+    for(size_t i = 1; i < order.size(); i++){
+        if(compare(order[i-1], order[i])){
+            rank++;
+        }
+
+        ranks[order[i]] = rank;
+    }
+
+    return rank + 1;
+}
+
+// Refines the ranks of the atoms in order by the ranks of each atom's
+// neighbors until the number of distinct ranks stops increasing. Each
+// row contains the atom's current rank followed by the sorted codes
+// for its neighbors so the new ranks never reorder atoms with
+// different current ranks. The atoms in order must include every
+// neighbor of each of its atoms.
+size_t refineRanks(const MoleculeView &view,
+                   const std::vector<size_t> &bondCodes,
+                   size_t width,
+                   size_t count,
+                   std::vector<size_t> &order,
+                   std::vector<size_t> &ranks)
+{
+    std::vector<size_t> invariants(view.size() * width);
+
+    for(;;){
+        foreach(size_t i, order){
+            size_t *row = &invariants[i * width];
+            size_t length = 1;
+
+            row[0] = ranks[i];
+
+            foreach(size_t bond, view.bonds(i)){
+                size_t neighbor = view.otherAtom(bond, i);
+
+                row[length++] = (ranks[neighbor] + 1) * BondCodeCount + bondCodes[bond];
+            }
+
+            std::sort(row + 1, row + length);
+            std::fill(row + length, row + width, 0);
+        }
+
+        size_t refinedCount = rankInvariants(invariants, width, order, ranks);
+        if(refinedCount == count){
+            return count;
+        }
+
+        count = refinedCount;
+    }
+}
+
+// Gives the atom a lower rank than the other atoms in order that are
+// tied with it and refines the ranks. Returns the number of distinct
+// ranks.
+size_t individualize(const MoleculeView &view,
+                     const std::vector<size_t> &bondCodes,
+                     size_t width,
+                     size_t count,
+                     size_t atom,
+                     std::vector<size_t> &order,
+                     std::vector<size_t> &ranks)
+{
+    size_t tiedRank = ranks[atom];
+
+    foreach(size_t i, order){
+        bool tied = ranks[i] == tiedRank;
+
+        ranks[i] *= 2;
+
+        if(tied && i != atom){
+            ranks[i]++;
+        }
+    }
+
+    return refineRanks(view, bondCodes, width, count + 1, order, ranks);
+}
+
+// Splits each tied set of terminal atoms in order that are bonded to
+// the same atom and refines the ranks. Swapping two such atoms does
+// not change the molecule so they can be ordered by their index
+// without searching. Returns the number of distinct ranks.
+size_t splitTerminalAtoms(const MoleculeView &view,
+                          const std::vector<size_t> &bondCodes,
+                          size_t width,
+                          size_t count,
+                          std::vector<size_t> &order,
+                          std::vector<size_t> &ranks)
+{
+    const size_t NoAtom = size_t(-1);
+
+    for(;;){
+        // the atom that every terminal atom with each rank is bonded
+        // to, or NoAtom if the atoms with the rank are not all
+        // terminal atoms bonded to the same atom
+        std::vector<size_t> centers(count, NoAtom);
+        std::vector<size_t> rankCounts(count, 0);
+        std::vector<char> valid(count, true);
+
+        foreach(size_t i, order){
+            size_t rank = ranks[i];
+            rankCounts[rank]++;
+
+            if(view.neighborCount(i) != 1){
+                valid[rank] = false;
+                continue;
+            }
+
+            size_t center = *view.neighbors(i).begin();
+
+            if(centers[rank] == NoAtom){
+                centers[rank] = center;
+            }
+            else if(centers[rank] != center){
+                valid[rank] = false;
+            }
+        }
+
+        bool split = false;
+        for(size_t rank = 0; rank < count; rank++){
+            if(rankCounts[rank] > 1 && valid[rank]){
+                split = true;
+                break;
+            }
+        }
+
+        if(!split){
+            return count;
+        }
+
+        // rank the atoms by their current rank followed by their
+        // position among the atoms they are tied with
+        std::vector<size_t> invariants(2 * view.size());
+        std::vector<size_t> positions(count, 0);
+
+        foreach(size_t i, order){
+            size_t rank = ranks[i];
+
+            invariants[2 * i] = rank;
+            invariants[2 * i + 1] = rankCounts[rank] > 1 && valid[rank] ? positions[rank]++ : 0;
+        }
+
+        count = rankInvariants(invariants, 2, order, ranks);
+        count = refineRanks(view, bondCodes, width, count, order, ranks);
+    }
+}
+
+// Sets certificate to the sorted list of bonds with their atoms
+// replaced by their ranks. Each rank must be less than size.
+void rankedBonds(const MoleculeView &view,
+                 const std::vector<size_t> &bondCodes,
+                 const std::vector<size_t> &bonds,
+                 const std::vector<size_t> &ranks,
+                 boost::uint64_t size,
+                 std::vector<boost::uint64_t> &certificate)
+{
+    certificate.resize(bonds.size());
+
+    for(size_t i = 0; i < bonds.size(); i++){
+        size_t bond = bonds[i];
+        boost::uint64_t a = ranks[view.bondAtom1(bond)];
+        boost::uint64_t b = ranks[view.bondAtom2(bond)];
+
+        if(b < a){
+            std::swap(a, b);
+        }
+
+        certificate[i] = (a * size + b) * BondCodeCount + bondCodes[bond];
+    }
+
+    std::sort(certificate.begin(), certificate.end());
+}
+
+// The CanonicalSearch class searches for the canonical ranks of the
+// atoms in a fragment which could not all be distinguished by
+// refinement.
+//
+// Each tied atom in the first tied rank is given a lower rank in
+// turn and the ranks are refined, recursively, until every atom has a
+// unique rank. The ranks that give the lexicographically smallest
+// sorted list of ranked bonds are kept. Ranks which give the same list
+// of bonds as the best ranks found so far describe an automorphism of
+// the fragment which is used to skip parts of the search that can
+// only give equivalent ranks.
+class CanonicalSearch
+{
+public:
+    CanonicalSearch(const MoleculeView &view,
+                    const std::vector<size_t> &bondCodes,
+                    size_t width,
+                    const std::vector<size_t> &atoms,
+                    const std::vector<size_t> &bonds);
+
+    void search(std::vector<size_t> &ranks, size_t count);
+
+private:
+    size_t search(const std::vector<size_t> &ranks, size_t count, std::vector<size_t> &path);
+    size_t leaf(const std::vector<size_t> &ranks, const std::vector<size_t> &path);
+    size_t orbit(std::vector<size_t> &parents, size_t atom) const;
+
+private:
+    const MoleculeView &m_view;
+    const std::vector<size_t> &m_bondCodes;
+    size_t m_width;
+    std::vector<size_t> m_order;
+    const std::vector<size_t> &m_bonds;
+    std::vector<size_t> m_bestRanks;
+    std::vector<size_t> m_bestPath;
+    std::vector<boost::uint64_t> m_bestCertificate;
+    std::vector<boost::uint64_t> m_certificate;
+    std::vector<std::vector<size_t> > m_automorphisms;
+};
+
+CanonicalSearch::CanonicalSearch(const MoleculeView &view,
+                                 const std::vector<size_t> &bondCodes,
+                                 size_t width,
+                                 const std::vector<size_t> &atoms,
+                                 const std::vector<size_t> &bonds)
+    : m_view(view),
+      m_bondCodes(bondCodes),
+      m_width(width),
+      m_order(atoms),
+      m_bonds(bonds)
+{
+}
+
+// Replaces the ranks of the atoms in the fragment with their
+// canonical ranks.
+void CanonicalSearch::search(std::vector<size_t> &ranks, size_t count)
+{
+    std::vector<size_t> path;
+    search(ranks, count, path);
+
+    ranks = m_bestRanks;
+}
+
+// Searches each way of breaking the ties in ranks. Returns the depth
+// in the search to continue from, which is less than the depth of this
+// node when the rest of its children do not need to be searched.
+size_t CanonicalSearch::search(const std::vector<size_t> &ranks, size_t count, std::vector<size_t> &path)
+{
+    size_t depth = path.size();
+    size_t size = m_order.size();
+
+    std::vector<size_t> nodeRanks = ranks;
+    count = splitTerminalAtoms(m_view, m_bondCodes, m_width, count, m_order, nodeRanks);
+
+    if(count == size){
+        return leaf(nodeRanks, path);
+    }
+
+    // find the atoms in the first tied rank
+    std::vector<size_t> rankCounts(count, 0);
+    foreach(size_t atom, m_order){
+        rankCounts[nodeRanks[atom]]++;
+    }
+
+    size_t tiedRank = 0;
+    while(rankCounts[tiedRank] == 1){
+        tiedRank++;
+    }
+
+    std::vector<size_t> cell;
+    foreach(size_t atom, m_order){
+        if(nodeRanks[atom] == tiedRank){
+            cell.push_back(atom);
+        }
+    }
+
+    std::sort(cell.begin(), cell.end());
+
+    std::vector<size_t> searched;
+    std::vector<size_t> childRanks;
+
+    foreach(size_t atom, cell){
+        // skip atoms that are mapped to an atom that has already been
+        // searched by an automorphism which fixes the atoms in the path
+        std::vector<size_t> parents(m_view.size());
+        for(size_t i = 0; i < parents.size(); i++){
+            parents[i] = i;
+        }
+
+        foreach(const std::vector<size_t> &automorphism, m_automorphisms){
+            bool fixed = true;
+            foreach(size_t pathAtom, path){
+                if(automorphism[pathAtom] != pathAtom){
+                    fixed = false;
+                    break;
+                }
+            }
+
+            if(fixed){
+                foreach(size_t i, cell){
+                    parents[orbit(parents, i)] = orbit(parents, automorphism[i]);
+                }
+            }
+        }
+
+        bool equivalent = false;
+        foreach(size_t other, searched){
+            if(orbit(parents, other) == orbit(parents, atom)){
+                equivalent = true;
+                break;
+            }
+        }
+
+        if(equivalent){
+            continue;
+        }
+
+        searched.push_back(atom);
+
+        childRanks = nodeRanks;
+        size_t childCount = individualize(m_view, m_bondCodes, m_width, count, atom, m_order, childRanks);
+
+        path.push_back(atom);
+        size_t next = search(childRanks, childCount, path);
+        path.pop_back();
+
+        if(next < depth){
+            return next;
+        }
+    }
+
+    return depth;
+}
+
+// Compares the ranks at a leaf of the search with the best ranks.
+size_t CanonicalSearch::leaf(const std::vector<size_t> &ranks, const std::vector<size_t> &path)
+{
+    rankedBonds(m_view, m_bondCodes, m_bonds, ranks, m_order.size(), m_certificate);
+
+    if(m_bestRanks.empty() || m_certificate < m_bestCertificate){
+        m_bestRanks = ranks;
+        m_bestPath = path;
+        m_bestCertificate.swap(m_certificate);
+
+        return path.size();
+    }
+    else if(m_certificate == m_bestCertificate){
+        // the atom with each rank in the best ranks maps to the atom
+        // with the same rank in these ranks
+        std::vector<size_t> atoms(m_order.size());
+        foreach(size_t i, m_order){
+            atoms[ranks[i]] = i;
+        }
+
+        std::vector<size_t> automorphism(ranks.size());
+        for(size_t i = 0; i < ranks.size(); i++){
+            automorphism[i] = i;
+        }
+        foreach(size_t i, m_order){
+            automorphism[i] = atoms[m_bestRanks[i]];
+        }
+
+        m_automorphisms.push_back(automorphism);
+
+        // the automorphism maps the part of the search containing the
+        // best ranks onto the part containing these ranks, so continue
+        // from where the two paths diverge
+        size_t depth = 0;
+        while(depth < path.size() && depth < m_bestPath.size() && path[depth] == m_bestPath[depth]){
+            depth++;
+        }
+
+        return depth;
+    }
+
+    return path.size();
+}
+
+// Returns the representative atom for the orbit containing atom.
+size_t CanonicalSearch::orbit(std::vector<size_t> &parents, size_t atom) const
+{
+    while(parents[atom] != atom){
+        parents[atom] = parents[parents[atom]];
+        atom = parents[atom];
+    }
+
+    return atom;
+}
+
+// Compares two fragments by their keys.
+class FragmentCompare
+{
+public:
+    FragmentCompare(const std::vector<std::vector<boost::uint64_t> > &keys)
+        : m_keys(keys)
+    {
+    }
+
+    bool operator()(size_t a, size_t b) const
+    {
+        return m_keys[a] < m_keys[b];
+    }
+
+private:
+    const std::vector<std::vector<boost::uint64_t> > &m_keys;
+};
+
+// Breaks the ties left in ranks after refinement. The atoms in each
+// fragment are ranked by a separate canonical search and the fragments
+// are sorted by a key describing their ranked atoms and bonds. Each
+// atom is then ranked by its rank, the position of its fragment and
+// its rank in its fragment. Fragments with equal keys are identical so
+// the order they are given does not change the ranked molecule.
+void breakTies(const MoleculeView &view,
+               const std::vector<size_t> &bondCodes,
+               size_t width,
+               std::vector<size_t> &ranks)
+{
+    const size_t NoFragment = size_t(-1);
+    size_t size = view.size();
+
+    // find the atoms in each fragment
+    std::vector<size_t> fragments(size, NoFragment);
+    std::vector<std::vector<size_t> > fragmentAtoms;
+
+    for(size_t i = 0; i < size; i++){
+        if(fragments[i] != NoFragment){
+            continue;
+        }
+
+        size_t fragment = fragmentAtoms.size();
+        fragmentAtoms.push_back(std::vector<size_t>(1, i));
+        fragments[i] = fragment;
+
+        std::vector<size_t> &atoms = fragmentAtoms.back();
+        for(size_t j = 0; j < atoms.size(); j++){
+            foreach(size_t neighbor, view.neighbors(atoms[j])){
+                if(fragments[neighbor] == NoFragment){
+                    fragments[neighbor] = fragment;
+                    atoms.push_back(neighbor);
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t> > fragmentBonds(fragmentAtoms.size());
+    for(size_t i = 0; i < view.bondCount(); i++){
+        fragmentBonds[fragments[view.bondAtom1(i)]].push_back(i);
+    }
+
+    // rank the atoms in each fragment, the key for each fragment is
+    // its size followed by the rank of each of its atoms in fragment
+    // order and its ranked bonds
+    std::vector<size_t> fragmentRanks(size);
+    std::vector<std::vector<boost::uint64_t> > keys(fragmentAtoms.size());
+    std::vector<boost::uint64_t> certificate;
+
+    for(size_t fragment = 0; fragment < fragmentAtoms.size(); fragment++){
+        const std::vector<size_t> &atoms = fragmentAtoms[fragment];
+
+        std::vector<size_t> order = atoms;
+        size_t count = rankInvariants(ranks, 1, order, fragmentRanks);
+
+        if(count < atoms.size()){
+            CanonicalSearch search(view, bondCodes, width, atoms, fragmentBonds[fragment]);
+            search.search(fragmentRanks, count);
+        }
+
+        std::vector<boost::uint64_t> &key = keys[fragment];
+        key.resize(1 + atoms.size());
+        key[0] = atoms.size();
+
+        foreach(size_t atom, atoms){
+            key[1 + fragmentRanks[atom]] = ranks[atom];
+        }
+
+        rankedBonds(view, bondCodes, fragmentBonds[fragment], fragmentRanks, atoms.size(), certificate);
+        key.insert(key.end(), certificate.begin(), certificate.end());
+    }
+
+    // sort the fragments by their keys
+    std::vector<size_t> fragmentOrder(fragmentAtoms.size());
+    for(size_t i = 0; i < fragmentOrder.size(); i++){
+        fragmentOrder[i] = i;
+    }
+
+    std::stable_sort(fragmentOrder.begin(), fragmentOrder.end(), FragmentCompare(keys));
+
+    std::vector<size_t> fragmentPositions(fragmentOrder.size());
+    for(size_t i = 0; i < fragmentOrder.size(); i++){
+        fragmentPositions[fragmentOrder[i]] = i;
+    }
+
+    // rank the atoms
+    std::vector<size_t> invariants(3 * size);
+    std::vector<size_t> order(size);
+
+    for(size_t i = 0; i < size; i++){
+        invariants[3 * i] = ranks[i];
+        invariants[3 * i + 1] = fragmentPositions[fragments[i]];
+        invariants[3 * i + 2] = fragmentRanks[i];
+
+        order[i] = i;
+    }
+
+    rankInvariants(invariants, 3, order, ranks);
+}
+
+} // end anonymous namespace
+
+// === CanonicalRanker ===================================================== //
+/// \class CanonicalRanker canonicalranker.h chemkit/canonicalranker.h
+/// \ingroup chemkit
+/// \brief The CanonicalRanker class calculates canonical atom ranks.
+///
+/// Each atom is given a unique rank which does not depend on the order
+/// of the atoms and bonds in the molecule. Two molecules with the same
+/// structure will have their atoms ranked in the same way, which makes
+/// the ranks useful for writing canonical line formats.
+///
+/// The ranks are calculated by iterative refinement of atom invariants
+/// (the number of heavy neighbors, the atomic and mass numbers, the
+/// formal charge, the number of hydrogens and aromaticity) with the
+/// ranks and bond types of each atom's neighbors. The ranks before any
+/// ties are broken are available as symmetry classes.
+///
+/// When the refinement stops splitting atoms, the remaining ties are
+/// broken separately in each fragment. Each atom in the lowest tied
+/// rank is given a lower rank in turn and the refinement is repeated
+/// until every atom has a unique rank. Of all the ranks found this way,
+/// the ones giving the lexicographically smallest list of ranked bonds
+/// are used. Automorphisms found during the search are used to skip
+/// equivalent choices, and tied terminal atoms bonded to the same atom
+/// (such as the hydrogens in a methyl group) are ordered directly since
+/// swapping them does not change the molecule. Tied atoms in different
+/// fragments are ordered by comparing their ranked fragments.
+///
+/// For example, to list the atoms in a molecule in canonical order:
+/// \code
+/// CanonicalRanker ranker(molecule);
+///
+/// foreach(size_t index, ranker.order()){
+///     std::cout << molecule->atom(index)->symbol() << std::endl;
+/// }
+/// \endcode
+///
+/// \see LineFormat
+
+/// \enum CanonicalRanker::Flag
+/// Flags for the ranking:
+///     - \c DefaultFlags
+///     - \c IncludeStereochemistry
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new canonical ranker for \p molecule and calculates the
+/// ranks for each of its atoms.
+///
+/// If \p flags contains \c IncludeStereochemistry the chirality of
+/// each atom and the stereochemistry of each bond are used to
+/// distinguish atoms. Because the stored stereochemistry depends on
+/// the order of each atom's neighbors, it is compared as a parity
+/// relative to the symmetry classes of the neighbors. Stereochemistry
+/// on an atom with two neighbors in the same symmetry class is
+/// ignored.
+CanonicalRanker::CanonicalRanker(const Molecule *molecule, int flags)
+    : m_molecule(molecule),
+      m_symmetryClassCount(0)
+{
+    MoleculeView view(molecule);
+    size_t size = view.size();
+
+    m_ranks.resize(size);
+    if(size == 0){
+        return;
+    }
+
+    // bond codes
+    std::vector<size_t> bondCodes(view.bondCount());
+    for(size_t i = 0; i < view.bondCount(); i++){
+        const Bond *bond = molecule->bond(i);
+
+        bondCodes[i] = bond->isAromatic() ? size_t(AromaticBondCode) : size_t(bond->order());
+    }
+
+    // initial atom invariants
+    const size_t invariantCount = 6;
+    std::vector<size_t> invariants(size * invariantCount);
+    size_t maximumNeighborCount = 0;
+
+    for(size_t i = 0; i < size; i++){
+        const Atom *atom = molecule->atom(i);
+        size_t *row = &invariants[i * invariantCount];
+
+        size_t hydrogenCount = 0;
+        foreach(size_t neighbor, view.neighbors(i)){
+            if(view.is(neighbor, Atom::Hydrogen)){
+                hydrogenCount++;
+            }
+        }
+
+        row[0] = view.neighborCount(i) - hydrogenCount;
+        row[1] = view.atomicNumber(i);
+        row[2] = atom->massNumber();
+        row[3] = atom->formalCharge() + 128; // keep negative charges ordered
+        row[4] = hydrogenCount;
+        row[5] = atom->isAromatic();
+
+        maximumNeighborCount = std::max(maximumNeighborCount, view.neighborCount(i));
+    }
+
+    std::vector<size_t> order(size);
+    for(size_t i = 0; i < size; i++){
+        order[i] = i;
+    }
+
+    size_t count = rankInvariants(invariants, invariantCount, order, m_ranks);
+
+    // refine ranks
+    size_t width = 1 + maximumNeighborCount;
+    count = refineRanks(view, bondCodes, width, count, order, m_ranks);
+
+    // the stored stereochemistry depends on the order of the atoms so
+    // it is added as a parity relative to the ranks of the neighbors
+    // and the ranks are refined again until no more atoms are split
+    if(flags & IncludeStereochemistry){
+        std::vector<size_t> typeCodes = bondCodes;
+        std::vector<size_t> stereoInvariants(2 * size);
+
+        for(;;){
+            for(size_t i = 0; i < size; i++){
+                stereoInvariants[2 * i] = m_ranks[i];
+                stereoInvariants[2 * i + 1] = algorithm::atomParity(molecule->atom(i), m_ranks);
+            }
+
+            for(size_t i = 0; i < view.bondCount(); i++){
+                int parity = algorithm::bondParity(molecule->bond(i), m_ranks);
+
+                bondCodes[i] = typeCodes[i] + BondTypeCount * parity;
+            }
+
+            size_t stereoCount = rankInvariants(stereoInvariants, 2, order, m_ranks);
+            stereoCount = refineRanks(view, bondCodes, width, stereoCount, order, m_ranks);
+            if(stereoCount == count){
+                break;
+            }
+
+            count = stereoCount;
+        }
+    }
+
+    m_symmetryClasses = m_ranks;
+    m_symmetryClassCount = count;
+
+    // search for the canonical ranks if any atoms are still tied
+    if(count < size){
+        breakTies(view, bondCodes, width, m_ranks);
+    }
+}
+
+/// Destroys the canonical ranker.
+CanonicalRanker::~CanonicalRanker()
+{
+}
+
+// --- Ranks --------------------------------------------------------------- //
+/// Returns the canonical rank of \p atom.
+size_t CanonicalRanker::rank(const Atom *atom) const
+{
+    return m_ranks[atom->index()];
+}
+
+/// Returns the indices of the atoms sorted by their canonical rank.
+std::vector<size_t> CanonicalRanker::order() const
+{
+    std::vector<size_t> order(m_ranks.size());
+
+    for(size_t i = 0; i < m_ranks.size(); i++){
+        order[m_ranks[i]] = i;
+    }
+
+    return order;
+}
+
+} // end chemkit namespace
@@ -90,6 +90,15 @@
     #define CHEMKIT_OVERRIDE
 #endif
 
+// Define a macro for aligning a variable to a byte boundary.
+#if defined(_MSC_VER)
+    #define CHEMKIT_ALIGN(alignment) __declspec(align(alignment))
+#elif defined(__GNUC__) || defined(__clang__)
+    #define CHEMKIT_ALIGN(alignment) __attribute__((aligned(alignment)))
+#else
+    #define CHEMKIT_ALIGN(alignment)
+#endif
+
 namespace chemkit {
 
 /// Typedef for a real number.
@@ -38,6 +38,8 @@
 
 #include "chemkit.h"
 
+#include <algorithm>
+
 #ifndef Q_MOC_RUN
 #include <boost/thread.hpp>
 #endif
@@ -45,6 +47,107 @@
 namespace chemkit {
 namespace concurrent {
 
+namespace detail {
+
+// The ForEachWorker class is run in each thread started by forEach().
+// Workers take blocks of indices from a shared counter until every
+// index has been processed so that threads which finish their blocks
+// early continue with the remaining work.
+template<typename Function>
+class ForEachWorker
+{
+public:
+    ForEachWorker(const Function &function, size_t size, size_t blockSize, size_t &next, boost::mutex &mutex)
+        : m_function(function),
+          m_size(size),
+          m_blockSize(blockSize),
+          m_next(next),
+          m_mutex(mutex)
+    {
+    }
+
+    void operator()()
+    {
+        for(;;){
+            size_t begin;
+
+            {
+                boost::lock_guard<boost::mutex> lock(m_mutex);
+                begin = m_next;
+                m_next = (std::min)(m_next + m_blockSize, m_size);
+            }
+
+            if(begin >= m_size){
+                return;
+            }
+
+            size_t end = (std::min)(begin + m_blockSize, m_size);
+
+            for(size_t i = begin; i < end; i++){
+                m_function(i);
+            }
+        }
+    }
+
+private:
+    const Function &m_function;
+    size_t m_size;
+    size_t m_blockSize;
+    size_t &m_next;
+    boost::mutex &m_mutex;
+};
+
+} // end detail namespace
+
+/// Returns the number of threads that can run concurrently on the
+/// machine. Returns \c 1 if the number is not known.
+///
+/// \internal
+inline size_t threadCount()
+{
+    size_t count = boost::thread::hardware_concurrency();
+
+    return count ? count : 1;
+}
+
+/// Calls \p function with each index from \c 0 to \p size - 1
+/// using \p threadCount threads and returns once every call has
+/// finished. If \p threadCount is \c 0 the value of threadCount()
+/// is used. The order of the calls is not defined so \p function
+/// must be safe to call concurrently with different indices.
+///
+/// \internal
+template<typename Function>
+inline void forEach(size_t size, const Function &function, size_t threadCount = 0)
+{
+    if(threadCount == 0){
+        threadCount = concurrent::threadCount();
+    }
+
+    threadCount = (std::min)(threadCount, size);
+
+    if(threadCount <= 1){
+        for(size_t i = 0; i < size; i++){
+            function(i);
+        }
+
+        return;
+    }
+
+    // hand out several blocks per thread to balance uneven work
+    size_t blockSize = (std::max)(size / (threadCount * 16), size_t(1));
+
+    size_t next = 0;
+    boost::mutex mutex;
+    boost::thread_group threads;
+
+    for(size_t i = 0; i < threadCount; i++){
+        threads.create_thread(detail::ForEachWorker<Function>(function, size, blockSize, next, mutex));
+    }
+
+    threads.join_all();
+}
+
 /// Runs \p function asynchronously in a separate thread. Returns a
 /// future containing the value returned from \p function.
 ///
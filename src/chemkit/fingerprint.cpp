@@ -35,11 +35,59 @@
 
 #include "fingerprint.h"
 
+#include <algorithm>
+
 #include "molecule.h"
+#include "concurrent.h"
 #include "pluginmanager.h"
+#include "packedfingerprint.h"
 
 namespace chemkit {
 
+namespace {
+
+// number of molecules passed to writeValues() at a time by the
+// concurrent values(). each block is calculated by a single thread
+// so plugins can reuse their scratch buffers across the block.
+const size_t ValuesBlockSize = 64;
+
+} // end anonymous namespace
+
+// === FingerprintValuesTask =============================================== //
+// Calculates the fingerprint values for one block of molecules. Used
+// by the concurrent Fingerprint::values().
+class FingerprintValuesTask
+{
+public:
+    FingerprintValuesTask(const Fingerprint &fingerprint,
+                          const Molecule *const *molecules,
+                          size_t count,
+                          size_t wordCount,
+                          boost::uint64_t *output)
+        : m_fingerprint(fingerprint),
+          m_molecules(molecules),
+          m_count(count),
+          m_wordCount(wordCount),
+          m_output(output)
+    {
+    }
+
+    void operator()(size_t block) const
+    {
+        size_t begin = block * ValuesBlockSize;
+        size_t count = (std::min)(ValuesBlockSize, m_count - begin);
+
+        m_fingerprint.writeValues(m_molecules + begin, count, m_wordCount, m_output + begin * m_wordCount);
+    }
+
+private:
+    const Fingerprint &m_fingerprint;
+    const Molecule *const *m_molecules;
+    size_t m_count;
+    size_t m_wordCount;
+    boost::uint64_t *m_output;
+};
+
 // === Fingerprint ========================================================= //
 /// \class Fingerprint fingerprint.h chemkit/fingerprint.h
 /// \ingroup chemkit
@@ -106,6 +154,34 @@ size_t Fingerprint::size() const
     return value(&molecule).size();
 }
 
+// --- Options ------------------------------------------------------------- //
+/// Sets an option for the fingerprint.
+void Fingerprint::setOption(const std::string &name, const Variant &value)
+{
+    m_options[name] = value;
+}
+
+/// Returns the value of an option for the fingerprint.
+Variant Fingerprint::option(const std::string &name) const
+{
+    VariantMap::const_iterator location = m_options.find(name);
+    if(location != m_options.end()){
+        return location->second;
+    }
+    else{
+        return defaultOption(name);
+    }
+}
+
+/// Returns the default value for the option with \p name. The
+/// default implementation returns a null variant.
+Variant Fingerprint::defaultOption(const std::string &name) const
+{
+    CHEMKIT_UNUSED(name);
+
+    return Variant();
+}
+
 // --- Fingerprint --------------------------------------------------------- //
 /// Returns the fingerprint value as a bitset.
 Bitset Fingerprint::value(const Molecule *molecule) const
@@ -115,10 +191,126 @@ Bitset Fingerprint::value(const Molecule *molecule) const
     return Bitset();
 }
 
+/// Calculates the fingerprint value for each molecule in
+/// \p molecules and stores them in \p output.
+///
+/// The values are stored one after another in a single block. Each
+/// value takes <tt>(size() + 63) / 64</tt> words and bit \c i of the
+/// value is stored in word \c i / 64 at position \c i % 64 as in
+/// PackedFingerprint. The block can be passed directly to
+/// FingerprintIndex::add().
+void Fingerprint::values(const std::vector<Molecule *> &molecules, std::vector<boost::uint64_t> &output) const
+{
+    size_t wordCount = (size() + 63) / 64;
+
+    output.assign(molecules.size() * wordCount, 0);
+
+    if(!molecules.empty() && wordCount){
+        writeValues(&molecules[0], molecules.size(), wordCount, &output[0]);
+    }
+}
+
+/// Calculates the fingerprint value for each molecule in
+/// \p molecules and stores them in \p output. The molecules are
+/// processed concurrently using \p threadCount threads, or one
+/// thread for each processor if \p threadCount is \c 0.
+///
+/// The fingerprint and the molecules must not be modified until
+/// the values have been calculated.
+void Fingerprint::values(const std::vector<Molecule *> &molecules, std::vector<boost::uint64_t> &output, size_t threadCount) const
+{
+    size_t wordCount = (size() + 63) / 64;
+
+    output.assign(molecules.size() * wordCount, 0);
+
+    if(molecules.empty() || !wordCount){
+        return;
+    }
+
+    // properties such as rings and aromaticity are perceived lazily
+    // so a molecule listed more than once is only calculated once
+    // and its value is copied to each of its other positions
+    std::vector<Molecule *> uniqueMolecules = molecules;
+    std::sort(uniqueMolecules.begin(), uniqueMolecules.end());
+    uniqueMolecules.erase(std::unique(uniqueMolecules.begin(), uniqueMolecules.end()), uniqueMolecules.end());
+
+    if(uniqueMolecules.size() == molecules.size()){
+        size_t blockCount = (molecules.size() + ValuesBlockSize - 1) / ValuesBlockSize;
+
+        concurrent::forEach(blockCount,
+                            FingerprintValuesTask(*this, &molecules[0], molecules.size(), wordCount, &output[0]),
+                            threadCount);
+    }
+    else{
+        std::vector<boost::uint64_t> uniqueOutput;
+        values(uniqueMolecules, uniqueOutput, threadCount);
+
+        for(size_t i = 0; i < molecules.size(); i++){
+            size_t index = std::lower_bound(uniqueMolecules.begin(), uniqueMolecules.end(), molecules[i]) - uniqueMolecules.begin();
+
+            std::copy(uniqueOutput.begin() + index * wordCount,
+                      uniqueOutput.begin() + (index + 1) * wordCount,
+                      output.begin() + i * wordCount);
+        }
+    }
+}
+
+/// Returns the fingerprint value as a map of feature identifiers
+/// to the number of times each feature occurs in \p molecule.
+///
+/// Fingerprints that hash features into a fixed number of bits
+/// can override this to return the unfolded feature counts. The
+/// default implementation returns a count of one for each bit set
+/// in value().
+std::map<size_t, size_t> Fingerprint::counts(const Molecule *molecule) const
+{
+    std::map<size_t, size_t> counts;
+
+    Bitset bits = value(molecule);
+    for(size_t i = bits.find_first(); i != Bitset::npos; i = bits.find_next(i)){
+        counts[i] = 1;
+    }
+
+    return counts;
+}
+
+/// Writes the fingerprint value for each of the \p count molecules
+/// starting at \p molecules to \p output. Each value is written to
+/// \p wordCount words which are zero when this is called.
+///
+/// This is called by values() with blocks of molecules that are
+/// each processed by a single thread. Fingerprints can override it
+/// to reuse their scratch buffers across a block. The default
+/// implementation calls value() for each molecule.
+void Fingerprint::writeValues(const Molecule *const *molecules, size_t count, size_t wordCount, boost::uint64_t *output) const
+{
+    for(size_t i = 0; i < count; i++){
+        Bitset value = this->value(molecules[i]);
+
+        boost::uint64_t *words = output + i * wordCount;
+
+        for(size_t bit = value.find_first(); bit < wordCount * 64 && bit != Bitset::npos; bit = value.find_next(bit)){
+            words[bit / 64] |= boost::uint64_t(1) << (bit % 64);
+        }
+    }
+}
+
 // --- Similarity ---------------------------------------------------------- //
 /// Returns the tanimoto coefficent between \p a and \p b.
+///
+/// Fingerprints with up to 2048 bits are compared as packed
+/// fingerprints without allocating any temporary bitsets.
+///
+/// \see PackedFingerprint::tanimotoCoefficient()
 Real Fingerprint::tanimotoCoefficient(const Bitset &a, const Bitset &b)
 {
+    if(a.size() <= PackedFingerprint1024::BitCount && b.size() <= PackedFingerprint1024::BitCount){
+        return PackedFingerprint1024(a).tanimotoCoefficient(PackedFingerprint1024(b));
+    }
+    else if(a.size() <= PackedFingerprint2048::BitCount && b.size() <= PackedFingerprint2048::BitCount){
+        return PackedFingerprint2048(a).tanimotoCoefficient(PackedFingerprint2048(b));
+    }
+
     size_t intersection = (a & b).count();
 
     return Real(intersection) / Real(a.count() + b.count() - intersection);
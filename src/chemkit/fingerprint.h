@@ -38,11 +38,17 @@
 
 #include "chemkit.h"
 
+#include <map>
 #include <string>
 #include <vector>
 
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
 #include "bitset.h"
 #include "plugin.h"
+#include "variantmap.h"
 
 namespace chemkit {
 
@@ -58,8 +64,15 @@ public:
     std::string name() const;
     virtual size_t size() const;
 
+    // options
+    void setOption(const std::string &name, const Variant &value);
+    Variant option(const std::string &name) const;
+
     // fingerprint
     virtual Bitset value(const Molecule *molecule) const;
+    void values(const std::vector<Molecule *> &molecules, std::vector<boost::uint64_t> &output) const;
+    void values(const std::vector<Molecule *> &molecules, std::vector<boost::uint64_t> &output, size_t threadCount) const;
+    virtual std::map<size_t, size_t> counts(const Molecule *molecule) const;
 
     // similarity
     static Real tanimotoCoefficient(const Bitset &a, const Bitset &b);
@@ -70,9 +83,14 @@ public:
 
 protected:
     Fingerprint(const std::string &name);
+    virtual Variant defaultOption(const std::string &name) const;
+    virtual void writeValues(const Molecule *const *molecules, size_t count, size_t wordCount, boost::uint64_t *output) const;
 
 private:
+    friend class FingerprintValuesTask;
+
     std::string m_name;
+    VariantMap m_options;
 };
 
 } // end chemkit namespace
@@ -0,0 +1,720 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fingerprintindex.h"
+
+#include <cmath>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "foreach.h"
+#include "concurrent.h"
+#include "fingerprintindexformat.h"
+
+namespace chemkit {
+
+namespace {
+
+typedef boost::uint64_t Word;
+
+// number of fingerprints scored by each task in a concurrent search
+const size_t ChunkSize = 4096;
+
+// Returns the highest similarity possible between a query with
+// queryCount bits set and a fingerprint with count bits set.
+inline Real similarityBound(size_t queryCount, size_t count)
+{
+    if(queryCount == 0 && count == 0){
+        return 0;
+    }
+
+    return Real((std::min)(queryCount, count)) / Real((std::max)(queryCount, count));
+}
+
+// Returns true if match a is more similar than match b. Matches with
+// the same similarity are ordered by their index.
+inline bool moreSimilar(const FingerprintIndex::Match &a, const FingerprintIndex::Match &b)
+{
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+
+// Sets the first size bits from bitset in the words starting at words.
+void setWords(const Bitset &bitset, size_t size, Word *words)
+{
+    std::fill(words, words + (size + 63) / 64, Word(0));
+
+    for(size_t i = bitset.find_first(); i < size && i != Bitset::npos; i = bitset.find_next(i)){
+        words[i / 64] |= Word(1) << (i % 64);
+    }
+}
+
+// A range of fingerprints in the index scored by a single task.
+struct Chunk
+{
+    size_t begin;
+    size_t end;
+    Real bound;
+};
+
+bool greaterBound(const Chunk &a, const Chunk &b)
+{
+    return a.bound > b.bound;
+}
+
+} // end anonymous namespace
+
+// === FingerprintIndexPrivate ============================================= //
+class FingerprintIndexPrivate
+{
+public:
+    void sort();
+    void setOwned();
+    size_t bucket(size_t position) const;
+    std::vector<Chunk> chunks(const Word *query, Real threshold) const;
+
+    size_t size;
+    size_t wordCount;
+
+    // fingerprints sorted by the number of bits set. the fingerprints
+    // in bucket i (which have i bits set) are at the positions from
+    // offsets[i] to offsets[i+1].
+    size_t sortedCount;
+    const Word *words;
+    const Word *offsets;
+    const Word *indices;
+
+    // storage for sorted fingerprints when the index is not mapped
+    std::vector<Word> wordData;
+    std::vector<Word> offsetData;
+    std::vector<Word> indexData;
+
+    // fingerprints added since the index was last sorted
+    std::vector<Word> pendingWords;
+
+    boost::iostreams::mapped_file_source file;
+    boost::mutex mutex;
+    std::string errorString;
+};
+
+// Points the sorted fingerprint pointers at the owned storage.
+void FingerprintIndexPrivate::setOwned()
+{
+    words = wordData.empty() ? 0 : &wordData[0];
+    offsets = &offsetData[0];
+    indices = indexData.empty() ? 0 : &indexData[0];
+
+    if(file.is_open()){
+        file.close();
+    }
+}
+
+// Moves the pending fingerprints into their popcount buckets. The
+// fingerprints in each bucket remain ordered by their index. This is
+// called before each search so that concurrent searches on the same
+// index only sort it once.
+void FingerprintIndexPrivate::sort()
+{
+    boost::lock_guard<boost::mutex> lock(mutex);
+
+    if(pendingWords.empty()){
+        return;
+    }
+
+    size_t pendingCount = pendingWords.size() / wordCount;
+    size_t totalCount = sortedCount + pendingCount;
+
+    std::vector<size_t> pendingBuckets(pendingCount);
+    std::vector<Word> newOffsets(size + 2, 0);
+
+    for(size_t i = 0; i <= size; i++){
+        newOffsets[i + 1] = offsets[i + 1] - offsets[i];
+    }
+
+    for(size_t i = 0; i < pendingCount; i++){
+        pendingBuckets[i] = detail::packedPopcount(&pendingWords[i * wordCount], wordCount);
+        newOffsets[pendingBuckets[i] + 1]++;
+    }
+
+    for(size_t i = 0; i <= size; i++){
+        newOffsets[i + 1] += newOffsets[i];
+    }
+
+    std::vector<Word> newWords(totalCount * wordCount);
+    std::vector<Word> newIndices(totalCount);
+    std::vector<Word> positions(newOffsets.begin(), newOffsets.end() - 1);
+
+    for(size_t i = 0; i <= size; i++){
+        size_t begin = offsets[i];
+        size_t end = offsets[i + 1];
+
+        std::copy(words + begin * wordCount, words + end * wordCount, &newWords[0] + positions[i] * wordCount);
+        std::copy(indices + begin, indices + end, &newIndices[0] + positions[i]);
+        positions[i] += end - begin;
+    }
+
+    for(size_t i = 0; i < pendingCount; i++){
+        size_t position = positions[pendingBuckets[i]]++;
+
+        std::copy(&pendingWords[i * wordCount], &pendingWords[i * wordCount] + wordCount, &newWords[0] + position * wordCount);
+        newIndices[position] = sortedCount + i;
+    }
+
+    wordData.swap(newWords);
+    offsetData.swap(newOffsets);
+    indexData.swap(newIndices);
+    std::vector<Word>().swap(pendingWords);
+    sortedCount = totalCount;
+    setOwned();
+}
+
+// Returns the bucket containing the fingerprint at position.
+size_t FingerprintIndexPrivate::bucket(size_t position) const
+{
+    return std::upper_bound(offsets, offsets + size + 2, Word(position)) - offsets - 1;
+}
+
+// Returns the ranges of fingerprints to score for query. Only the
+// buckets whose similarity bound is at least threshold are included.
+// The chunks are ordered from the highest to lowest bound.
+std::vector<Chunk> FingerprintIndexPrivate::chunks(const Word *query, Real threshold) const
+{
+    std::vector<Chunk> chunks;
+
+    size_t queryCount = detail::packedPopcount(query, wordCount);
+
+    // the bound decreases on either side of the query's bucket so the
+    // buckets above the threshold form a single range of positions
+    size_t first = size + 1;
+    size_t last = 0;
+    for(size_t i = 0; i <= size; i++){
+        if(similarityBound(queryCount, i) >= threshold){
+            first = (std::min)(first, i);
+            last = i;
+        }
+    }
+
+    if(first > last){
+        return chunks;
+    }
+
+    size_t begin = offsets[first];
+    size_t end = offsets[last + 1];
+
+    for(size_t position = begin; position < end; position += ChunkSize){
+        Chunk chunk;
+        chunk.begin = position;
+        chunk.end = (std::min)(position + ChunkSize, end);
+
+        size_t firstBucket = bucket(chunk.begin);
+        size_t lastBucket = bucket(chunk.end - 1);
+        size_t closestBucket = (std::max)(firstBucket, (std::min)(queryCount, lastBucket));
+        chunk.bound = similarityBound(queryCount, closestBucket);
+
+        chunks.push_back(chunk);
+    }
+
+    std::stable_sort(chunks.begin(), chunks.end(), greaterBound);
+
+    return chunks;
+}
+
+namespace {
+
+// Finds the fingerprints in a chunk with a similarity of at least the
+// threshold. Used by FingerprintIndex::similar().
+class SimilarTask
+{
+public:
+    SimilarTask(const FingerprintIndexPrivate *index,
+                const Word *query,
+                Real threshold,
+                const std::vector<Chunk> &chunks,
+                std::vector<std::vector<FingerprintIndex::Match> > &matches)
+        : m_index(index),
+          m_query(query),
+          m_threshold(threshold),
+          m_chunks(chunks),
+          m_matches(matches)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        const Chunk &chunk = m_chunks[index];
+        size_t wordCount = m_index->wordCount;
+
+        std::vector<Real> similarities(chunk.end - chunk.begin);
+        detail::packedTanimotoCoefficients(m_query,
+                                           m_index->words + chunk.begin * wordCount,
+                                           wordCount,
+                                           similarities.size(),
+                                           &similarities[0]);
+
+        for(size_t i = 0; i < similarities.size(); i++){
+            if(similarities[i] >= m_threshold){
+                m_matches[index].push_back(std::make_pair(size_t(m_index->indices[chunk.begin + i]), similarities[i]));
+            }
+        }
+    }
+
+private:
+    const FingerprintIndexPrivate *m_index;
+    const Word *m_query;
+    Real m_threshold;
+    const std::vector<Chunk> &m_chunks;
+    std::vector<std::vector<FingerprintIndex::Match> > &m_matches;
+};
+
+// Finds the k most similar fingerprints in a chunk. The lowest
+// similarity among the k best matches found so far by any chunk is
+// shared so that buckets which cannot improve on it are skipped.
+// Used by FingerprintIndex::nearest().
+class NearestTask
+{
+public:
+    NearestTask(const FingerprintIndexPrivate *index,
+                const Word *query,
+                size_t k,
+                Real threshold,
+                const std::vector<Chunk> &chunks,
+                std::vector<std::vector<FingerprintIndex::Match> > &matches,
+                Real &sharedThreshold,
+                boost::mutex &mutex)
+        : m_index(index),
+          m_query(query),
+          m_queryCount(detail::packedPopcount(query, index->wordCount)),
+          m_k(k),
+          m_threshold(threshold),
+          m_chunks(chunks),
+          m_matches(matches),
+          m_sharedThreshold(sharedThreshold),
+          m_mutex(mutex)
+    {
+    }
+
+    void operator()(size_t index) const
+    {
+        const Chunk &chunk = m_chunks[index];
+        size_t wordCount = m_index->wordCount;
+        std::vector<FingerprintIndex::Match> &heap = m_matches[index];
+
+        Real threshold = (std::max)(m_threshold, sharedThreshold());
+        if(chunk.bound < threshold){
+            return;
+        }
+
+        std::vector<Real> similarities;
+
+        size_t position = chunk.begin;
+        while(position < chunk.end){
+            size_t bucket = m_index->bucket(position);
+            size_t end = (std::min)(size_t(m_index->offsets[bucket + 1]), chunk.end);
+
+            if(heap.size() == m_k){
+                threshold = (std::max)(threshold, heap.front().second);
+            }
+
+            if(similarityBound(m_queryCount, bucket) >= threshold){
+                similarities.resize(end - position);
+                detail::packedTanimotoCoefficients(m_query,
+                                                   m_index->words + position * wordCount,
+                                                   wordCount,
+                                                   similarities.size(),
+                                                   &similarities[0]);
+
+                for(size_t i = 0; i < similarities.size(); i++){
+                    if(similarities[i] < threshold){
+                        continue;
+                    }
+
+                    FingerprintIndex::Match match(size_t(m_index->indices[position + i]), similarities[i]);
+
+                    if(heap.size() < m_k){
+                        heap.push_back(match);
+                        std::push_heap(heap.begin(), heap.end(), moreSimilar);
+                    }
+                    else if(moreSimilar(match, heap.front())){
+                        std::pop_heap(heap.begin(), heap.end(), moreSimilar);
+                        heap.back() = match;
+                        std::push_heap(heap.begin(), heap.end(), moreSimilar);
+                    }
+                }
+            }
+
+            position = end;
+        }
+
+        if(heap.size() == m_k){
+            boost::lock_guard<boost::mutex> lock(m_mutex);
+            m_sharedThreshold = (std::max)(m_sharedThreshold, heap.front().second);
+        }
+    }
+
+private:
+    Real sharedThreshold() const
+    {
+        boost::lock_guard<boost::mutex> lock(m_mutex);
+        return m_sharedThreshold;
+    }
+
+private:
+    const FingerprintIndexPrivate *m_index;
+    const Word *m_query;
+    size_t m_queryCount;
+    size_t m_k;
+    Real m_threshold;
+    const std::vector<Chunk> &m_chunks;
+    std::vector<std::vector<FingerprintIndex::Match> > &m_matches;
+    Real &m_sharedThreshold;
+    boost::mutex &m_mutex;
+};
+
+} // end anonymous namespace
+
+// === FingerprintIndex ==================================================== //
+/// \class FingerprintIndex fingerprintindex.h chemkit/fingerprintindex.h
+/// \ingroup chemkit
+/// \brief The FingerprintIndex class provides fast similarity
+///        searches over a set of fingerprints.
+///
+/// The fingerprints in the index are stored contiguously and grouped
+/// into buckets by the number of bits they have set. The tanimoto
+/// coefficient between fingerprints with \c a and \c b bits set can
+/// be no higher than min(a, b) / max(a, b) so whole buckets which
+/// cannot contain a match are skipped without being scored.
+///
+/// Each fingerprint is identified by the index it was given when it
+/// was added. Searches return (index, similarity) pairs ordered from
+/// the most to the least similar.
+///
+/// The following example shows how to find the ten molecules most
+/// similar to a query molecule:
+/// \code
+/// FingerprintIndex index(1024);
+/// foreach(const Molecule *molecule, molecules){
+///     index.add(molecule->fingerprint("fp2"));
+/// }
+///
+/// std::vector<FingerprintIndex::Match> matches =
+///     index.nearest(query->fingerprint("fp2"), 10);
+/// \endcode
+///
+/// An index can be saved to a file with write(). Calling read() maps
+/// the file into memory and searches it in place without copying the
+/// fingerprints so even large indices are ready to search at once.
+///
+/// \see Fingerprint, PackedFingerprint
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty fingerprint index for fingerprints with
+/// \p size bits.
+FingerprintIndex::FingerprintIndex(size_t size)
+    : d(new FingerprintIndexPrivate)
+{
+    d->size = size;
+    d->wordCount = (size + 63) / 64;
+    d->sortedCount = 0;
+    d->offsetData.resize(size + 2, 0);
+    d->setOwned();
+}
+
+/// Destroys the fingerprint index.
+FingerprintIndex::~FingerprintIndex()
+{
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of bits in each fingerprint.
+size_t FingerprintIndex::size() const
+{
+    return d->size;
+}
+
+/// Returns the number of fingerprints in the index.
+size_t FingerprintIndex::count() const
+{
+    return d->sortedCount + d->pendingWords.size() / d->wordCount;
+}
+
+/// Returns \c true if the index contains no fingerprints.
+bool FingerprintIndex::isEmpty() const
+{
+    return count() == 0;
+}
+
+/// Returns \c true if the index is searching a file mapped into
+/// memory with read().
+bool FingerprintIndex::isMapped() const
+{
+    return d->file.is_open();
+}
+
+// --- Fingerprints -------------------------------------------------------- //
+/// Adds \p fingerprint to the index and returns its index. Bits past
+/// the size of the index are ignored.
+size_t FingerprintIndex::add(const Bitset &fingerprint)
+{
+    size_t index = count();
+
+    d->pendingWords.resize(d->pendingWords.size() + d->wordCount);
+    setWords(fingerprint, d->size, &d->pendingWords[d->pendingWords.size() - d->wordCount]);
+
+    return index;
+}
+
+/// Adds the fingerprint contained in the \p wordCount words starting
+/// at \p words to the index and returns its index. Bit \c i is stored
+/// in word \c i / 64 at position \c i % 64 as in PackedFingerprint.
+size_t FingerprintIndex::add(const boost::uint64_t *words, size_t wordCount)
+{
+    size_t index = count();
+
+    d->pendingWords.insert(d->pendingWords.end(), words, words + (std::min)(wordCount, d->wordCount));
+    d->pendingWords.resize(d->pendingWords.size() + d->wordCount - (std::min)(wordCount, d->wordCount), 0);
+
+    // clear bits past the size of the index
+    if(d->size % 64){
+        d->pendingWords.back() &= (Word(1) << (d->size % 64)) - 1;
+    }
+
+    return index;
+}
+
+/// Removes every fingerprint from the index.
+void FingerprintIndex::clear()
+{
+    d->sortedCount = 0;
+    d->wordData.clear();
+    d->indexData.clear();
+    d->offsetData.assign(d->size + 2, 0);
+    d->pendingWords.clear();
+    d->setOwned();
+}
+
+// --- Search -------------------------------------------------------------- //
+/// Returns the fingerprints with a tanimoto coefficient of at least
+/// \p threshold with \p query.
+std::vector<FingerprintIndex::Match> FingerprintIndex::similar(const Bitset &query, Real threshold) const
+{
+    return similar(query, threshold, 1);
+}
+
+/// Returns the fingerprints with a tanimoto coefficient of at least
+/// \p threshold with \p query. The search is run concurrently using
+/// \p threadCount threads, or one thread for each processor if
+/// \p threadCount is \c 0.
+std::vector<FingerprintIndex::Match> FingerprintIndex::similar(const Bitset &query, Real threshold, size_t threadCount) const
+{
+    d->sort();
+
+    std::vector<Word> queryWords(d->wordCount);
+    setWords(query, d->size, &queryWords[0]);
+
+    std::vector<Match> matches;
+    if(detail::packedPopcount(&queryWords[0], d->wordCount) == 0){
+        return matches;
+    }
+
+    std::vector<Chunk> chunks = d->chunks(&queryWords[0], threshold);
+    std::vector<std::vector<Match> > chunkMatches(chunks.size());
+    concurrent::forEach(chunks.size(), SimilarTask(d, &queryWords[0], threshold, chunks, chunkMatches), threadCount);
+
+    foreach(const std::vector<Match> &chunkMatch, chunkMatches){
+        matches.insert(matches.end(), chunkMatch.begin(), chunkMatch.end());
+    }
+
+    std::sort(matches.begin(), matches.end(), moreSimilar);
+
+    return matches;
+}
+
+/// Returns the \p k fingerprints most similar to \p query. Only
+/// fingerprints with a tanimoto coefficient of at least \p threshold
+/// are returned.
+std::vector<FingerprintIndex::Match> FingerprintIndex::nearest(const Bitset &query, size_t k, Real threshold) const
+{
+    return nearest(query, k, threshold, 1);
+}
+
+/// Returns the \p k fingerprints most similar to \p query. Only
+/// fingerprints with a tanimoto coefficient of at least \p threshold
+/// are returned. The search is run concurrently using \p threadCount
+/// threads, or one thread for each processor if \p threadCount is
+/// \c 0.
+std::vector<FingerprintIndex::Match> FingerprintIndex::nearest(const Bitset &query, size_t k, Real threshold, size_t threadCount) const
+{
+    d->sort();
+
+    std::vector<Word> queryWords(d->wordCount);
+    setWords(query, d->size, &queryWords[0]);
+
+    std::vector<Match> matches;
+    if(k == 0 || detail::packedPopcount(&queryWords[0], d->wordCount) == 0){
+        return matches;
+    }
+
+    std::vector<Chunk> chunks = d->chunks(&queryWords[0], threshold);
+    std::vector<std::vector<Match> > chunkMatches(chunks.size());
+    Real sharedThreshold = threshold;
+    boost::mutex mutex;
+    concurrent::forEach(chunks.size(),
+                        NearestTask(d, &queryWords[0], k, threshold, chunks, chunkMatches, sharedThreshold, mutex),
+                        threadCount);
+
+    foreach(const std::vector<Match> &chunkMatch, chunkMatches){
+        matches.insert(matches.end(), chunkMatch.begin(), chunkMatch.end());
+    }
+
+    std::sort(matches.begin(), matches.end(), moreSimilar);
+    if(matches.size() > k){
+        matches.resize(k);
+    }
+
+    return matches;
+}
+
+// --- Input and Output ---------------------------------------------------- //
+/// Maps the index file \p fileName into memory and searches it in
+/// place. Returns \c false if the file could not be read.
+///
+/// Index files are stored in the byte order of the machine that
+/// wrote them.
+bool FingerprintIndex::read(const std::string &fileName)
+{
+    boost::iostreams::mapped_file_source file;
+
+    try {
+        file.open(fileName);
+    }
+    catch(std::exception &e){
+        d->errorString = "Failed to open file '" + fileName + "': " + e.what();
+        return false;
+    }
+
+    if(file.size() < sizeof(detail::IndexHeader)){
+        d->errorString = "File is too small to be a fingerprint index.";
+        return false;
+    }
+
+    detail::IndexHeader header;
+    std::memcpy(&header, file.data(), sizeof(detail::IndexHeader));
+
+    if(!std::equal(detail::IndexMagic, detail::IndexMagic + 8, header.magic)){
+        d->errorString = "File is not a fingerprint index.";
+        return false;
+    }
+    else if(header.byteOrder != detail::IndexByteOrder){
+        d->errorString = "Fingerprint index was written with a different byte order.";
+        return false;
+    }
+    else if(header.wordCount != (header.size + 63) / 64){
+        d->errorString = "Fingerprint index header is invalid.";
+        return false;
+    }
+
+    size_t offsetsBegin = detail::indexOffsetsBegin();
+    size_t wordsBegin = detail::indexWordsBegin(header.size);
+    size_t indicesBegin = detail::indexIndicesBegin(header.size, header.wordCount, header.count);
+    size_t fileSize = detail::indexFileSize(header.size, header.wordCount, header.count);
+
+    if(file.size() < fileSize){
+        d->errorString = "Fingerprint index file is truncated.";
+        return false;
+    }
+
+    const Word *offsets = reinterpret_cast<const Word *>(file.data() + offsetsBegin);
+    if(offsets[0] != 0 || offsets[header.size + 1] != header.count){
+        d->errorString = "Fingerprint index header is invalid.";
+        return false;
+    }
+
+    clear();
+
+    d->file = file;
+    d->size = header.size;
+    d->wordCount = header.wordCount;
+    d->sortedCount = header.count;
+    d->offsets = offsets;
+    d->words = reinterpret_cast<const Word *>(file.data() + wordsBegin);
+    d->indices = reinterpret_cast<const Word *>(file.data() + indicesBegin);
+
+    return true;
+}
+
+/// Writes the index to \p fileName. Returns \c false if the file
+/// could not be written.
+bool FingerprintIndex::write(const std::string &fileName) const
+{
+    d->sort();
+
+    std::ofstream output(fileName.c_str(), std::ios_base::out | std::ios_base::binary);
+    if(!output.is_open()){
+        d->errorString = "Failed to open file '" + fileName + "' for writing.";
+        return false;
+    }
+
+    detail::IndexHeader header;
+    std::memset(&header, 0, sizeof(detail::IndexHeader));
+    std::copy(detail::IndexMagic, detail::IndexMagic + 8, header.magic);
+    header.byteOrder = detail::IndexByteOrder;
+    header.size = d->size;
+    header.wordCount = d->wordCount;
+    header.count = d->sortedCount;
+
+    detail::writeIndexSection(output, &header, sizeof(detail::IndexHeader));
+    detail::writeIndexSection(output, d->offsets, (d->size + 2) * sizeof(Word));
+    detail::writeIndexSection(output, d->words, d->sortedCount * d->wordCount * sizeof(Word));
+    detail::writeIndexSection(output, d->indices, d->sortedCount * sizeof(Word));
+
+    if(!output){
+        d->errorString = "Failed to write file '" + fileName + "'.";
+        return false;
+    }
+
+    return true;
+}
+
+/// Returns a string describing the last error that occured.
+std::string FingerprintIndex::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
@@ -0,0 +1,99 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_FINGERPRINTINDEX_H
+#define CHEMKIT_FINGERPRINTINDEX_H
+
+#include "chemkit.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+#include "bitset.h"
+#include "packedfingerprint.h"
+
+namespace chemkit {
+
+class FingerprintIndexPrivate;
+
+class CHEMKIT_EXPORT FingerprintIndex
+{
+public:
+    // typedefs
+    typedef std::pair<size_t, Real> Match;
+
+    // construction and destruction
+    FingerprintIndex(size_t size = 1024);
+    ~FingerprintIndex();
+
+    // properties
+    size_t size() const;
+    size_t count() const;
+    bool isEmpty() const;
+    bool isMapped() const;
+
+    // fingerprints
+    size_t add(const Bitset &fingerprint);
+    template<size_t N> size_t add(const PackedFingerprint<N> &fingerprint);
+    size_t add(const boost::uint64_t *words, size_t wordCount);
+    void clear();
+
+    // search
+    std::vector<Match> similar(const Bitset &query, Real threshold) const;
+    std::vector<Match> similar(const Bitset &query, Real threshold, size_t threadCount) const;
+    std::vector<Match> nearest(const Bitset &query, size_t k, Real threshold = 0) const;
+    std::vector<Match> nearest(const Bitset &query, size_t k, Real threshold, size_t threadCount) const;
+
+    // input and output
+    bool read(const std::string &fileName);
+    bool write(const std::string &fileName) const;
+    std::string errorString() const;
+
+private:
+    CHEMKIT_DISABLE_COPY(FingerprintIndex)
+
+    FingerprintIndexPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#include "fingerprintindex-inline.h"
+
+#endif // CHEMKIT_FINGERPRINTINDEX_H
@@ -0,0 +1,115 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_FINGERPRINTINDEXFORMAT_H
+#define CHEMKIT_FINGERPRINTINDEXFORMAT_H
+
+#include "chemkit.h"
+
+#include <ostream>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+namespace chemkit {
+
+namespace detail {
+
+// The IndexHeader class is stored at the start of a fingerprint index
+// file. It is followed by the bucket offsets, the fingerprint words and
+// the fingerprint indices, each starting on a 64 byte boundary.
+struct IndexHeader
+{
+    char magic[8];
+    boost::uint64_t byteOrder;
+    boost::uint64_t size;
+    boost::uint64_t wordCount;
+    boost::uint64_t count;
+    boost::uint64_t reserved[3];
+};
+
+const char IndexMagic[8] = {'C', 'K', 'F', 'P', 'I', 'D', 'X', '1'};
+const boost::uint64_t IndexByteOrder = 0x0102030405060708ULL;
+
+// Returns size rounded up to a multiple of 64 bytes.
+inline size_t paddedSize(size_t size)
+{
+    return (size + 63) & ~size_t(63);
+}
+
+// Returns the position of the offsets section in an index file.
+inline size_t indexOffsetsBegin()
+{
+    return paddedSize(sizeof(IndexHeader));
+}
+
+// Returns the position of the words section in an index file.
+inline size_t indexWordsBegin(size_t size)
+{
+    return indexOffsetsBegin() + paddedSize((size + 2) * sizeof(boost::uint64_t));
+}
+
+// Returns the position of the indices section in an index file.
+inline size_t indexIndicesBegin(size_t size, size_t wordCount, size_t count)
+{
+    return indexWordsBegin(size) + paddedSize(count * wordCount * sizeof(boost::uint64_t));
+}
+
+// Returns the total size of an index file.
+inline size_t indexFileSize(size_t size, size_t wordCount, size_t count)
+{
+    return indexIndicesBegin(size, wordCount, count) + paddedSize(count * sizeof(boost::uint64_t));
+}
+
+// Writes size bytes from data to output followed by padding up to the
+// next 64 byte boundary.
+inline void writeIndexSection(std::ostream &output, const void *data, size_t size)
+{
+    const char padding[64] = {0};
+
+    if(size){
+        output.write(static_cast<const char *>(data), size);
+    }
+
+    output.write(padding, paddedSize(size) - size);
+}
+
+} // end detail namespace
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_FINGERPRINTINDEXFORMAT_H
@@ -0,0 +1,348 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "fingerprintindexwriter.h"
+
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+
+#include "packedfingerprint.h"
+#include "fingerprintindexformat.h"
+
+namespace chemkit {
+
+namespace {
+
+typedef boost::uint64_t Word;
+
+// number of fingerprints buffered for each bucket before they are
+// written to the file
+const size_t BufferSize = 64;
+
+} // end anonymous namespace
+
+// === FingerprintIndexWriterPrivate ======================================= //
+class FingerprintIndexWriterPrivate
+{
+public:
+    size_t setWords(const Word *words, size_t wordCount);
+    bool flush(size_t bucket);
+
+    size_t size;
+    size_t wordCount;
+
+    // number of fingerprints reserved in each bucket
+    std::vector<Word> counts;
+    size_t reservedCount;
+
+    // position of the first fingerprint in each bucket and the position
+    // the next fingerprint in each bucket will be written to
+    std::vector<Word> offsets;
+    std::vector<Word> positions;
+    size_t writtenCount;
+
+    // fingerprints waiting to be written for each bucket
+    std::vector<std::vector<Word> > bufferedWords;
+    std::vector<std::vector<Word> > bufferedIndices;
+    std::vector<Word> words;
+
+    size_t wordsBegin;
+    size_t indicesBegin;
+    std::ofstream file;
+    std::string errorString;
+};
+
+// Copies the fingerprint to words and returns the number of bits set.
+// Bits past the size of the index are cleared.
+size_t FingerprintIndexWriterPrivate::setWords(const Word *words, size_t wordCount)
+{
+    std::fill(this->words.begin(), this->words.end(), Word(0));
+    std::copy(words, words + (std::min)(wordCount, this->wordCount), this->words.begin());
+
+    if(size % 64){
+        this->words.back() &= (Word(1) << (size % 64)) - 1;
+    }
+
+    return detail::packedPopcount(this->words.empty() ? 0 : &this->words[0], this->wordCount);
+}
+
+// Writes the buffered fingerprints for bucket to their positions in
+// the file. The fingerprints in a bucket are stored contiguously so
+// each flush needs only two writes.
+bool FingerprintIndexWriterPrivate::flush(size_t bucket)
+{
+    std::vector<Word> &indices = bufferedIndices[bucket];
+    if(indices.empty()){
+        return true;
+    }
+
+    std::vector<Word> &words = bufferedWords[bucket];
+    size_t position = positions[bucket];
+
+    if(!words.empty()){
+        file.seekp(wordsBegin + position * wordCount * sizeof(Word));
+        file.write(reinterpret_cast<const char *>(&words[0]), words.size() * sizeof(Word));
+    }
+
+    file.seekp(indicesBegin + position * sizeof(Word));
+    file.write(reinterpret_cast<const char *>(&indices[0]), indices.size() * sizeof(Word));
+
+    positions[bucket] += indices.size();
+    words.clear();
+    indices.clear();
+
+    return file.good();
+}
+
+// === FingerprintIndexWriter ============================================== //
+/// \class FingerprintIndexWriter fingerprintindexwriter.h chemkit/fingerprintindexwriter.h
+/// \ingroup chemkit
+/// \brief The FingerprintIndexWriter class writes fingerprint index
+///        files without holding the fingerprints in memory.
+///
+/// Writing a FingerprintIndex requires every fingerprint to be in
+/// memory and sorting them into buckets makes a second copy. The
+/// writer instead takes the fingerprints in two passes. The first
+/// pass calls reserve() for each fingerprint to count the number of
+/// fingerprints in each bucket. After open() is called the second
+/// pass calls write() with the same fingerprints in the same order
+/// and each one is written directly to its position in the file.
+/// Only a small buffer of fingerprints for each bucket is kept in
+/// memory.
+///
+/// The files written are identical to those from
+/// FingerprintIndex::write() and are read with FingerprintIndex::read().
+/// The fingerprints are given indices in the order they are written.
+///
+/// \see FingerprintIndex, FpsReader
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new fingerprint index writer for fingerprints with
+/// \p size bits.
+FingerprintIndexWriter::FingerprintIndexWriter(size_t size)
+    : d(new FingerprintIndexWriterPrivate)
+{
+    d->size = size;
+    d->wordCount = (size + 63) / 64;
+    d->counts.resize(size + 1, 0);
+    d->reservedCount = 0;
+    d->writtenCount = 0;
+    d->words.resize(d->wordCount);
+    d->wordsBegin = 0;
+    d->indicesBegin = 0;
+}
+
+/// Destroys the fingerprint index writer. The file is closed if it is
+/// still open.
+FingerprintIndexWriter::~FingerprintIndexWriter()
+{
+    if(isOpen()){
+        close();
+    }
+
+    delete d;
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of bits in each fingerprint.
+size_t FingerprintIndexWriter::size() const
+{
+    return d->size;
+}
+
+/// Returns the number of fingerprints that have been reserved.
+size_t FingerprintIndexWriter::count() const
+{
+    return d->reservedCount;
+}
+
+// --- Fingerprints -------------------------------------------------------- //
+/// Reserves space in the index for the fingerprint contained in the
+/// \p wordCount words starting at \p words. This must be called for
+/// each fingerprint before the file is opened.
+void FingerprintIndexWriter::reserve(const boost::uint64_t *words, size_t wordCount)
+{
+    d->counts[d->setWords(words, wordCount)]++;
+    d->reservedCount++;
+}
+
+/// Writes the fingerprint contained in the \p wordCount words
+/// starting at \p words to the file. The fingerprints must be written
+/// in the same order as they were reserved. Returns \c false if the
+/// fingerprint was not reserved or could not be written.
+bool FingerprintIndexWriter::write(const boost::uint64_t *words, size_t wordCount)
+{
+    if(!isOpen()){
+        d->errorString = "Fingerprint index file is not open.";
+        return false;
+    }
+
+    size_t bucket = d->setWords(words, wordCount);
+    size_t bucketCount = d->positions[bucket] + d->bufferedIndices[bucket].size();
+
+    if(d->writtenCount >= d->reservedCount || bucketCount >= d->offsets[bucket + 1]){
+        d->errorString = "Fingerprint does not match the reserved fingerprints.";
+        return false;
+    }
+
+    d->bufferedWords[bucket].insert(d->bufferedWords[bucket].end(), d->words.begin(), d->words.end());
+    d->bufferedIndices[bucket].push_back(d->writtenCount++);
+
+    if(d->bufferedIndices[bucket].size() >= BufferSize && !d->flush(bucket)){
+        d->errorString = "Failed to write fingerprint index file.";
+        return false;
+    }
+
+    return true;
+}
+
+// --- File ---------------------------------------------------------------- //
+/// Opens \p fileName and writes the index header for the reserved
+/// fingerprints. Returns \c false if the file could not be opened.
+bool FingerprintIndexWriter::open(const std::string &fileName)
+{
+    if(isOpen()){
+        close();
+    }
+
+    d->file.clear();
+    d->file.open(fileName.c_str(), std::ios_base::out | std::ios_base::binary);
+    if(!d->file.is_open()){
+        d->errorString = "Failed to open file '" + fileName + "' for writing.";
+        return false;
+    }
+
+    // the fingerprints in bucket i are at the positions from offsets[i]
+    // to offsets[i+1] as in FingerprintIndex
+    d->offsets.assign(d->size + 2, 0);
+    for(size_t i = 0; i <= d->size; i++){
+        d->offsets[i + 1] = d->offsets[i] + d->counts[i];
+    }
+
+    d->positions.assign(d->offsets.begin(), d->offsets.end() - 1);
+    d->bufferedWords.assign(d->size + 1, std::vector<Word>());
+    d->bufferedIndices.assign(d->size + 1, std::vector<Word>());
+    d->writtenCount = 0;
+
+    detail::IndexHeader header;
+    std::memset(&header, 0, sizeof(detail::IndexHeader));
+    std::copy(detail::IndexMagic, detail::IndexMagic + 8, header.magic);
+    header.byteOrder = detail::IndexByteOrder;
+    header.size = d->size;
+    header.wordCount = d->wordCount;
+    header.count = d->reservedCount;
+
+    detail::writeIndexSection(d->file, &header, sizeof(detail::IndexHeader));
+    detail::writeIndexSection(d->file, &d->offsets[0], d->offsets.size() * sizeof(Word));
+
+    d->wordsBegin = detail::indexWordsBegin(d->size);
+    d->indicesBegin = detail::indexIndicesBegin(d->size, d->wordCount, d->reservedCount);
+
+    // extend the file to its full size so that the padding between
+    // the sections is filled with zeros
+    size_t fileSize = detail::indexFileSize(d->size, d->wordCount, d->reservedCount);
+    if(fileSize > d->wordsBegin){
+        d->file.seekp(fileSize - 1);
+        d->file.put(0);
+    }
+
+    if(!d->file){
+        d->errorString = "Failed to write file '" + fileName + "'.";
+        d->file.close();
+        return false;
+    }
+
+    return true;
+}
+
+/// Writes the remaining fingerprints and closes the file. Returns
+/// \c false if fewer fingerprints were written than were reserved or
+/// if the file could not be written.
+///
+/// The reserved fingerprints are cleared so the writer can be used
+/// to write another index.
+bool FingerprintIndexWriter::close()
+{
+    if(!isOpen()){
+        return false;
+    }
+
+    bool ok = true;
+
+    for(size_t i = 0; i <= d->size; i++){
+        if(!d->flush(i)){
+            d->errorString = "Failed to write fingerprint index file.";
+            ok = false;
+            break;
+        }
+    }
+
+    if(ok && d->writtenCount != d->reservedCount){
+        d->errorString = "Fewer fingerprints were written than were reserved.";
+        ok = false;
+    }
+
+    d->file.close();
+    if(ok && !d->file){
+        d->errorString = "Failed to write fingerprint index file.";
+        ok = false;
+    }
+
+    std::fill(d->counts.begin(), d->counts.end(), Word(0));
+    d->reservedCount = 0;
+    d->writtenCount = 0;
+    std::vector<std::vector<Word> >().swap(d->bufferedWords);
+    std::vector<std::vector<Word> >().swap(d->bufferedIndices);
+
+    return ok;
+}
+
+/// Returns \c true if the file is open.
+bool FingerprintIndexWriter::isOpen() const
+{
+    return d->file.is_open();
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occured.
+std::string FingerprintIndexWriter::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
@@ -56,49 +56,6 @@ inline Molecule* Fragment::molecule() const
     return m_molecule;
 }
 
-// --- Structure ----------------------------------------------------------- //
-/// Returns the atom at \p index in the fragment.
-inline Atom* Fragment::atom(size_t index) const
-{
-    size_t position = m_bitset.find_first();
-
-    while(index--){
-        position = m_bitset.find_next(position);
-
-        if(position == Bitset::npos){
-            return 0;
-        }
-    }
-
-    return m_molecule->atom(position);
-}
-
-/// Returns a list of all the atoms in the fragment.
-inline std::vector<Atom *> Fragment::atoms() const
-{
-    std::vector<Atom *> atoms;
-
-    for(size_t i = 0; i < m_bitset.size(); i++){
-        if(m_bitset.test(i)){
-            atoms.push_back(m_molecule->atom(i));
-        }
-    }
-
-    return atoms;
-}
-
-/// Returns the number of atoms in the fragment.
-inline size_t Fragment::atomCount() const
-{
-    return m_bitset.count();
-}
-
-/// Returns \c true if the fragment contains the atom.
-inline bool Fragment::contains(const Atom *atom) const
-{
-    return m_bitset.test(atom->index());
-}
-
 } // end chemkit namespace
 
 #endif // CHEMKIT_FRAGMENT_INLINE_H
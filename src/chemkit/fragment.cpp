@@ -40,6 +40,7 @@
 #include "bond.h"
 #include "foreach.h"
 #include "molecule.h"
+#include "moleculeprivate.h"
 
 namespace chemkit {
 
@@ -53,11 +54,11 @@ namespace chemkit {
 /// methods such as Molecule::fragments() and Atom::fragment().
 
 // --- Construction and Destruction ---------------------------------------- //
-/// Creates a new fragment that contains all the atoms attached to
-/// \p root.
-Fragment::Fragment(Molecule *molecule, const Bitset &bitset)
+/// Creates a new fragment which is the fragment at \p index in
+/// \p molecule.
+Fragment::Fragment(Molecule *molecule, size_t index)
     : m_molecule(molecule),
-      m_bitset(bitset)
+      m_index(index)
 {
 }
 
@@ -67,6 +68,48 @@ Fragment::~Fragment()
 }
 
 // --- Structure ----------------------------------------------------------- //
+/// Returns the atom at \p index in the fragment.
+Atom* Fragment::atom(size_t index) const
+{
+    const MoleculePrivate *d = m_molecule->d;
+
+    if(index >= atomCount()){
+        return 0;
+    }
+
+    return m_molecule->atom(d->fragmentAtoms[d->fragmentAtomOffsets[m_index] + index]);
+}
+
+/// Returns a list of all the atoms in the fragment.
+std::vector<Atom *> Fragment::atoms() const
+{
+    const MoleculePrivate *d = m_molecule->d;
+
+    std::vector<Atom *> atoms;
+    atoms.reserve(atomCount());
+
+    for(size_t i = d->fragmentAtomOffsets[m_index]; i < d->fragmentAtomOffsets[m_index + 1]; i++){
+        atoms.push_back(m_molecule->atom(d->fragmentAtoms[i]));
+    }
+
+    return atoms;
+}
+
+/// Returns the number of atoms in the fragment.
+size_t Fragment::atomCount() const
+{
+    const MoleculePrivate *d = m_molecule->d;
+
+    return d->fragmentAtomOffsets[m_index + 1] - d->fragmentAtomOffsets[m_index];
+}
+
+/// Returns \c true if the fragment contains the atom.
+bool Fragment::contains(const Atom *atom) const
+{
+    return atom->molecule() == m_molecule &&
+           m_molecule->d->atomFragments[atom->index()] == m_index;
+}
+
 /// Returns a list of all the bonds in the fragment.
 std::vector<Bond *> Fragment::bonds() const
 {
@@ -74,7 +117,8 @@ std::vector<Bond *> Fragment::bonds() const
 
     foreach(Atom *atom, atoms()){
         foreach(Bond *bond, atom->bonds()){
-            if(std::find(bonds.begin(), bonds.end(), bond) == bonds.end()){
+            // add each bond once from the atom with the lower index
+            if(bond->otherAtom(atom)->index() > atom->index()){
                 bonds.push_back(bond);
             }
         }
@@ -92,7 +136,7 @@ size_t Fragment::bondCount() const
 /// Returns \c true if the fragment contains the bond.
 bool Fragment::contains(const Bond *bond) const
 {
-    return bond->atom1()->fragment() == this;
+    return contains(bond->atom1());
 }
 
 } // end chemkit namespace
@@ -40,8 +40,6 @@
 
 #include <vector>
 
-#include "bitset.h"
-
 namespace chemkit {
 
 class Atom;
@@ -56,16 +54,16 @@ public:
     inline Molecule* molecule() const;
 
     // structure
-    inline Atom* atom(size_t index) const;
-    inline std::vector<Atom *> atoms() const;
-    inline size_t atomCount() const;
-    inline bool contains(const Atom *atom) const;
+    Atom* atom(size_t index) const;
+    std::vector<Atom *> atoms() const;
+    size_t atomCount() const;
+    bool contains(const Atom *atom) const;
     std::vector<Bond *> bonds() const;
     size_t bondCount() const;
     bool contains(const Bond *bond) const;
 
 private:
-    Fragment(Molecule *molecule, const Bitset &bitset);
+    Fragment(Molecule *molecule, size_t index);
     ~Fragment();
 
     CHEMKIT_DISABLE_COPY(Fragment)
@@ -74,7 +72,7 @@ private:
 
 private:
     Molecule* m_molecule;
-    Bitset m_bitset;
+    size_t m_index;
 };
 
 } // end chemkit namespace
@@ -0,0 +1,494 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_MCSPLIT_H
+#define CHEMKIT_MCSPLIT_H
+
+#include "chemkit.h"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "graph.h"
+
+namespace chemkit {
+namespace algorithm {
+namespace detail {
+
+// Orders vertices by their label in a row of edge labels.
+class McsplitRowComparator
+{
+public:
+    McsplitRowComparator(const std::vector<int> &row)
+        : m_row(row)
+    {
+    }
+
+    template<typename T>
+    bool operator()(T a, T b) const
+    {
+        return m_row[a] < m_row[b];
+    }
+
+private:
+    const std::vector<int> &m_row;
+};
+
+// The McsplitSearch class implements the McSplit algorithm for finding
+// the maximum common induced subgraph of two labelled graphs [McCreesh
+// 2017]. The unmatched vertices are kept partitioned into bidomains of
+// left and right vertices which have the same label and the same edge
+// labels to every matched vertex. Only vertices in the same bidomain
+// can be matched, so the sum of the smaller side of each bidomain is
+// an upper bound on the number of vertices that can still be added to
+// the mapping and is used to prune the search.
+//
+// The vertices in each bidomain are stored as contiguous ranges of the
+// m_left and m_right arrays which are reordered in place as bidomains
+// are split.
+template<typename T>
+class McsplitSearch
+{
+public:
+    McsplitSearch(const Graph<T> &a,
+                  const std::vector<int> &aVertexLabels,
+                  const std::vector<std::vector<int> > &aEdgeLabels,
+                  const Graph<T> &b,
+                  const std::vector<int> &bVertexLabels,
+                  const std::vector<std::vector<int> > &bEdgeLabels,
+                  bool connected,
+                  size_t nodeLimit,
+                  int timeLimit);
+
+    bool run(std::vector<std::pair<T, T> > &mapping);
+
+private:
+    struct Bidomain
+    {
+        size_t left;
+        size_t right;
+        size_t leftSize;
+        size_t rightSize;
+        bool adjacent;
+    };
+
+    void search(std::vector<Bidomain> &domains);
+    int selectDomain(const std::vector<Bidomain> &domains) const;
+    void split(const std::vector<Bidomain> &domains, T v, T w, std::vector<Bidomain> &newDomains);
+    bool limitReached();
+
+    CHEMKIT_DISABLE_COPY(McsplitSearch)
+
+private:
+    const Graph<T> &m_a;
+    const Graph<T> &m_b;
+    const std::vector<int> &m_aVertexLabels;
+    const std::vector<int> &m_bVertexLabels;
+    const std::vector<std::vector<int> > &m_aEdgeLabels;
+    const std::vector<std::vector<int> > &m_bEdgeLabels;
+    bool m_connected;
+    size_t m_nodeLimit;
+    int m_timeLimit;
+    size_t m_nodeCount;
+    bool m_stopped;
+    boost::posix_time::ptime m_deadline;
+    std::vector<T> m_left;
+    std::vector<T> m_right;
+    std::vector<int> m_leftRow;
+    std::vector<int> m_rightRow;
+    std::vector<std::pair<T, T> > m_mapping;
+    std::vector<std::pair<T, T> > m_bestMapping;
+};
+
+template<typename T>
+inline McsplitSearch<T>::McsplitSearch(const Graph<T> &a,
+                                       const std::vector<int> &aVertexLabels,
+                                       const std::vector<std::vector<int> > &aEdgeLabels,
+                                       const Graph<T> &b,
+                                       const std::vector<int> &bVertexLabels,
+                                       const std::vector<std::vector<int> > &bEdgeLabels,
+                                       bool connected,
+                                       size_t nodeLimit,
+                                       int timeLimit)
+    : m_a(a),
+      m_b(b),
+      m_aVertexLabels(aVertexLabels),
+      m_bVertexLabels(bVertexLabels),
+      m_aEdgeLabels(aEdgeLabels),
+      m_bEdgeLabels(bEdgeLabels),
+      m_connected(connected),
+      m_nodeLimit(nodeLimit),
+      m_timeLimit(timeLimit),
+      m_nodeCount(0),
+      m_stopped(false),
+      m_leftRow(a.size(), 0),
+      m_rightRow(b.size(), 0)
+{
+}
+
+// Runs the search and sets mapping to the largest mapping found.
+// Returns false if the search was stopped by the node or time limit
+// before the mapping was shown to be a maximum.
+template<typename T>
+inline bool McsplitSearch<T>::run(std::vector<std::pair<T, T> > &mapping)
+{
+    if(m_timeLimit > 0){
+        m_deadline = boost::posix_time::microsec_clock::universal_time() +
+                     boost::posix_time::milliseconds(m_timeLimit);
+    }
+
+    // create the initial bidomains from the vertex labels
+    for(T i = 0; i < m_a.size(); i++){
+        m_left.push_back(i);
+    }
+    for(T i = 0; i < m_b.size(); i++){
+        m_right.push_back(i);
+    }
+
+    std::sort(m_left.begin(), m_left.end(), McsplitRowComparator(m_aVertexLabels));
+    std::sort(m_right.begin(), m_right.end(), McsplitRowComparator(m_bVertexLabels));
+
+    std::vector<Bidomain> domains;
+
+    size_t i = 0;
+    size_t j = 0;
+    while(i < m_left.size() && j < m_right.size()){
+        int leftLabel = m_aVertexLabels[m_left[i]];
+        int rightLabel = m_bVertexLabels[m_right[j]];
+
+        size_t leftEnd = i;
+        while(leftEnd < m_left.size() && m_aVertexLabels[m_left[leftEnd]] == leftLabel){
+            leftEnd++;
+        }
+
+        size_t rightEnd = j;
+        while(rightEnd < m_right.size() && m_bVertexLabels[m_right[rightEnd]] == rightLabel){
+            rightEnd++;
+        }
+
+        if(leftLabel == rightLabel){
+            Bidomain domain = { i, j, leftEnd - i, rightEnd - j, false };
+            domains.push_back(domain);
+        }
+
+        if(leftLabel <= rightLabel){
+            i = leftEnd;
+        }
+        if(rightLabel <= leftLabel){
+            j = rightEnd;
+        }
+    }
+
+    search(domains);
+
+    mapping = m_bestMapping;
+
+    return !m_stopped;
+}
+
+template<typename T>
+inline void McsplitSearch<T>::search(std::vector<Bidomain> &domains)
+{
+    if(m_mapping.size() > m_bestMapping.size()){
+        m_bestMapping = m_mapping;
+    }
+
+    if(limitReached()){
+        return;
+    }
+
+    size_t bound = m_mapping.size();
+    for(size_t i = 0; i < domains.size(); i++){
+        bound += (std::min)(domains[i].leftSize, domains[i].rightSize);
+    }
+
+    if(bound <= m_bestMapping.size()){
+        return;
+    }
+
+    int domainIndex = selectDomain(domains);
+    if(domainIndex == -1){
+        return;
+    }
+
+    Bidomain &domain = domains[domainIndex];
+
+    // select the left vertex with the most neighbors and move it
+    // out of the bidomain
+    size_t vertexIndex = domain.left;
+    for(size_t i = domain.left + 1; i < domain.left + domain.leftSize; i++){
+        if(m_a.neighbors(m_left[i]).size() > m_a.neighbors(m_left[vertexIndex]).size()){
+            vertexIndex = i;
+        }
+    }
+
+    domain.leftSize--;
+    std::swap(m_left[vertexIndex], m_left[domain.left + domain.leftSize]);
+    T v = m_left[domain.left + domain.leftSize];
+
+    // try to match v with each right vertex in the bidomain. the right
+    // vertices are reordered by the searches below so the next vertex
+    // is found by its index rather than its position
+    size_t rightCount = domain.rightSize;
+    T lastW = 0;
+
+    for(size_t k = 0; k < rightCount; k++){
+        size_t wIndex = domain.right + domain.rightSize;
+        for(size_t i = domain.right; i < domain.right + domain.rightSize; i++){
+            if((k == 0 || m_right[i] > lastW) &&
+               (wIndex == domain.right + domain.rightSize || m_right[i] < m_right[wIndex])){
+                wIndex = i;
+            }
+        }
+
+        domain.rightSize--;
+        std::swap(m_right[wIndex], m_right[domain.right + domain.rightSize]);
+        T w = m_right[domain.right + domain.rightSize];
+
+        std::vector<Bidomain> newDomains;
+        split(domains, v, w, newDomains);
+
+        m_mapping.push_back(std::make_pair(v, w));
+        search(newDomains);
+        m_mapping.pop_back();
+
+        domain.rightSize++;
+        lastW = w;
+
+        if(m_stopped){
+            return;
+        }
+    }
+
+    // try leaving v unmatched
+    search(domains);
+}
+
+// Returns the index of the bidomain to select the next vertex from or
+// -1 if there are no bidomains that can extend the mapping. When only
+// connected subgraphs are searched for the bidomain must be adjacent
+// to a matched vertex.
+template<typename T>
+inline int McsplitSearch<T>::selectDomain(const std::vector<Bidomain> &domains) const
+{
+    int index = -1;
+    size_t size = 0;
+
+    for(size_t i = 0; i < domains.size(); i++){
+        const Bidomain &domain = domains[i];
+
+        if(domain.leftSize == 0 || domain.rightSize == 0){
+            continue;
+        }
+        else if(m_connected && !m_mapping.empty() && !domain.adjacent){
+            continue;
+        }
+
+        size_t domainSize = (std::max)(domain.leftSize, domain.rightSize);
+        if(index == -1 || domainSize < size){
+            index = i;
+            size = domainSize;
+        }
+    }
+
+    return index;
+}
+
+// Splits each bidomain by the labels of the edges from its vertices
+// to v and w and adds the non-empty parts to newDomains.
+template<typename T>
+inline void McsplitSearch<T>::split(const std::vector<Bidomain> &domains, T v, T w, std::vector<Bidomain> &newDomains)
+{
+    const std::vector<T> &vNeighbors = m_a.neighbors(v);
+    for(size_t i = 0; i < vNeighbors.size(); i++){
+        m_leftRow[vNeighbors[i]] = m_aEdgeLabels[v][i];
+    }
+
+    const std::vector<T> &wNeighbors = m_b.neighbors(w);
+    for(size_t i = 0; i < wNeighbors.size(); i++){
+        m_rightRow[wNeighbors[i]] = m_bEdgeLabels[w][i];
+    }
+
+    for(size_t d = 0; d < domains.size(); d++){
+        const Bidomain &domain = domains[d];
+
+        if(domain.leftSize == 0 || domain.rightSize == 0){
+            continue;
+        }
+
+        size_t leftEnd = domain.left + domain.leftSize;
+        size_t rightEnd = domain.right + domain.rightSize;
+
+        std::sort(m_left.begin() + domain.left, m_left.begin() + leftEnd, McsplitRowComparator(m_leftRow));
+        std::sort(m_right.begin() + domain.right, m_right.begin() + rightEnd, McsplitRowComparator(m_rightRow));
+
+        size_t i = domain.left;
+        size_t j = domain.right;
+        while(i < leftEnd && j < rightEnd){
+            int leftLabel = m_leftRow[m_left[i]];
+            int rightLabel = m_rightRow[m_right[j]];
+
+            size_t leftGroupEnd = i;
+            while(leftGroupEnd < leftEnd && m_leftRow[m_left[leftGroupEnd]] == leftLabel){
+                leftGroupEnd++;
+            }
+
+            size_t rightGroupEnd = j;
+            while(rightGroupEnd < rightEnd && m_rightRow[m_right[rightGroupEnd]] == rightLabel){
+                rightGroupEnd++;
+            }
+
+            if(leftLabel == rightLabel){
+                Bidomain newDomain = { i,
+                                       j,
+                                       leftGroupEnd - i,
+                                       rightGroupEnd - j,
+                                       domain.adjacent || leftLabel != 0 };
+                newDomains.push_back(newDomain);
+            }
+
+            if(leftLabel <= rightLabel){
+                i = leftGroupEnd;
+            }
+            if(rightLabel <= leftLabel){
+                j = rightGroupEnd;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < vNeighbors.size(); i++){
+        m_leftRow[vNeighbors[i]] = 0;
+    }
+
+    for(size_t i = 0; i < wNeighbors.size(); i++){
+        m_rightRow[wNeighbors[i]] = 0;
+    }
+}
+
+// Counts a search node and returns true if the node or time limit has
+// been reached. The clock is only checked every 256 nodes.
+template<typename T>
+inline bool McsplitSearch<T>::limitReached()
+{
+    if(m_stopped){
+        return true;
+    }
+
+    m_nodeCount++;
+
+    if(m_nodeLimit > 0 && m_nodeCount > m_nodeLimit){
+        m_stopped = true;
+    }
+    else if(m_timeLimit > 0 && (m_nodeCount & 0xff) == 0 &&
+            boost::posix_time::microsec_clock::universal_time() > m_deadline){
+        m_stopped = true;
+    }
+
+    return m_stopped;
+}
+
+} // end detail namespace
+
+// Returns an upper bound on the number of vertices in a common
+// subgraph of two graphs with the vertex labels a and b. This is the
+// number of vertices that could be matched if every vertex in one
+// graph could be matched to any vertex with the same label in the
+// other.
+inline size_t mcsplitBound(const std::vector<int> &a, const std::vector<int> &b)
+{
+    std::vector<int> sortedA = a;
+    std::vector<int> sortedB = b;
+    std::sort(sortedA.begin(), sortedA.end());
+    std::sort(sortedB.begin(), sortedB.end());
+
+    size_t bound = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    while(i < sortedA.size() && j < sortedB.size()){
+        if(sortedA[i] < sortedB[j]){
+            i++;
+        }
+        else if(sortedB[j] < sortedA[i]){
+            j++;
+        }
+        else{
+            bound++;
+            i++;
+            j++;
+        }
+    }
+
+    return bound;
+}
+
+// Finds the maximum common induced subgraph of graphs a and b and sets
+// mapping to the pairs of matched vertices. Vertices can only be
+// matched if they have the same label and the edges between matched
+// vertices must have the same label in both graphs. The edge labels
+// for each vertex are given in the same order as its neighbors and
+// must not be zero. If connected is true only connected subgraphs are
+// searched for.
+//
+// The search stops after visiting nodeLimit search nodes or after
+// timeLimit milliseconds if either is greater than zero. Returns false
+// if the search was stopped, in which case mapping is set to the
+// largest common subgraph found so far.
+template<typename T>
+bool mcsplit(const Graph<T> &a,
+             const std::vector<int> &aVertexLabels,
+             const std::vector<std::vector<int> > &aEdgeLabels,
+             const Graph<T> &b,
+             const std::vector<int> &bVertexLabels,
+             const std::vector<std::vector<int> > &bEdgeLabels,
+             bool connected,
+             size_t nodeLimit,
+             int timeLimit,
+             std::vector<std::pair<T, T> > &mapping)
+{
+    detail::McsplitSearch<T> search(a, aVertexLabels, aEdgeLabels,
+                                    b, bVertexLabels, bEdgeLabels,
+                                    connected, nodeLimit, timeLimit);
+
+    return search.run(mapping);
+}
+
+} // end algorithm namespace
+} // end chemkit namespace
+
+#endif // CHEMKIT_MCSPLIT_H
@@ -52,6 +52,7 @@ public:
     // construction and destruction
     Moiety();
     Moiety(const std::vector<Atom *> &atoms);
+    Moiety(const Moiety &moiety);
     ~Moiety();
 
     // properties
@@ -36,6 +36,7 @@
 #include "molecule.h"
 
 #include <map>
+#include <new>
 #include <queue>
 #include <sstream>
 #include <algorithm>
@@ -66,20 +67,82 @@
 #include "fingerprint.h"
 #include "moleculeprivate.h"
 #include "moleculewatcher.h"
+#include "stereochemistry.h"
+#include "aromaticitymodel.h"
 #include "diagramcoordinates.h"
 #include "internalcoordinates.h"
 #include "moleculardescriptor.h"
 #include "cartesiancoordinates.h"
+#include "topologicaldistancematrix.h"
 
 namespace chemkit {
 
 // === MoleculePrivate ===================================================== //
 MoleculePrivate::MoleculePrivate()
+    : ringPool(16),
+      fragmentPool(8)
 {
     fragmentsPerceived = false;
     ringsPerceived = false;
+    aromaticityPerceived = false;
+    fragmentIdsValid = true;
+    version = 0;
+    resultCacheEnabled = false;
+    resultCacheHitCount = 0;
+    resultCacheMissCount = 0;
+}
+
+namespace {
+
+// Sorts the (index, ring) pairs in members into a list of rings for
+// each index. The rings for index i are stored in rings between
+// offsets[i] and offsets[i+1] in the same order they were found.
+void buildRingIndex(const std::vector<std::pair<size_t, Ring *> > &members,
+                    size_t count,
+                    std::vector<size_t> &offsets,
+                    std::vector<Ring *> &rings,
+                    std::vector<Ring *> &smallestRings)
+{
+    offsets.assign(count + 1, 0);
+    smallestRings.assign(count, 0);
+
+    for(size_t i = 0; i < members.size(); i++){
+        offsets[members[i].first + 1]++;
+    }
+
+    for(size_t i = 0; i < count; i++){
+        offsets[i + 1] += offsets[i];
+    }
+
+    std::vector<size_t> position(offsets.begin(), offsets.end() - 1);
+    rings.resize(members.size());
+
+    for(size_t i = 0; i < members.size(); i++){
+        size_t index = members[i].first;
+        Ring *ring = members[i].second;
+
+        rings[position[index]++] = ring;
+
+        if(!smallestRings[index] || ring->size() < smallestRings[index]->size()){
+            smallestRings[index] = ring;
+        }
+    }
 }
 
+// Returns the root of the fragment containing atom. The ids vector
+// stores the parent of each atom and is compressed as it is searched.
+size_t findFragmentId(std::vector<size_t> &ids, size_t atom)
+{
+    while(ids[atom] != atom){
+        ids[atom] = ids[ids[atom]];
+        atom = ids[atom];
+    }
+
+    return atom;
+}
+
+} // end anonymous namespace
+
 // === Molecule ============================================================ //
 /// \class Molecule molecule.h chemkit/molecule.h
 /// \ingroup chemkit
@@ -115,6 +178,13 @@ MoleculePrivate::MoleculePrivate()
 /// Molecule objects take ownership of all the Atom, Bond, Ring,
 /// Fragment, and CoordinateSet objects that they contain. Deleting
 /// the molecule will also delete all of the objects that it contains.
+///
+/// The Atom, Bond, Ring and Fragment objects are stored in memory
+/// pools owned by the molecule rather than being allocated one at a
+/// time. When the number of atoms or bonds is known ahead of time
+/// (e.g. when reading a file) calling setAtomCapacity() and
+/// setBondCapacity() before adding them allows the molecule to
+/// allocate all of the required memory at once.
 
 // --- Construction and Destruction ---------------------------------------- //
 /// Creates a new, empty molecule.
@@ -153,7 +223,9 @@ Molecule::Molecule(const std::string &formula, const std::string &format)
         return;
     }
 
-    *this = *molecule;
+    // take the atoms and bonds from the parsed molecule rather
+    // than copying them
+    swapStructure(*molecule);
 }
 
 /// Creates a new molecule that is a copy of \p molecule.
@@ -163,37 +235,37 @@ Molecule::Molecule(const Molecule &molecule)
     m_coordinates = 0;
     m_stereochemistry = 0;
 
-    d->name = molecule.name();
-
-    std::map<const Atom *, Atom *> oldToNew;
-
-    foreach(const Atom *atom, molecule.atoms()){
-        Atom *newAtom = addAtomCopy(atom);
-        oldToNew[atom] = newAtom;
-    }
+    copyStructure(molecule);
+}
 
-    foreach(const Bond *bond, molecule.bonds()){
-        Bond *newBond = addBond(oldToNew[bond->atom1()], oldToNew[bond->atom2()]);
-        newBond->setOrder(bond->order());
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+/// Creates a new molecule by moving the contents of \p molecule
+/// into it. No atoms or bonds are copied and \p molecule is left
+/// empty.
+Molecule::Molecule(Molecule &&molecule)
+    : d(new MoleculePrivate)
+{
+    m_coordinates = 0;
+    m_stereochemistry = 0;
 
-        if(bond->stereochemistry() != Stereochemistry::None){
-            newBond->setStereochemistry(bond->stereochemistry());
-        }
-    }
+    swapStructure(molecule);
 }
+#endif
 
 /// Destroys a molecule. This also destroys all of the atoms and
 /// bonds that the molecule contains.
 Molecule::~Molecule()
 {
+    // destroy atoms, bonds, rings and fragments. their memory is
+    // released all at once when the object pools are deleted.
     foreach(Atom *atom, m_atoms)
-        delete atom;
+        atom->~Atom();
     foreach(Bond *bond, d->bonds)
-        delete bond;
+        bond->~Bond();
     foreach(Ring *ring, d->rings)
-        delete ring;
+        ring->~Ring();
     foreach(Fragment *fragment, d->fragments)
-        delete fragment;
+        fragment->~Fragment();
 
     // delete coordinates and all coordinate sets
     bool deletedCoordinates = false;
@@ -306,12 +378,29 @@ std::string Molecule::formula(const std::string &format) const
 /// \see MolecularDescriptor
 Variant Molecule::descriptor(const std::string &name) const
 {
+    if(d->resultCacheEnabled){
+        std::map<std::string, std::pair<size_t, Variant> >::const_iterator iter = d->descriptorCache.find(name);
+
+        if(iter != d->descriptorCache.end() && iter->second.first == d->version){
+            d->resultCacheHitCount++;
+            return iter->second.second;
+        }
+
+        d->resultCacheMissCount++;
+    }
+
     boost::scoped_ptr<MolecularDescriptor> descriptor(MolecularDescriptor::create(name));
     if(!descriptor){
         return Variant();
     }
 
-    return descriptor->value(this);
+    Variant value = descriptor->value(this);
+
+    if(d->resultCacheEnabled){
+        d->descriptorCache[name] = std::make_pair(d->version, value);
+    }
+
+    return value;
 }
 
 /// Returns the binary fingerprint for \p name.
@@ -322,12 +411,89 @@ Variant Molecule::descriptor(const std::string &name) const
 /// \see Fingerprint
 Bitset Molecule::fingerprint(const std::string &name) const
 {
+    if(d->resultCacheEnabled){
+        std::map<std::string, std::pair<size_t, Bitset> >::const_iterator iter = d->fingerprintCache.find(name);
+
+        if(iter != d->fingerprintCache.end() && iter->second.first == d->version){
+            d->resultCacheHitCount++;
+            return iter->second.second;
+        }
+
+        d->resultCacheMissCount++;
+    }
+
     boost::scoped_ptr<Fingerprint> fingerprint(Fingerprint::create(name));
     if(!fingerprint){
         return Bitset();
     }
 
-    return fingerprint->value(this);
+    Bitset value = fingerprint->value(this);
+
+    if(d->resultCacheEnabled){
+        d->fingerprintCache[name] = std::make_pair(d->version, value);
+    }
+
+    return value;
+}
+
+/// Enables or disables caching of descriptor and fingerprint values
+/// for the molecule. The default is \c false.
+///
+/// When enabled, descriptor() and fingerprint() store the values they
+/// calculate and return the stored value for later calls with the
+/// same name. The screens used by SubstructureQuery are also stored.
+/// Stored values are discarded whenever the molecule is changed
+/// through its Atom, Bond or Molecule methods. Coordinates modified
+/// directly through a CoordinateSet are not tracked and require a
+/// call to clearResultCache().
+///
+/// \code
+/// molecule->setResultCacheEnabled(true);
+/// Variant tpsa = molecule->descriptor("tpsa"); // calculated
+/// tpsa = molecule->descriptor("tpsa"); // from the cache
+/// \endcode
+///
+/// \see resultCacheHitCount(), resultCacheMissCount()
+void Molecule::setResultCacheEnabled(bool enabled)
+{
+    d->resultCacheEnabled = enabled;
+
+    if(!enabled){
+        clearResultCache();
+    }
+}
+
+/// Returns \c true if descriptor and fingerprint values are cached.
+bool Molecule::isResultCacheEnabled() const
+{
+    return d->resultCacheEnabled;
+}
+
+/// Discards all cached descriptor and fingerprint values and resets
+/// the hit and miss counts.
+void Molecule::clearResultCache()
+{
+    d->descriptorCache.clear();
+    d->fingerprintCache.clear();
+    for(size_t i = 0; i < 4; i++){
+        d->substructureScreenCache[i] = std::make_pair(size_t(0), Bitset());
+    }
+    d->resultCacheHitCount = 0;
+    d->resultCacheMissCount = 0;
+}
+
+/// Returns the number of descriptor() and fingerprint() calls which
+/// were answered from the cache.
+size_t Molecule::resultCacheHitCount() const
+{
+    return d->resultCacheHitCount;
+}
+
+/// Returns the number of descriptor() and fingerprint() calls which
+/// calculated their value while the cache was enabled.
+size_t Molecule::resultCacheMissCount() const
+{
+    return d->resultCacheMissCount;
 }
 
 /// Returns the total molar mass of the molecule. Mass is in g/mol.
@@ -382,7 +548,7 @@ Variant Molecule::data(const std::string &name) const
 /// \endcode
 Atom* Molecule::addAtom(const Element &element)
 {
-    Atom *atom = new Atom(this, m_atoms.size());
+    Atom *atom = new(d->atomPool.allocate()) Atom(this, m_atoms.size());
     m_atoms.push_back(atom);
 
     // add atom properties
@@ -390,6 +556,11 @@ Atom* Molecule::addAtom(const Element &element)
     d->atomBonds.push_back(std::vector<Bond *>());
     d->partialCharges.push_back(0);
 
+    // the new atom is in a fragment by itself
+    if(d->fragmentIdsValid){
+        d->atomFragmentIds.push_back(atom->m_index);
+    }
+
     // set atom position
     if(m_coordinates){
         m_coordinates->append(0, 0, 0);
@@ -451,17 +622,105 @@ void Molecule::removeAtom(Atom *atom)
     }
 
     atom->m_molecule = 0;
+    d->fragmentIdsValid = false;
+    setRingsPerceived(false);
     setFragmentsPerceived(false);
     notifyWatchers(atom, MoleculeWatcher::AtomRemoved);
 
-    delete atom;
+    atom->~Atom();
+    d->atomPool.deallocate(atom);
 }
 
-/// Removes each atom in \p atoms from the molecule.
+/// Removes each atom in \p atoms from the molecule. This will also
+/// remove any bonds to/from the atoms.
+///
+/// The atoms are removed together in a single pass over the
+/// molecule, so removing many atoms at once (e.g. all of the
+/// hydrogens in a protein) is much faster than calling removeAtom()
+/// for each of them. Watchers are notified once all of the atoms
+/// have been removed.
 void Molecule::removeAtoms(const std::vector<Atom *> &atoms)
 {
-    BOOST_REVERSE_FOREACH(Atom *atom, atoms){
-        removeAtom(atom);
+    // mark the atoms to remove
+    std::vector<bool> removed(m_atoms.size(), false);
+    std::vector<Atom *> removedAtoms;
+
+    foreach(Atom *atom, atoms){
+        if(contains(atom) && !removed[atom->index()]){
+            removed[atom->index()] = true;
+            removedAtoms.push_back(atom);
+        }
+    }
+
+    if(removedAtoms.empty()){
+        return;
+    }
+
+    // remove all bonds to/from the atoms first
+    std::vector<Bond *> removedBonds;
+
+    for(size_t i = 0; i < d->bonds.size(); i++){
+        const std::pair<Atom *, Atom *> &bondAtoms = d->bondAtoms[i];
+
+        if(removed[bondAtoms.first->m_index] || removed[bondAtoms.second->m_index]){
+            removedBonds.push_back(d->bonds[i]);
+        }
+    }
+
+    removeBonds(removedBonds);
+
+    // move the remaining atoms and their properties to the front
+    size_t atomTypeCount = 0;
+    size_t count = 0;
+
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        if(removed[i]){
+            continue;
+        }
+
+        if(i < d->atomTypes.size()){
+            d->atomTypes[atomTypeCount++].swap(d->atomTypes[i]);
+        }
+
+        if(count != i){
+            m_atoms[count] = m_atoms[i];
+            m_atoms[count]->m_index = count;
+            m_elements[count] = m_elements[i];
+            d->atomBonds[count].swap(d->atomBonds[i]);
+            d->partialCharges[count] = d->partialCharges[i];
+
+            if(m_coordinates){
+                m_coordinates->setPosition(count, m_coordinates->position(i));
+            }
+        }
+
+        count++;
+    }
+
+    m_atoms.resize(count);
+    m_elements.resize(count);
+    d->atomBonds.resize(count);
+    d->partialCharges.resize(count);
+    d->atomTypes.resize(atomTypeCount);
+
+    if(m_coordinates){
+        m_coordinates->resize(count);
+    }
+
+    foreach(Atom *atom, removedAtoms){
+        d->isotopes.erase(atom);
+        atom->m_molecule = 0;
+    }
+
+    d->fragmentIdsValid = false;
+    setRingsPerceived(false);
+    setFragmentsPerceived(false);
+
+    foreach(Atom *atom, removedAtoms){
+        notifyWatchers(atom, MoleculeWatcher::AtomRemoved);
+
+        atom->~Atom();
+        d->atomPool.deallocate(atom);
     }
 }
 
@@ -473,11 +732,13 @@ size_t Molecule::atomCount(const Element &element) const
 }
 
 /// Requests that the atom capacity for the molecule be increased to
-/// \p capacity.
+/// \p capacity. This allocates storage for all of the atoms at once
+/// instead of growing it as atoms are added.
 ///
 /// \internal
 void Molecule::setAtomCapacity(size_t capacity)
 {
+    d->atomPool.reserve(capacity);
     m_atoms.reserve(capacity);
     m_elements.reserve(capacity);
     d->atomBonds.reserve(capacity);
@@ -524,7 +785,7 @@ Bond* Molecule::addBond(Atom *a, Atom *b, int order)
         return bond(a, b);
     }
 
-    Bond *bond = new Bond(this, d->bonds.size());
+    Bond *bond = new(d->bondPool.allocate()) Bond(this, d->bonds.size());
     d->atomBonds[a->index()].push_back(bond);
     d->atomBonds[b->index()].push_back(bond);
     d->bonds.push_back(bond);
@@ -533,6 +794,14 @@ Bond* Molecule::addBond(Atom *a, Atom *b, int order)
     d->bondAtoms.push_back(std::make_pair(a, b));
     d->bondOrders.push_back(order);
 
+    // join the fragments containing the two atoms
+    if(d->fragmentIdsValid){
+        size_t rootA = findFragmentId(d->atomFragmentIds, a->m_index);
+        size_t rootB = findFragmentId(d->atomFragmentIds, b->m_index);
+
+        d->atomFragmentIds[std::max(rootA, rootB)] = std::min(rootA, rootB);
+    }
+
     setRingsPerceived(false);
     setFragmentsPerceived(false);
 
@@ -570,12 +839,15 @@ void Molecule::removeBond(Bond *bond)
         d->bonds[i]->m_index--;
     }
 
+    // the bond's fragment may have been split in two
+    d->fragmentIdsValid = false;
     setRingsPerceived(false);
     setFragmentsPerceived(false);
 
     notifyWatchers(bond, MoleculeWatcher::BondRemoved);
 
-    delete bond;
+    bond->~Bond();
+    d->bondPool.deallocate(bond);
 }
 
 /// Removes the bond between atoms \p a and \p b. Does nothing if
@@ -596,10 +868,76 @@ void Molecule::removeBond(size_t a, size_t b)
 }
 
 /// Removes each bond in \p bonds from the molecule.
+///
+/// Like removeAtoms(), the bonds are removed together in a single
+/// pass and watchers are notified once all of them have been removed.
 void Molecule::removeBonds(const std::vector<Bond *> &bonds)
 {
-    BOOST_REVERSE_FOREACH(Bond *bond, bonds){
-        removeBond(bond);
+    // mark the bonds to remove
+    std::vector<bool> removed(d->bonds.size(), false);
+    std::vector<Bond *> removedBonds;
+
+    foreach(Bond *bond, bonds){
+        if(bond->molecule() == this && !removed[bond->index()]){
+            removed[bond->index()] = true;
+            removedBonds.push_back(bond);
+        }
+    }
+
+    if(removedBonds.empty()){
+        return;
+    }
+
+    // remove bonds from atom bond vectors
+    foreach(const Bond *bond, removedBonds){
+        const std::pair<Atom *, Atom *> &bondAtoms = d->bondAtoms[bond->index()];
+
+        for(int i = 0; i < 2; i++){
+            std::vector<Bond *> &atomBonds =
+                d->atomBonds[i == 0 ? bondAtoms.first->m_index : bondAtoms.second->m_index];
+
+            size_t count = 0;
+            for(size_t j = 0; j < atomBonds.size(); j++){
+                if(!removed[atomBonds[j]->m_index]){
+                    atomBonds[count++] = atomBonds[j];
+                }
+            }
+
+            atomBonds.resize(count);
+        }
+    }
+
+    // move the remaining bonds and their properties to the front
+    size_t count = 0;
+
+    for(size_t i = 0; i < d->bonds.size(); i++){
+        if(removed[i]){
+            continue;
+        }
+
+        if(count != i){
+            d->bonds[count] = d->bonds[i];
+            d->bonds[count]->m_index = count;
+            d->bondAtoms[count] = d->bondAtoms[i];
+            d->bondOrders[count] = d->bondOrders[i];
+        }
+
+        count++;
+    }
+
+    d->bonds.resize(count);
+    d->bondAtoms.resize(count);
+    d->bondOrders.resize(count);
+
+    d->fragmentIdsValid = false;
+    setRingsPerceived(false);
+    setFragmentsPerceived(false);
+
+    foreach(Bond *bond, removedBonds){
+        notifyWatchers(bond, MoleculeWatcher::BondRemoved);
+
+        bond->~Bond();
+        d->bondPool.deallocate(bond);
     }
 }
 
@@ -637,11 +975,13 @@ Bond* Molecule::bond(size_t a, size_t b) const
 }
 
 /// Requests that the bond capacity for the molecule be increased to
-/// \p capacity.
+/// \p capacity. This allocates storage for all of the bonds at once
+/// instead of growing it as bonds are added.
 ///
 /// \internal
 void Molecule::setBondCapacity(size_t capacity)
 {
+    d->bondPool.reserve(capacity);
     d->bonds.reserve(capacity);
     d->bondOrders.reserve(capacity);
     d->bondAtoms.reserve(capacity);
@@ -694,13 +1034,7 @@ Molecule::RingRange Molecule::rings() const
 {
     // only run ring perception if necessary
     if(!ringsPerceived()){
-        // find rings
-        foreach(const std::vector<Atom *> &ring, chemkit::algorithm::rppath(this)){
-            d->rings.push_back(new Ring(ring));
-        }
-
-        // set perceived to true
-        setRingsPerceived(true);
+        perceiveRings();
     }
 
     return boost::make_iterator_range(d->rings.begin(), d->rings.end());
@@ -720,10 +1054,19 @@ void Molecule::setRingsPerceived(bool perceived) const
 
     if(perceived == false){
         foreach(Ring *ring, d->rings){
-            delete ring;
+            ring->~Ring();
+            d->ringPool.deallocate(ring);
         }
 
         d->rings.clear();
+        d->atomRingOffsets.clear();
+        d->atomRings.clear();
+        d->atomSmallestRings.clear();
+        d->bondRingOffsets.clear();
+        d->bondRings.clear();
+        d->bondSmallestRings.clear();
+
+        setAromaticityPerceived(false);
     }
 
     d->ringsPerceived = perceived;
@@ -734,6 +1077,141 @@ bool Molecule::ringsPerceived() const
     return d->ringsPerceived;
 }
 
+void Molecule::perceiveRings() const
+{
+    // find rings
+    foreach(const std::vector<Atom *> &ring, chemkit::algorithm::rppath(this)){
+        d->rings.push_back(new(d->ringPool.allocate()) Ring(ring, d->rings.size()));
+    }
+
+    // find the atoms and bonds in each ring. a bond is in a ring
+    // if both of its atoms are in the ring.
+    std::vector<std::pair<size_t, Ring *> > atomMembers;
+    std::vector<std::pair<size_t, Ring *> > bondMembers;
+    std::vector<bool> inRing(m_atoms.size(), false);
+
+    foreach(Ring *ring, d->rings){
+        foreach(const Atom *atom, ring->m_atoms){
+            inRing[atom->m_index] = true;
+        }
+
+        foreach(const Atom *atom, ring->m_atoms){
+            atomMembers.push_back(std::make_pair(atom->m_index, ring));
+
+            foreach(const Bond *bond, d->atomBonds[atom->m_index]){
+                const Atom *neighbor = bond->otherAtom(atom);
+
+                if(inRing[neighbor->m_index] && atom->m_index < neighbor->m_index){
+                    bondMembers.push_back(std::make_pair(bond->m_index, ring));
+                }
+            }
+        }
+
+        foreach(const Atom *atom, ring->m_atoms){
+            inRing[atom->m_index] = false;
+        }
+    }
+
+    // build the ring membership lists for each atom and bond
+    buildRingIndex(atomMembers, m_atoms.size(), d->atomRingOffsets, d->atomRings, d->atomSmallestRings);
+    buildRingIndex(bondMembers, d->bonds.size(), d->bondRingOffsets, d->bondRings, d->bondSmallestRings);
+
+    setRingsPerceived(true);
+}
+
+void Molecule::setAromaticityPerceived(bool perceived) const
+{
+    d->aromaticityPerceived = perceived;
+}
+
+bool Molecule::aromaticityPerceived() const
+{
+    return d->aromaticityPerceived;
+}
+
+// Determines the aromaticity of every atom, bond and ring in the
+// molecule at once and stores the results in the aromatic bitsets.
+void Molecule::perceiveAromaticity() const
+{
+    const RingRange rings = this->rings();
+
+    d->aromaticAtoms = Bitset(m_atoms.size());
+    d->aromaticBonds = Bitset(d->bonds.size());
+    d->aromaticRings = Bitset(rings.size());
+
+    boost::scoped_ptr<AromaticityModel> model;
+    if(!d->aromaticityModel.empty()){
+        model.reset(AromaticityModel::create(d->aromaticityModel));
+    }
+
+    if(model){
+        model->setMolecule(this);
+
+        for(size_t i = 0; i < rings.size(); i++){
+            d->aromaticRings[i] = model->isAromatic(rings[i]);
+        }
+        for(size_t i = 0; i < m_atoms.size(); i++){
+            d->aromaticAtoms[i] = model->isAromatic(m_atoms[i]);
+        }
+        for(size_t i = 0; i < d->bonds.size(); i++){
+            d->aromaticBonds[i] = model->isAromatic(d->bonds[i]);
+        }
+    }
+    else{
+        for(size_t i = 0; i < rings.size(); i++){
+            d->aromaticRings[i] = rings[i]->isHuckelAromatic();
+        }
+
+        // atoms and bonds are aromatic if they are in an aromatic ring
+        for(size_t i = 0; i < m_atoms.size(); i++){
+            for(size_t j = d->atomRingOffsets[i]; j < d->atomRingOffsets[i+1]; j++){
+                if(d->aromaticRings[d->atomRings[j]->m_index]){
+                    d->aromaticAtoms[i] = true;
+                    break;
+                }
+            }
+        }
+        for(size_t i = 0; i < d->bonds.size(); i++){
+            for(size_t j = d->bondRingOffsets[i]; j < d->bondRingOffsets[i+1]; j++){
+                if(d->aromaticRings[d->bondRings[j]->m_index]){
+                    d->aromaticBonds[i] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    setAromaticityPerceived(true);
+}
+
+bool Molecule::isAromaticAtom(const Atom *atom) const
+{
+    if(!aromaticityPerceived()){
+        perceiveAromaticity();
+    }
+
+    // atoms added after aromaticity perception are not in a ring
+    return atom->m_index < d->aromaticAtoms.size() && d->aromaticAtoms[atom->m_index];
+}
+
+bool Molecule::isAromaticBond(const Bond *bond) const
+{
+    if(!aromaticityPerceived()){
+        perceiveAromaticity();
+    }
+
+    return d->aromaticBonds[bond->m_index];
+}
+
+bool Molecule::isAromaticRing(const Ring *ring) const
+{
+    if(!aromaticityPerceived()){
+        perceiveAromaticity();
+    }
+
+    return d->aromaticRings[ring->m_index];
+}
+
 // --- Fragment Perception-------------------------------------------------- //
 /// Returns the fragment at \p index.
 ///
@@ -787,13 +1265,10 @@ void Molecule::removeFragment(Fragment *fragment)
 
 Fragment* Molecule::fragmentForAtom(const Atom *atom) const
 {
-    foreach(Fragment *fragment, fragments()){
-        if(fragment->contains(atom)){
-            return fragment;
-        }
-    }
+    // ensure fragments have been perceived
+    fragments();
 
-    return 0;
+    return d->fragments[d->atomFragments[atom->m_index]];
 }
 
 void Molecule::setFragmentsPerceived(bool perceived) const
@@ -802,8 +1277,9 @@ void Molecule::setFragmentsPerceived(bool perceived) const
         return;
 
     if(!perceived){
-        foreach(const Fragment *fragment, d->fragments){
-            delete fragment;
+        foreach(Fragment *fragment, d->fragments){
+            fragment->~Fragment();
+            d->fragmentPool.deallocate(fragment);
         }
 
         d->fragments.clear();
@@ -817,55 +1293,119 @@ bool Molecule::fragmentsPerceived() const
     return d->fragmentsPerceived;
 }
 
+// Creates a fragment object for each set of connected atoms. The
+// fragment ids for each atom are kept up to date as atoms and bonds
+// are added and only need to be recalculated after a bond is removed.
 void Molecule::perceiveFragments() const
 {
-    if(isEmpty()){
-        // nothing to do
-        return;
+    std::vector<size_t> &ids = d->atomFragmentIds;
+
+    if(!d->fragmentIdsValid){
+        ids.resize(m_atoms.size());
+        for(size_t i = 0; i < ids.size(); i++){
+            ids[i] = i;
+        }
+
+        foreach(const Bond *bond, d->bonds){
+            size_t rootA = findFragmentId(ids, bond->atom1()->m_index);
+            size_t rootB = findFragmentId(ids, bond->atom2()->m_index);
+
+            ids[std::max(rootA, rootB)] = std::min(rootA, rootB);
+        }
+
+        d->fragmentIdsValid = true;
     }
 
-    // position of the next atom to root the depth-first search
-    size_t position = 0;
+    // number the fragments in order of their first atom
+    size_t fragmentCount = 0;
+    std::vector<size_t> fragmentForRoot(m_atoms.size(), size_t(-1));
+    d->atomFragments.resize(m_atoms.size());
 
-    // bitset marking each atom not visited yet
-    Bitset unvisited(m_atoms.size());
-    unvisited.set();
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        size_t root = findFragmentId(ids, i);
 
-    for(;;){
-        // bitset marking the atoms contained in the fragment
-        Bitset bitset(m_atoms.size());
+        if(fragmentForRoot[root] == size_t(-1)){
+            fragmentForRoot[root] = fragmentCount++;
+        }
 
-        // perform depth-first search
-        std::vector<const Atom *> row;
-        row.push_back(m_atoms[position]);
+        d->atomFragments[i] = fragmentForRoot[root];
+    }
 
-        while(!row.empty()){
-            std::vector<const Atom *> nextRow;
+    // build the list of atoms in each fragment
+    d->fragmentAtomOffsets.assign(fragmentCount + 1, 0);
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        d->fragmentAtomOffsets[d->atomFragments[i] + 1]++;
+    }
+    for(size_t i = 0; i < fragmentCount; i++){
+        d->fragmentAtomOffsets[i + 1] += d->fragmentAtomOffsets[i];
+    }
 
-            foreach(const Atom *atom, row){
-                bitset.set(atom->index());
-                unvisited.set(atom->index(), false);
+    std::vector<size_t> position(d->fragmentAtomOffsets.begin(), d->fragmentAtomOffsets.end() - 1);
+    d->fragmentAtoms.resize(m_atoms.size());
+    for(size_t i = 0; i < m_atoms.size(); i++){
+        d->fragmentAtoms[position[d->atomFragments[i]]++] = i;
+    }
 
-                foreach(const Atom *neighbor, atom->neighbors()){
-                    if(unvisited[neighbor->index()]){
-                        nextRow.push_back(neighbor);
-                    }
-                }
-            }
+    // create the fragment objects
+    d->fragments.reserve(fragmentCount);
+    for(size_t i = 0; i < fragmentCount; i++){
+        d->fragments.push_back(new(d->fragmentPool.allocate()) Fragment(const_cast<Molecule *>(this), i));
+    }
+}
 
-            row = nextRow;
-        }
+// --- Aromaticity Perception -------------------------------------------- //
+/// Sets the aromaticity model used to determine which atoms, bonds
+/// and rings in the molecule are aromatic to \p name (e.g.
+/// "daylight" or "mmff").
+///
+/// By default (or if \p name is empty) rings are aromatic if they are
+/// planar and satisfy Huckel's rule, and atoms and bonds are aromatic
+/// if they are in an aromatic ring.
+///
+/// \see AromaticityModel, Ring::isAromatic()
+void Molecule::setAromaticityModel(const std::string &name)
+{
+    if(name == d->aromaticityModel){
+        return;
+    }
 
-        // create and add fragment
-        Fragment *fragment = new Fragment(const_cast<Molecule *>(this), bitset);
-        d->fragments.push_back(fragment);
+    d->aromaticityModel = name;
+    setAromaticityPerceived(false);
+    d->version++;
+}
 
-        // find next unvisited atom
-        position = unvisited.find_next(position);
-        if(position == Bitset::npos){
-            break;
-        }
+/// Returns the name of the aromaticity model for the molecule.
+std::string Molecule::aromaticityModel() const
+{
+    return d->aromaticityModel;
+}
+
+// --- Topology ------------------------------------------------------------ //
+/// Returns the topological distance matrix for the molecule.
+///
+/// The matrix is calculated the first time it is requested and is
+/// shared by all later calls until an atom or bond is added to or
+/// removed from the molecule. The returned pointer is only valid
+/// until then.
+///
+/// The matrix uses two bytes for every pair of atoms and is kept in
+/// memory while the molecule is unchanged. Use
+/// TopologicalDistanceMatrix::eccentricities() if only the graph
+/// radius or diameter is needed.
+///
+/// For example, to find the number of bonds between two atoms:
+/// \code
+/// int distance = molecule->topologicalDistanceMatrix()->distance(a->index(), b->index());
+/// \endcode
+///
+/// \see TopologicalDistanceMatrix
+const TopologicalDistanceMatrix* Molecule::topologicalDistanceMatrix() const
+{
+    if(!d->topologicalDistanceMatrix){
+        d->topologicalDistanceMatrix.reset(new TopologicalDistanceMatrix(this));
     }
+
+    return d->topologicalDistanceMatrix.get();
 }
 
 // --- Coordinates --------------------------------------------------------- //
@@ -905,6 +1445,7 @@ CartesianCoordinates* Molecule::coordinates() const
 void Molecule::addCoordinateSet(const boost::shared_ptr<CoordinateSet> &coordinates)
 {
     d->coordinateSets.push_back(coordinates);
+    d->version++;
 }
 
 /// Add a new coordinate set containing \p coordinates.
@@ -936,6 +1477,7 @@ bool Molecule::removeCoordinateSet(const boost::shared_ptr<CoordinateSet> &coord
 
     if(iter != d->coordinateSets.end()){
         d->coordinateSets.erase(iter);
+        d->version++;
         return true;
     }
 
@@ -1076,30 +1618,38 @@ Molecule& Molecule::operator=(const Molecule &molecule)
         // clear current molecule
         clear();
 
-        // set new name
-        setName(molecule.name());
+        // copy atoms and bonds
+        copyStructure(molecule);
+        notifyWatchers(MoleculeWatcher::NameChanged);
+    }
 
-        std::map<const Atom *, Atom *> oldToNew;
+    return *this;
+}
 
-        // add new atoms
-        foreach(const Atom *atom, molecule.atoms()){
-            Atom *newAtom = addAtomCopy(atom);
-            oldToNew[atom] = newAtom;
-        }
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+Molecule& Molecule::operator=(Molecule &&molecule)
+{
+    if(this != &molecule){
+        // clear current molecule
+        clear();
 
-        // add new bonds
-        foreach(const Bond *bond, molecule.bonds()){
-            Bond *newBond = addBond(oldToNew[bond->atom1()], oldToNew[bond->atom2()]);
-            newBond->setOrder(bond->order());
+        // take atoms and bonds, leaving the other molecule empty
+        swapStructure(molecule);
+        notifyWatchers(MoleculeWatcher::NameChanged);
 
-            if(bond->stereochemistry() != Stereochemistry::None){
-                newBond->setStereochemistry(bond->stereochemistry());
+        if(!d->watchers.empty()){
+            foreach(const Atom *atom, m_atoms){
+                notifyWatchers(atom, MoleculeWatcher::AtomAdded);
+            }
+            foreach(const Bond *bond, d->bonds){
+                notifyWatchers(bond, MoleculeWatcher::BondAdded);
             }
         }
     }
 
     return *this;
 }
+#endif
 
 /// Returns the atom at \p index in the molecule.
 ///
@@ -1115,6 +1665,8 @@ Atom* Molecule::operator[](size_t index) const
 // --- Internal Methods ---------------------------------------------------- //
 void Molecule::notifyWatchers(MoleculeWatcher::ChangeType type)
 {
+    d->version++;
+
     foreach(MoleculeWatcher *watcher, d->watchers){
         watcher->moleculeChanged(this, type);
     }
@@ -1122,6 +1674,12 @@ void Molecule::notifyWatchers(MoleculeWatcher::ChangeType type)
 
 void Molecule::notifyWatchers(const Atom *atom, MoleculeWatcher::ChangeType type)
 {
+    d->version++;
+
+    if(type == MoleculeWatcher::AtomAdded || type == MoleculeWatcher::AtomRemoved){
+        d->topologicalDistanceMatrix.reset();
+    }
+
     foreach(MoleculeWatcher *watcher, d->watchers){
         watcher->atomChanged(atom, type);
     }
@@ -1129,6 +1687,12 @@ void Molecule::notifyWatchers(const Atom *atom, MoleculeWatcher::ChangeType type
 
 void Molecule::notifyWatchers(const Bond *bond, MoleculeWatcher::ChangeType type)
 {
+    d->version++;
+
+    if(type == MoleculeWatcher::BondAdded || type == MoleculeWatcher::BondRemoved){
+        d->topologicalDistanceMatrix.reset();
+    }
+
     foreach(MoleculeWatcher *watcher, d->watchers){
         watcher->bondChanged(bond, type);
     }
@@ -1153,4 +1717,136 @@ Stereochemistry* Molecule::stereochemistry()
     return m_stereochemistry;
 }
 
+// Copies the atoms and bonds from molecule into this molecule. This
+// molecule must be empty. The atom and bond arrays are copied by index
+// so no atom to atom lookups are needed.
+void Molecule::copyStructure(const Molecule &molecule)
+{
+    d->name = molecule.d->name;
+    d->version++;
+    d->topologicalDistanceMatrix.reset();
+
+    // copy atoms
+    size_t atomCount = molecule.m_atoms.size();
+    d->atomPool.reserve(atomCount);
+    m_atoms.reserve(atomCount);
+    for(size_t i = 0; i < atomCount; i++){
+        m_atoms.push_back(new(d->atomPool.allocate()) Atom(this, i));
+    }
+
+    m_elements = molecule.m_elements;
+    d->partialCharges = molecule.d->partialCharges;
+    d->atomBonds.assign(atomCount, std::vector<Bond *>());
+
+    std::map<const Atom *, Isotope>::const_iterator isotope;
+    for(isotope = molecule.d->isotopes.begin(); isotope != molecule.d->isotopes.end(); ++isotope){
+        d->isotopes[m_atoms[isotope->first->index()]] = isotope->second;
+    }
+
+    // copy bonds
+    size_t bondCount = molecule.d->bonds.size();
+    d->bondPool.reserve(bondCount);
+    d->bonds.reserve(bondCount);
+    d->bondAtoms.reserve(bondCount);
+    for(size_t i = 0; i < bondCount; i++){
+        Bond *bond = new(d->bondPool.allocate()) Bond(this, i);
+        Atom *a = m_atoms[molecule.d->bondAtoms[i].first->index()];
+        Atom *b = m_atoms[molecule.d->bondAtoms[i].second->index()];
+
+        d->bonds.push_back(bond);
+        d->bondAtoms.push_back(std::make_pair(a, b));
+        d->atomBonds[a->index()].push_back(bond);
+        d->atomBonds[b->index()].push_back(bond);
+    }
+
+    d->bondOrders = molecule.d->bondOrders;
+    d->fragmentIdsValid = false;
+
+    // copy coordinates
+    if(molecule.m_coordinates || !molecule.d->coordinateSets.empty()){
+        const CartesianCoordinates *sourceCoordinates = molecule.coordinates();
+
+        if(m_coordinates){
+            m_coordinates->resize(atomCount);
+            for(size_t i = 0; i < atomCount; i++){
+                m_coordinates->setPosition(i, sourceCoordinates->position(i));
+            }
+        }
+        else{
+            m_coordinates = new CartesianCoordinates(*sourceCoordinates);
+            d->coordinateSets.push_back(boost::make_shared<CoordinateSet>(m_coordinates));
+        }
+    }
+    else if(m_coordinates){
+        // keep one coordinate for each atom so that atoms added
+        // later are given the correct coordinate
+        m_coordinates->resize(0);
+        for(size_t i = 0; i < atomCount; i++){
+            m_coordinates->append(0, 0, 0);
+        }
+    }
+
+    // copy stereochemistry
+    if(molecule.m_stereochemistry){
+        const Stereochemistry *sourceStereochemistry = molecule.m_stereochemistry;
+
+        for(size_t i = 0; i < atomCount; i++){
+            Stereochemistry::Type type = sourceStereochemistry->stereochemistry(molecule.m_atoms[i]);
+            if(type != Stereochemistry::None){
+                stereochemistry()->setStereochemistry(m_atoms[i], type);
+            }
+        }
+
+        for(size_t i = 0; i < bondCount; i++){
+            Stereochemistry::Type type = sourceStereochemistry->stereochemistry(molecule.d->bonds[i]);
+            if(type != Stereochemistry::None){
+                stereochemistry()->setStereochemistry(d->bonds[i], type);
+            }
+        }
+    }
+
+    // only notify watchers when the molecule is being assigned to
+    if(!d->watchers.empty()){
+        foreach(const Atom *atom, m_atoms){
+            notifyWatchers(atom, MoleculeWatcher::AtomAdded);
+        }
+        foreach(const Bond *bond, d->bonds){
+            notifyWatchers(bond, MoleculeWatcher::BondAdded);
+        }
+    }
+}
+
+// Exchanges the atoms, bonds and other contents of this molecule with
+// those in molecule. Each molecule keeps its own watchers.
+void Molecule::swapStructure(Molecule &molecule)
+{
+    std::swap(d, molecule.d);
+    std::swap(d->watchers, molecule.d->watchers);
+    m_atoms.swap(molecule.m_atoms);
+    m_elements.swap(molecule.m_elements);
+    std::swap(m_coordinates, molecule.m_coordinates);
+    std::swap(m_stereochemistry, molecule.m_stereochemistry);
+
+    updateOwnership();
+    molecule.updateOwnership();
+}
+
+// Points each of the objects contained in the molecule back to it.
+void Molecule::updateOwnership()
+{
+    foreach(Atom *atom, m_atoms){
+        atom->m_molecule = this;
+    }
+    foreach(Bond *bond, d->bonds){
+        bond->m_molecule = this;
+    }
+    foreach(Fragment *fragment, d->fragments){
+        fragment->m_molecule = this;
+    }
+
+    if(m_stereochemistry){
+        m_stereochemistry->m_molecule = this;
+    }
+}
+
 } // end chemkit namespace
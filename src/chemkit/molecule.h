@@ -43,6 +43,7 @@
 #include <vector>
 
 #ifndef Q_MOC_RUN
+#include <boost/config.hpp>
 #include <boost/range/iterator_range.hpp>
 #endif
 
@@ -63,6 +64,8 @@ class Fragment;
 class MoleculePrivate;
 class MoleculeWatcher;
 class Stereochemistry;
+class SubstructureTarget;
+class TopologicalDistanceMatrix;
 class DiagramCoordinates;
 class InternalCoordinates;
 class CartesianCoordinates;
@@ -81,6 +84,9 @@ public:
     Molecule();
     Molecule(const std::string &formula, const std::string &format);
     Molecule(const Molecule &molecule);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    Molecule(Molecule &&molecule);
+#endif
     virtual ~Molecule();
 
     // properties
@@ -90,6 +96,11 @@ public:
     std::string formula(const std::string &format) const;
     Variant descriptor(const std::string &name) const;
     Bitset fingerprint(const std::string &name) const;
+    void setResultCacheEnabled(bool enabled);
+    bool isResultCacheEnabled() const;
+    void clearResultCache();
+    size_t resultCacheHitCount() const;
+    size_t resultCacheMissCount() const;
     inline size_t size() const;
     inline bool isEmpty() const;
     Real mass() const;
@@ -141,6 +152,13 @@ public:
     bool isFragmented() const;
     void removeFragment(Fragment *fragment);
 
+    // aromaticity perception
+    void setAromaticityModel(const std::string &name);
+    std::string aromaticityModel() const;
+
+    // topology
+    const TopologicalDistanceMatrix* topologicalDistanceMatrix() const;
+
     // coordinates
     CartesianCoordinates* coordinates() const;
     void addCoordinateSet(const boost::shared_ptr<CoordinateSet> &coordinates);
@@ -165,29 +183,45 @@ public:
 
     // operators
     Molecule& operator=(const Molecule &molecule);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    Molecule& operator=(Molecule &&molecule);
+#endif
     Atom* operator[](size_t index) const;
 
 private:
     // internal methods
     void setRingsPerceived(bool perceived) const;
     bool ringsPerceived() const;
+    void perceiveRings() const;
     void setFragmentsPerceived(bool perceived) const;
     bool fragmentsPerceived() const;
     void perceiveFragments() const;
     Fragment* fragmentForAtom(const Atom *atom) const;
+    void setAromaticityPerceived(bool perceived) const;
+    bool aromaticityPerceived() const;
+    void perceiveAromaticity() const;
+    bool isAromaticAtom(const Atom *atom) const;
+    bool isAromaticBond(const Bond *bond) const;
+    bool isAromaticRing(const Ring *ring) const;
     void notifyWatchers(MoleculeWatcher::ChangeType type);
     void notifyWatchers(const Atom *atom, MoleculeWatcher::ChangeType type);
     void notifyWatchers(const Bond *bond, MoleculeWatcher::ChangeType type);
     void addWatcher(MoleculeWatcher *watcher) const;
     void removeWatcher(MoleculeWatcher *watcher) const;
     Stereochemistry* stereochemistry();
+    void copyStructure(const Molecule &molecule);
+    void swapStructure(Molecule &molecule);
+    void updateOwnership();
 
     friend class Atom;
     friend class Bond;
+    friend class Ring;
+    friend class Fragment;
     friend class MoleculeWatcher;
+    friend class SubstructureTarget;
 
 private:
-    MoleculePrivate* const d;
+    MoleculePrivate *d;
     std::vector<Atom *> m_atoms;
     std::vector<Element> m_elements;
     mutable CartesianCoordinates *m_coordinates;
@@ -0,0 +1,100 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_MOLECULEHASH_INLINE_H
+#define CHEMKIT_MOLECULEHASH_INLINE_H
+
+#include "moleculehash.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the 64-bit hash value. This is the same as low().
+inline boost::uint64_t MoleculeHash::value() const
+{
+    return m_low;
+}
+
+/// Returns the upper 64 bits of the 128-bit hash.
+inline boost::uint64_t MoleculeHash::high() const
+{
+    return m_high;
+}
+
+/// Returns the lower 64 bits of the 128-bit hash.
+inline boost::uint64_t MoleculeHash::low() const
+{
+    return m_low;
+}
+
+/// Returns \c true if the hash is null (was not calculated for a
+/// molecule).
+inline bool MoleculeHash::isNull() const
+{
+    return m_high == 0 && m_low == 0;
+}
+
+// --- Operators ----------------------------------------------------------- //
+/// Returns \c true if the hash is equal to \p other.
+inline bool MoleculeHash::operator==(const MoleculeHash &other) const
+{
+    return m_low == other.m_low && m_high == other.m_high;
+}
+
+/// Returns \c true if the hash is not equal to \p other.
+inline bool MoleculeHash::operator!=(const MoleculeHash &other) const
+{
+    return !(*this == other);
+}
+
+/// Returns \c true if the hash is less than \p other.
+inline bool MoleculeHash::operator<(const MoleculeHash &other) const
+{
+    return m_high < other.m_high || (m_high == other.m_high && m_low < other.m_low);
+}
+
+/// Returns a hash value for \p hash. This allows MoleculeHash objects
+/// to be stored in \c boost::unordered_set and \c boost::unordered_map.
+///
+/// \related MoleculeHash
+inline std::size_t hash_value(const MoleculeHash &hash)
+{
+    return static_cast<std::size_t>(hash.low());
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_MOLECULEHASH_INLINE_H
@@ -0,0 +1,412 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "moleculehash.h"
+
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#include "atom.h"
+#include "bond.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculeview.h"
+#include "stereoparity.h"
+#include "canonicalranker.h"
+
+namespace chemkit {
+
+namespace {
+
+// Initial values for the two halves of the hash.
+const boost::uint64_t HighSeed = 0x6a09e667f3bcc908ULL;
+const boost::uint64_t LowSeed = 0xbb67ae8584caa73bULL;
+
+// Mixes the bits of x (the finalizer from MurmurHash3).
+inline boost::uint64_t mix(boost::uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+
+    return x;
+}
+
+// Adds value to the hash. The two halves are combined differently so
+// that they are independent of each other.
+inline void combine(boost::uint64_t &high, boost::uint64_t &low, boost::uint64_t value)
+{
+    low = mix(low ^ value);
+    high = mix(high + value * 0x9e3779b97f4a7c15ULL);
+}
+
+// Refines the labels of the atoms with the labels of their neighbors
+// until the number of distinct labels stops increasing. Returns the
+// number of distinct labels.
+size_t refineLabels(const MoleculeView &view,
+                    const std::vector<size_t> &atoms,
+                    const std::vector<bool> &folded,
+                    const std::vector<boost::uint64_t> &bondCodes,
+                    std::vector<boost::uint64_t> &labels)
+{
+    std::vector<boost::uint64_t> nextLabels(labels.size());
+    std::vector<boost::uint64_t> neighborLabels;
+    std::vector<boost::uint64_t> sortedLabels;
+    size_t count = 0;
+
+    for(;;){
+        foreach(size_t i, atoms){
+            neighborLabels.clear();
+
+            foreach(size_t bond, view.bonds(i)){
+                size_t neighbor = view.otherAtom(bond, i);
+
+                if(!folded[neighbor]){
+                    neighborLabels.push_back(mix(labels[neighbor] ^ bondCodes[bond]));
+                }
+            }
+
+            std::sort(neighborLabels.begin(), neighborLabels.end());
+
+            boost::uint64_t label = labels[i];
+            foreach(boost::uint64_t neighborLabel, neighborLabels){
+                label = mix(label + neighborLabel);
+            }
+
+            nextLabels[i] = label;
+        }
+
+        labels.swap(nextLabels);
+
+        sortedLabels.clear();
+        foreach(size_t i, atoms){
+            sortedLabels.push_back(labels[i]);
+        }
+
+        std::sort(sortedLabels.begin(), sortedLabels.end());
+        size_t refinedCount = std::unique(sortedLabels.begin(), sortedLabels.end()) - sortedLabels.begin();
+        if(refinedCount <= count){
+            return count;
+        }
+
+        count = refinedCount;
+    }
+}
+
+} // end anonymous namespace
+
+// === MoleculeHash ======================================================== //
+/// \class MoleculeHash moleculehash.h chemkit/moleculehash.h
+/// \ingroup chemkit
+/// \brief The MoleculeHash class contains a structural hash for a
+///        molecule.
+///
+/// The hash is a 128-bit value calculated from the atoms and bonds
+/// of the molecule. It does not depend on the order of the atoms and
+/// bonds, so two molecules with the same structure always have the
+/// same hash. Elements, mass numbers, formal charges, aromaticity and
+/// bond orders are included in the hash. Atom and bond stereochemistry
+/// is included if the IncludeStereochemistry flag is set. It is added
+/// as a parity relative to the neighbors of each atom and bond so that
+/// it does not depend on the order the neighbors are stored in.
+///
+/// The hash is calculated by iteratively refining a label for each
+/// atom with the labels of its neighbors and then combining the
+/// sorted labels. It is much cheaper to calculate than a canonical
+/// line format such as InChIKey, which makes it suitable for removing
+/// duplicates from large sets of molecules.
+///
+/// Different molecules can have the same hash. The verify() method
+/// can be used to check that two molecules with the same hash have
+/// the same structure.
+///
+/// For example, to check if two molecules have the same structure:
+/// \code
+/// if(MoleculeHash(a) == MoleculeHash(b) && MoleculeHash::verify(a, b)){
+///     // a and b are the same
+/// }
+/// \endcode
+///
+/// \see CanonicalRanker
+
+/// \enum MoleculeHash::Flag
+/// Flags for the hash calculation:
+///     - \c DefaultFlags
+///     - \c IncludeStereochemistry
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, null hash.
+MoleculeHash::MoleculeHash()
+    : m_high(0),
+      m_low(0)
+{
+}
+
+/// Creates a new hash for \p molecule.
+MoleculeHash::MoleculeHash(const Molecule *molecule, int flags)
+    : m_high(HighSeed),
+      m_low(LowSeed)
+{
+    MoleculeView view(molecule);
+    size_t size = view.size();
+    bool stereochemistry = flags & IncludeStereochemistry;
+
+    // terminal hydrogens are folded into the label of their neighbor
+    // and are not refined themselves
+    std::vector<size_t> atoms;
+    std::vector<bool> folded(size, false);
+    atoms.reserve(size);
+
+    for(size_t i = 0; i < size; i++){
+        if(view.isTerminalHydrogen(i) && !view.is(*view.neighbors(i).begin(), Atom::Hydrogen)){
+            folded[i] = true;
+        }
+        else{
+            atoms.push_back(i);
+        }
+    }
+
+    // initial atom labels from the element, mass number, formal
+    // charge and aromaticity of each atom along with the number and
+    // mass numbers of its terminal hydrogens
+    std::vector<boost::uint64_t> labels(size);
+
+    foreach(size_t i, atoms){
+        const Atom *atom = molecule->atom(i);
+
+        size_t hydrogenCount = 0;
+        size_t hydrogenMass = 0;
+        foreach(size_t neighbor, view.neighbors(i)){
+            if(folded[neighbor]){
+                hydrogenCount++;
+                hydrogenMass += molecule->atom(neighbor)->massNumber();
+            }
+        }
+
+        boost::uint64_t label = view.atomicNumber(i);
+        label |= boost::uint64_t(atom->massNumber() & 0xffff) << 8;
+        label |= boost::uint64_t((atom->formalCharge() + 128) & 0xff) << 24;
+        label |= boost::uint64_t(atom->isAromatic()) << 32;
+        label |= boost::uint64_t(hydrogenCount & 0xff) << 40;
+
+        labels[i] = mix(mix(label) + hydrogenMass);
+    }
+
+    // bond codes from the bond order. aromatic bonds get their own
+    // code so that different kekule structures give the same hash
+    std::vector<boost::uint64_t> bondCodes(view.bondCount());
+
+    for(size_t i = 0; i < view.bondCount(); i++){
+        const Bond *bond = molecule->bond(i);
+
+        boost::uint64_t code = bond->isAromatic() ? 0x100 : view.bondOrder(i);
+
+        bondCodes[i] = mix(code + LowSeed);
+    }
+
+    size_t count = refineLabels(view, atoms, folded, bondCodes, labels);
+
+    // the stored stereochemistry depends on the order of the atoms so
+    // it is added as a parity relative to the refined labels of the
+    // neighbors and the labels are refined again until no more atoms
+    // are split
+    if(stereochemistry){
+        std::vector<int> atomParities(size);
+        std::vector<boost::uint64_t> stereoBondCodes(view.bondCount());
+
+        for(;;){
+            foreach(size_t i, atoms){
+                atomParities[i] = algorithm::atomParity(molecule->atom(i), labels);
+            }
+
+            for(size_t i = 0; i < view.bondCount(); i++){
+                int parity = algorithm::bondParity(molecule->bond(i), labels);
+
+                stereoBondCodes[i] = mix(bondCodes[i] + parity);
+            }
+
+            foreach(size_t i, atoms){
+                labels[i] = mix(labels[i] + atomParities[i]);
+            }
+
+            size_t stereoCount = refineLabels(view, atoms, folded, stereoBondCodes, labels);
+            if(stereoCount <= count){
+                break;
+            }
+
+            count = stereoCount;
+        }
+    }
+
+    std::vector<boost::uint64_t> sortedLabels;
+
+    // combine the sorted labels
+    sortedLabels.clear();
+    foreach(size_t i, atoms){
+        sortedLabels.push_back(labels[i]);
+    }
+
+    std::sort(sortedLabels.begin(), sortedLabels.end());
+
+    combine(m_high, m_low, size);
+    combine(m_high, m_low, view.bondCount());
+
+    foreach(boost::uint64_t label, sortedLabels){
+        combine(m_high, m_low, label);
+    }
+}
+
+/// Creates a new hash from the \p high and \p low 64-bit values.
+MoleculeHash::MoleculeHash(boost::uint64_t high, boost::uint64_t low)
+    : m_high(high),
+      m_low(low)
+{
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the hash as a string of 32 hexadecimal digits.
+std::string MoleculeHash::toString() const
+{
+    std::stringstream stream;
+    stream << std::hex << std::setfill('0')
+           << std::setw(16) << m_high
+           << std::setw(16) << m_low;
+
+    return stream.str();
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Returns the canonical form of \p molecule.
+///
+/// The canonical form lists the atom and bond counts, then each atom's
+/// element, mass number, formal charge and aromaticity in canonical
+/// order, and then the sorted bonds with their atoms replaced by their
+/// canonical ranks. The atoms are ranked with the CanonicalRanker. If
+/// \p flags contains \c IncludeStereochemistry the parity of each
+/// atom and bond is also included.
+///
+/// Two molecules have equal canonical forms if and only if they have
+/// the same structure. When one molecule is compared with many others
+/// it is faster to calculate its canonical form once than to call
+/// verify() for each comparison.
+std::vector<boost::uint64_t> MoleculeHash::canonicalForm(const Molecule *molecule, int flags)
+{
+    bool stereochemistry = flags & IncludeStereochemistry;
+
+    std::vector<boost::uint64_t> form;
+    form.reserve(2 + molecule->atomCount() + molecule->bondCount());
+    form.push_back(molecule->atomCount());
+    form.push_back(molecule->bondCount());
+
+    if(molecule->isEmpty()){
+        return form;
+    }
+
+    CanonicalRanker ranker(molecule, stereochemistry ? CanonicalRanker::IncludeStereochemistry :
+                                                       CanonicalRanker::DefaultFlags);
+
+    // the stereochemistry is included as a parity relative to the
+    // symmetry classes of the neighbors
+    std::vector<size_t> classes(molecule->atomCount());
+    for(size_t i = 0; i < classes.size(); i++){
+        classes[i] = ranker.symmetryClass(i);
+    }
+
+    foreach(size_t index, ranker.order()){
+        const Atom *atom = molecule->atom(index);
+
+        boost::uint64_t value = atom->atomicNumber();
+        value |= boost::uint64_t(atom->massNumber() & 0xffff) << 8;
+        value |= boost::uint64_t((atom->formalCharge() + 128) & 0xff) << 24;
+        value |= boost::uint64_t(atom->isAromatic()) << 32;
+
+        if(stereochemistry){
+            value |= boost::uint64_t(algorithm::atomParity(atom, classes)) << 36;
+        }
+
+        form.push_back(value);
+    }
+
+    boost::uint64_t size = molecule->atomCount();
+    size_t bondsBegin = form.size();
+
+    foreach(const Bond *bond, molecule->bonds()){
+        boost::uint64_t a = ranker.rank(bond->atom1());
+        boost::uint64_t b = ranker.rank(bond->atom2());
+
+        if(b < a){
+            std::swap(a, b);
+        }
+
+        // aromatic bonds get their own code so that different kekule
+        // structures are the same
+        boost::uint64_t code = bond->isAromatic() ? 0x100 : bond->order();
+
+        if(stereochemistry){
+            code |= boost::uint64_t(algorithm::bondParity(bond, classes)) << 12;
+        }
+
+        form.push_back(((a * size + b) << 16) | code);
+    }
+
+    std::sort(form.begin() + bondsBegin, form.end());
+
+    return form;
+}
+
+/// Returns \c true if molecules \p a and \p b have the same structure.
+///
+/// The canonical forms of the molecules are compared (see
+/// canonicalForm()). Atom and bond stereochemistry is also compared if
+/// \p flags contains \c IncludeStereochemistry. This is much slower
+/// than comparing hashes and is intended to confirm that two molecules
+/// with the same hash are actually the same.
+bool MoleculeHash::verify(const Molecule *a, const Molecule *b, int flags)
+{
+    if(a->atomCount() != b->atomCount() || a->bondCount() != b->bondCount()){
+        return false;
+    }
+    else if(a->isEmpty()){
+        return true;
+    }
+
+    return canonicalForm(a, flags) == canonicalForm(b, flags);
+}
+
+} // end chemkit namespace
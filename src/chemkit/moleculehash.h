@@ -0,0 +1,94 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_MOLECULEHASH_H
+#define CHEMKIT_MOLECULEHASH_H
+
+#include "chemkit.h"
+
+#include <string>
+#include <vector>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+namespace chemkit {
+
+class Molecule;
+
+class CHEMKIT_EXPORT MoleculeHash
+{
+public:
+    // enumerations
+    enum Flag {
+        DefaultFlags = 0x00,
+        IncludeStereochemistry = 0x01
+    };
+
+    // construction and destruction
+    MoleculeHash();
+    MoleculeHash(const Molecule *molecule, int flags = DefaultFlags);
+    MoleculeHash(boost::uint64_t high, boost::uint64_t low);
+
+    // properties
+    inline boost::uint64_t value() const;
+    inline boost::uint64_t high() const;
+    inline boost::uint64_t low() const;
+    inline bool isNull() const;
+    std::string toString() const;
+
+    // operators
+    inline bool operator==(const MoleculeHash &other) const;
+    inline bool operator!=(const MoleculeHash &other) const;
+    inline bool operator<(const MoleculeHash &other) const;
+
+    // static methods
+    static std::vector<boost::uint64_t> canonicalForm(const Molecule *molecule, int flags = DefaultFlags);
+    static bool verify(const Molecule *a, const Molecule *b, int flags = DefaultFlags);
+
+private:
+    boost::uint64_t m_high;
+    boost::uint64_t m_low;
+};
+
+inline std::size_t hash_value(const MoleculeHash &hash);
+
+} // end chemkit namespace
+
+#include "moleculehash-inline.h"
+
+#endif // CHEMKIT_MOLECULEHASH_H
@@ -42,10 +42,21 @@
 #include <string>
 #include <vector>
 
+#ifndef Q_MOC_RUN
+#include <boost/scoped_ptr.hpp>
+#endif
+
+#include "atom.h"
 #include "bond.h"
+#include "ring.h"
+#include "bitset.h"
 #include "point3.h"
 #include "isotope.h"
+#include "variant.h"
+#include "fragment.h"
+#include "objectpool.h"
 #include "variantmap.h"
+#include "topologicaldistancematrix.h"
 
 namespace chemkit {
 
@@ -67,7 +78,25 @@ public:
     std::vector<Ring *> rings;
     bool fragmentsPerceived;
     std::vector<Fragment *> fragments;
+    bool fragmentIdsValid;
+    std::vector<size_t> atomFragmentIds;
+    std::vector<size_t> atomFragments;
+    std::vector<size_t> fragmentAtomOffsets;
+    std::vector<size_t> fragmentAtoms;
+    bool aromaticityPerceived;
+    std::string aromaticityModel;
+    Bitset aromaticAtoms;
+    Bitset aromaticBonds;
+    Bitset aromaticRings;
     std::vector<MoleculeWatcher *> watchers;
+    size_t version;
+    bool resultCacheEnabled;
+    size_t resultCacheHitCount;
+    size_t resultCacheMissCount;
+    std::map<std::string, std::pair<size_t, Variant> > descriptorCache;
+    std::map<std::string, std::pair<size_t, Bitset> > fingerprintCache;
+    std::pair<size_t, Bitset> substructureScreenCache[4];
+    boost::scoped_ptr<TopologicalDistanceMatrix> topologicalDistanceMatrix;
     VariantMap data;
     std::map<const Atom *, Isotope> isotopes;
     std::vector<std::string> atomTypes;
@@ -76,6 +105,16 @@ public:
     std::vector<std::vector<Bond *> > atomBonds;
     std::vector<Bond::BondOrderType> bondOrders;
     std::vector<boost::shared_ptr<CoordinateSet> > coordinateSets;
+    std::vector<size_t> atomRingOffsets;
+    std::vector<Ring *> atomRings;
+    std::vector<Ring *> atomSmallestRings;
+    std::vector<size_t> bondRingOffsets;
+    std::vector<Ring *> bondRings;
+    std::vector<Ring *> bondSmallestRings;
+    ObjectPool<Atom> atomPool;
+    ObjectPool<Bond> bondPool;
+    ObjectPool<Ring> ringPool;
+    ObjectPool<Fragment> fragmentPool;
 };
 
 } // end chemkit namespace
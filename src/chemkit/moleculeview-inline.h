@@ -0,0 +1,141 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_MOLECULEVIEW_INLINE_H
+#define CHEMKIT_MOLECULEVIEW_INLINE_H
+
+#include "moleculeview.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the molecule the view was built from.
+inline const Molecule* MoleculeView::molecule() const
+{
+    return m_molecule;
+}
+
+/// Returns the number of atoms in the view.
+inline size_t MoleculeView::size() const
+{
+    return atomCount();
+}
+
+/// Returns \c true if the view contains no atoms.
+inline bool MoleculeView::isEmpty() const
+{
+    return m_atomicNumbers.empty();
+}
+
+// --- Atoms --------------------------------------------------------------- //
+/// Returns the number of atoms in the view.
+inline size_t MoleculeView::atomCount() const
+{
+    return m_atomicNumbers.size();
+}
+
+/// Returns the atomic number of the atom at index \p atom.
+inline Element::AtomicNumberType MoleculeView::atomicNumber(size_t atom) const
+{
+    return m_atomicNumbers[atom];
+}
+
+/// Returns \c true if the atom at index \p atom is of \p element.
+inline bool MoleculeView::is(size_t atom, const Element &element) const
+{
+    return m_atomicNumbers[atom] == element.atomicNumber();
+}
+
+/// Returns the number of neighbors of the atom at index \p atom.
+inline size_t MoleculeView::neighborCount(size_t atom) const
+{
+    return m_offsets[atom + 1] - m_offsets[atom];
+}
+
+/// Returns a range containing the indices of the atoms bonded to
+/// the atom at index \p atom.
+inline MoleculeView::IndexRange MoleculeView::neighbors(size_t atom) const
+{
+    return boost::make_iterator_range(m_neighbors.begin() + m_offsets[atom],
+                                      m_neighbors.begin() + m_offsets[atom + 1]);
+}
+
+/// Returns a range containing the indices of the bonds to the atom
+/// at index \p atom. The bond at each position corresponds to the
+/// neighbor at the same position in neighbors().
+inline MoleculeView::IndexRange MoleculeView::bonds(size_t atom) const
+{
+    return boost::make_iterator_range(m_neighborBonds.begin() + m_offsets[atom],
+                                      m_neighborBonds.begin() + m_offsets[atom + 1]);
+}
+
+// --- Bonds --------------------------------------------------------------- //
+/// Returns the number of bonds in the view.
+inline size_t MoleculeView::bondCount() const
+{
+    return m_bondOrders.size();
+}
+
+/// Returns the index of the first atom in the bond at index \p bond.
+inline size_t MoleculeView::bondAtom1(size_t bond) const
+{
+    return m_bondAtoms[2 * bond];
+}
+
+/// Returns the index of the second atom in the bond at index
+/// \p bond.
+inline size_t MoleculeView::bondAtom2(size_t bond) const
+{
+    return m_bondAtoms[2 * bond + 1];
+}
+
+/// Returns the index of the atom in \p bond that is not \p atom.
+inline size_t MoleculeView::otherAtom(size_t bond, size_t atom) const
+{
+    size_t a = m_bondAtoms[2 * bond];
+
+    return a == atom ? m_bondAtoms[2 * bond + 1] : a;
+}
+
+/// Returns the bond order of the bond at index \p bond.
+inline Bond::BondOrderType MoleculeView::bondOrder(size_t bond) const
+{
+    return m_bondOrders[bond];
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_MOLECULEVIEW_INLINE_H
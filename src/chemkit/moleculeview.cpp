@@ -0,0 +1,180 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "moleculeview.h"
+
+#include "atom.h"
+#include "bond.h"
+#include "foreach.h"
+#include "molecule.h"
+
+namespace chemkit {
+
+// === MoleculeView ======================================================== //
+/// \class MoleculeView moleculeview.h chemkit/moleculeview.h
+/// \ingroup chemkit
+/// \brief The MoleculeView class provides a read-only, index-based
+///        view of a molecule's structure.
+///
+/// The view stores the atomic numbers, bond orders and the atom
+/// adjacency of a molecule in flat arrays (the adjacency is kept in
+/// compressed sparse row form). This makes it well suited for graph
+/// algorithms which visit every atom and its neighbors many times
+/// as no Atom or Bond objects need to be dereferenced and no memory
+/// is allocated during traversal.
+///
+/// For example, to count the number of carbon-oxygen bonds in a
+/// molecule:
+/// \code
+/// MoleculeView view(molecule);
+///
+/// size_t count = 0;
+/// for(size_t i = 0; i < view.atomCount(); i++){
+///     if(!view.is(i, Atom::Carbon)){
+///         continue;
+///     }
+///
+///     foreach(size_t neighbor, view.neighbors(i)){
+///         if(view.is(neighbor, Atom::Oxygen)){
+///             count++;
+///         }
+///     }
+/// }
+/// \endcode
+///
+/// \warning The view is a snapshot of the molecule at the time it
+///          was created. If any atoms or bonds in the molecule are
+///          added, removed or changed the view must be discarded
+///          and a new one created.
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new view of \p molecule.
+MoleculeView::MoleculeView(const Molecule *molecule)
+    : m_molecule(molecule)
+{
+    size_t atomCount = molecule->atomCount();
+    size_t bondCount = molecule->bondCount();
+
+    m_atomicNumbers.resize(atomCount);
+    m_offsets.assign(atomCount + 1, 0);
+    m_bondAtoms.resize(2 * bondCount);
+    m_bondOrders.resize(bondCount);
+
+    for(size_t i = 0; i < atomCount; i++){
+        m_atomicNumbers[i] = molecule->atom(i)->atomicNumber();
+    }
+
+    // store bond atoms and count the degree of each atom
+    for(size_t i = 0; i < bondCount; i++){
+        const Bond *bond = molecule->bond(i);
+        size_t a = bond->atom1()->index();
+        size_t b = bond->atom2()->index();
+
+        m_bondAtoms[2 * i] = a;
+        m_bondAtoms[2 * i + 1] = b;
+        m_bondOrders[i] = bond->order();
+
+        m_offsets[a + 1]++;
+        m_offsets[b + 1]++;
+    }
+
+    // convert degrees into row offsets
+    for(size_t i = 0; i < atomCount; i++){
+        m_offsets[i + 1] += m_offsets[i];
+    }
+
+    // fill adjacency lists in bond order
+    m_neighbors.resize(2 * bondCount);
+    m_neighborBonds.resize(2 * bondCount);
+
+    std::vector<size_t> position(m_offsets.begin(), m_offsets.end() - 1);
+
+    for(size_t i = 0; i < bondCount; i++){
+        size_t a = m_bondAtoms[2 * i];
+        size_t b = m_bondAtoms[2 * i + 1];
+
+        m_neighbors[position[a]] = b;
+        m_neighborBonds[position[a]++] = i;
+        m_neighbors[position[b]] = a;
+        m_neighborBonds[position[b]++] = i;
+    }
+}
+
+/// Destroys the molecule view.
+MoleculeView::~MoleculeView()
+{
+}
+
+// --- Atoms --------------------------------------------------------------- //
+/// Returns the sum of the bond orders for the atom at index \p atom.
+int MoleculeView::valence(size_t atom) const
+{
+    int valence = 0;
+
+    foreach(size_t bond, bonds(atom)){
+        valence += m_bondOrders[bond];
+    }
+
+    return valence;
+}
+
+/// Returns \c true if the atom at index \p atom is a hydrogen bonded
+/// to exactly one other atom.
+bool MoleculeView::isTerminalHydrogen(size_t atom) const
+{
+    return m_atomicNumbers[atom] == Atom::Hydrogen && neighborCount(atom) == 1;
+}
+
+/// Returns \c true if the atoms at indices \p a and \p b are bonded.
+bool MoleculeView::isBonded(size_t a, size_t b) const
+{
+    return bondBetween(a, b) != size_t(NullIndex);
+}
+
+/// Returns the index of the bond between the atoms at indices \p a
+/// and \p b. Returns \c NullIndex if they are not bonded.
+size_t MoleculeView::bondBetween(size_t a, size_t b) const
+{
+    for(size_t i = m_offsets[a]; i < m_offsets[a + 1]; i++){
+        if(m_neighbors[i] == b){
+            return m_neighborBonds[i];
+        }
+    }
+
+    return NullIndex;
+}
+
+} // end chemkit namespace
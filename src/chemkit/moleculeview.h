@@ -0,0 +1,109 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_MOLECULEVIEW_H
+#define CHEMKIT_MOLECULEVIEW_H
+
+#include "chemkit.h"
+
+#include <vector>
+
+#ifndef Q_MOC_RUN
+#include <boost/range/iterator_range.hpp>
+#endif
+
+#include "bond.h"
+#include "element.h"
+
+namespace chemkit {
+
+class Molecule;
+
+class CHEMKIT_EXPORT MoleculeView
+{
+public:
+    // typedefs
+    typedef boost::iterator_range<std::vector<size_t>::const_iterator> IndexRange;
+
+    // constants
+    enum { NullIndex = size_t(-1) };
+
+    // construction and destruction
+    MoleculeView(const Molecule *molecule);
+    ~MoleculeView();
+
+    // properties
+    inline const Molecule* molecule() const;
+    inline size_t size() const;
+    inline bool isEmpty() const;
+
+    // atoms
+    inline size_t atomCount() const;
+    inline Element::AtomicNumberType atomicNumber(size_t atom) const;
+    inline bool is(size_t atom, const Element &element) const;
+    inline size_t neighborCount(size_t atom) const;
+    inline IndexRange neighbors(size_t atom) const;
+    inline IndexRange bonds(size_t atom) const;
+    int valence(size_t atom) const;
+    bool isTerminalHydrogen(size_t atom) const;
+    bool isBonded(size_t a, size_t b) const;
+    size_t bondBetween(size_t a, size_t b) const;
+
+    // bonds
+    inline size_t bondCount() const;
+    inline size_t bondAtom1(size_t bond) const;
+    inline size_t bondAtom2(size_t bond) const;
+    inline size_t otherAtom(size_t bond, size_t atom) const;
+    inline Bond::BondOrderType bondOrder(size_t bond) const;
+
+private:
+    CHEMKIT_DISABLE_COPY(MoleculeView)
+
+private:
+    const Molecule *m_molecule;
+    std::vector<Element::AtomicNumberType> m_atomicNumbers;
+    std::vector<size_t> m_offsets;
+    std::vector<size_t> m_neighbors;
+    std::vector<size_t> m_neighborBonds;
+    std::vector<size_t> m_bondAtoms;
+    std::vector<Bond::BondOrderType> m_bondOrders;
+};
+
+} // end chemkit namespace
+
+#include "moleculeview-inline.h"
+
+#endif // CHEMKIT_MOLECULEVIEW_H
@@ -0,0 +1,229 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_OBJECTPOOL_H
+#define CHEMKIT_OBJECTPOOL_H
+
+#include "chemkit.h"
+
+#include <vector>
+#include <cassert>
+
+#ifndef Q_MOC_RUN
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#endif
+
+namespace chemkit {
+
+// === ObjectPool ========================================================== //
+/// \class ObjectPool objectpool.h
+/// \ingroup chemkit
+/// \internal
+/// \brief The ObjectPool class provides storage for many objects of
+///        the same type.
+///
+/// Memory is allocated in blocks large enough to hold many objects
+/// and is only returned to the system when the pool is destroyed.
+/// Storage released with deallocate() is reused by the following
+/// calls to allocate(). The address of an allocated object never
+/// changes.
+///
+/// The pool only manages memory. Objects must be constructed with
+/// placement new and destroyed by calling their destructor before
+/// their storage is released.
+template<typename T>
+class ObjectPool
+{
+public:
+    // construction and destruction
+    ObjectPool(size_t blockSize = 64);
+    ~ObjectPool();
+
+    // properties
+    void reserve(size_t capacity);
+    size_t capacity() const;
+    size_t size() const;
+
+    // memory
+    void* allocate();
+    void deallocate(void *pointer);
+    void release();
+
+private:
+    union Slot {
+        Slot *next;
+        typename boost::aligned_storage<sizeof(T), boost::alignment_of<T>::value>::type storage;
+    };
+
+    void addBlock(size_t size);
+
+    CHEMKIT_DISABLE_COPY(ObjectPool)
+
+private:
+    size_t m_blockSize;
+    size_t m_capacity;
+    size_t m_size;
+    Slot *m_free;
+    Slot *m_next;
+    Slot *m_end;
+    std::vector<Slot *> m_blocks;
+};
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new, empty object pool which will allocate memory in
+/// blocks of \p blockSize objects.
+template<typename T>
+inline ObjectPool<T>::ObjectPool(size_t blockSize)
+    : m_blockSize(blockSize),
+      m_capacity(0),
+      m_size(0),
+      m_free(0),
+      m_next(0),
+      m_end(0)
+{
+}
+
+/// Destroys the object pool and frees all of its memory.
+template<typename T>
+inline ObjectPool<T>::~ObjectPool()
+{
+    release();
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Ensures that at least \p capacity objects can be stored in the
+/// pool without allocating more memory.
+template<typename T>
+inline void ObjectPool<T>::reserve(size_t capacity)
+{
+    if(capacity > m_capacity){
+        addBlock(capacity - m_capacity);
+    }
+}
+
+/// Returns the number of objects the pool can store without
+/// allocating more memory.
+template<typename T>
+inline size_t ObjectPool<T>::capacity() const
+{
+    return m_capacity;
+}
+
+/// Returns the number of objects currently allocated from the pool.
+template<typename T>
+inline size_t ObjectPool<T>::size() const
+{
+    return m_size;
+}
+
+// --- Memory -------------------------------------------------------------- //
+/// Returns storage for a single object.
+template<typename T>
+inline void* ObjectPool<T>::allocate()
+{
+    Slot *slot;
+
+    if(m_free){
+        slot = m_free;
+        m_free = slot->next;
+    }
+    else{
+        if(m_next == m_end){
+            addBlock(m_blockSize);
+        }
+
+        slot = m_next++;
+    }
+
+    m_size++;
+
+    return &slot->storage;
+}
+
+/// Returns the storage at \p pointer to the pool. The storage must
+/// have been returned from a previous call to allocate().
+template<typename T>
+inline void ObjectPool<T>::deallocate(void *pointer)
+{
+    assert(m_size > 0);
+
+    Slot *slot = static_cast<Slot *>(pointer);
+    slot->next = m_free;
+    m_free = slot;
+
+    m_size--;
+}
+
+/// Frees all of the memory in the pool at once. Any objects still
+/// stored in the pool must have already been destroyed.
+template<typename T>
+inline void ObjectPool<T>::release()
+{
+    for(size_t i = 0; i < m_blocks.size(); i++){
+        delete [] m_blocks[i];
+    }
+
+    m_blocks.clear();
+    m_capacity = 0;
+    m_size = 0;
+    m_free = 0;
+    m_next = 0;
+    m_end = 0;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+template<typename T>
+inline void ObjectPool<T>::addBlock(size_t size)
+{
+    // slots left over in the current block are added to the free list
+    while(m_next != m_end){
+        Slot *slot = m_next++;
+        slot->next = m_free;
+        m_free = slot;
+    }
+
+    Slot *block = new Slot[size];
+    m_blocks.push_back(block);
+
+    m_next = block;
+    m_end = block + size;
+    m_capacity += size;
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_OBJECTPOOL_H
@@ -0,0 +1,275 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_PACKEDFINGERPRINT_INLINE_H
+#define CHEMKIT_PACKEDFINGERPRINT_INLINE_H
+
+#include "packedfingerprint.h"
+
+#include <cassert>
+#include <algorithm>
+
+namespace chemkit {
+
+// === PackedFingerprint =================================================== //
+/// \class PackedFingerprint packedfingerprint.h chemkit/packedfingerprint.h
+/// \ingroup chemkit
+/// \brief The PackedFingerprint class contains a fixed-width
+///        fingerprint.
+///
+/// Packed fingerprints store their bits inline in 64-bit words
+/// aligned to a 64 byte boundary rather than in a separate heap
+/// allocation like Bitset. Their size is always a multiple of 512 so
+/// an array of packed fingerprints is a single contiguous block which
+/// can be scored against a query with tanimotoCoefficients() or
+/// tverskyIndices().
+///
+/// The similarity methods use the processor's \c popcnt instruction
+/// when it is available.
+///
+/// The following example shows how to find the similarity between
+/// the FP2 fingerprints for two molecules:
+/// \code
+/// PackedFingerprint1024 a = molecule1->fingerprint("fp2");
+/// PackedFingerprint1024 b = molecule2->fingerprint("fp2");
+///
+/// Real similarity = a.tanimotoCoefficient(b);
+/// \endcode
+///
+/// \see Bitset, Fingerprint
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new packed fingerprint with every bit cleared.
+template<size_t N>
+inline PackedFingerprint<N>::PackedFingerprint()
+{
+    clear();
+}
+
+/// Creates a new packed fingerprint containing the bits in
+/// \p bitset. Bits past \c N are ignored.
+template<size_t N>
+inline PackedFingerprint<N>::PackedFingerprint(const Bitset &bitset)
+{
+    clear();
+
+    for(size_t i = bitset.find_first(); i < N && i != Bitset::npos; i = bitset.find_next(i)){
+        set(i);
+    }
+}
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of bits in the fingerprint.
+template<size_t N>
+inline size_t PackedFingerprint<N>::size() const
+{
+    return N;
+}
+
+/// Returns the number of bits that are set in the fingerprint.
+template<size_t N>
+inline size_t PackedFingerprint<N>::count() const
+{
+    return detail::packedPopcount(m_words, WordCount);
+}
+
+/// Returns \c true if no bits are set in the fingerprint.
+template<size_t N>
+inline bool PackedFingerprint<N>::isEmpty() const
+{
+    for(size_t i = 0; i < WordCount; i++){
+        if(m_words[i]){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Returns a pointer to the words containing the bits in the
+/// fingerprint. Bit \c i is stored in word \c i / 64 at position
+/// \c i % 64.
+template<size_t N>
+inline typename PackedFingerprint<N>::WordType* PackedFingerprint<N>::words()
+{
+    return m_words;
+}
+
+/// \overload
+template<size_t N>
+inline const typename PackedFingerprint<N>::WordType* PackedFingerprint<N>::words() const
+{
+    return m_words;
+}
+
+// --- Bits ---------------------------------------------------------------- //
+/// Sets the bit at \p bit to \p value.
+template<size_t N>
+inline void PackedFingerprint<N>::set(size_t bit, bool value)
+{
+    assert(bit < N);
+
+    WordType mask = WordType(1) << (bit % 64);
+
+    if(value){
+        m_words[bit / 64] |= mask;
+    }
+    else{
+        m_words[bit / 64] &= ~mask;
+    }
+}
+
+/// Clears the bit at \p bit.
+template<size_t N>
+inline void PackedFingerprint<N>::reset(size_t bit)
+{
+    set(bit, false);
+}
+
+/// Clears every bit in the fingerprint.
+template<size_t N>
+inline void PackedFingerprint<N>::clear()
+{
+    std::fill(m_words, m_words + WordCount, WordType(0));
+}
+
+/// Returns \c true if the bit at \p bit is set.
+template<size_t N>
+inline bool PackedFingerprint<N>::test(size_t bit) const
+{
+    assert(bit < N);
+
+    return (m_words[bit / 64] >> (bit % 64)) & 1;
+}
+
+/// Returns a bitset with \p size bits containing the bits in the
+/// fingerprint.
+template<size_t N>
+inline Bitset PackedFingerprint<N>::toBitset(size_t size) const
+{
+    Bitset bitset(size);
+
+    for(size_t i = 0; i < WordCount && i * 64 < size; i++){
+        WordType word = m_words[i];
+
+        for(size_t j = 0; word; j++, word >>= 1){
+            if((word & 1) && i * 64 + j < size){
+                bitset.set(i * 64 + j);
+            }
+        }
+    }
+
+    return bitset;
+}
+
+// --- Similarity ---------------------------------------------------------- //
+/// Returns the tanimoto coefficient between the fingerprint and
+/// \p other.
+template<size_t N>
+inline Real PackedFingerprint<N>::tanimotoCoefficient(const PackedFingerprint &other) const
+{
+    size_t intersection = detail::packedIntersectionCount(m_words, other.m_words, WordCount);
+
+    return Real(intersection) / Real(count() + other.count() - intersection);
+}
+
+/// Returns the tversky index between the fingerprint and \p other.
+/// The bits only set in the fingerprint are weighted by \p alpha and
+/// the bits only set in \p other are weighted by \p beta. An
+/// \p alpha and \p beta of \c 1 gives the tanimoto coefficient.
+template<size_t N>
+inline Real PackedFingerprint<N>::tverskyIndex(const PackedFingerprint &other, Real alpha, Real beta) const
+{
+    size_t intersection = detail::packedIntersectionCount(m_words, other.m_words, WordCount);
+
+    return Real(intersection) / (alpha * Real(count() - intersection) +
+                                 beta * Real(other.count() - intersection) +
+                                 Real(intersection));
+}
+
+/// Returns \c true if every bit set in the fingerprint is also set
+/// in \p other.
+template<size_t N>
+inline bool PackedFingerprint<N>::isSubsetOf(const PackedFingerprint &other) const
+{
+    for(size_t i = 0; i < WordCount; i++){
+        if(m_words[i] & ~other.m_words[i]){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Calculates the tanimoto coefficient between the fingerprint and
+/// each of the \p count fingerprints starting at \p fingerprints.
+/// The coefficients are written to \p coefficients.
+template<size_t N>
+inline void PackedFingerprint<N>::tanimotoCoefficients(const PackedFingerprint *fingerprints, size_t count, Real *coefficients) const
+{
+    const WordType *block = reinterpret_cast<const WordType *>(fingerprints);
+
+    detail::packedTanimotoCoefficients(m_words, block, WordCount, count, coefficients);
+}
+
+/// Calculates the tversky index between the fingerprint and each of
+/// the \p count fingerprints starting at \p fingerprints. The indices
+/// are written to \p indices.
+///
+/// \see tverskyIndex()
+template<size_t N>
+inline void PackedFingerprint<N>::tverskyIndices(const PackedFingerprint *fingerprints, size_t count, Real alpha, Real beta, Real *indices) const
+{
+    const WordType *block = reinterpret_cast<const WordType *>(fingerprints);
+
+    detail::packedTverskyIndices(m_words, block, WordCount, count, alpha, beta, indices);
+}
+
+// --- Operators ----------------------------------------------------------- //
+template<size_t N>
+inline bool PackedFingerprint<N>::operator==(const PackedFingerprint &other) const
+{
+    return std::equal(m_words, m_words + WordCount, other.m_words);
+}
+
+template<size_t N>
+inline bool PackedFingerprint<N>::operator!=(const PackedFingerprint &other) const
+{
+    return !(*this == other);
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_PACKEDFINGERPRINT_INLINE_H
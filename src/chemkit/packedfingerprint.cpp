@@ -0,0 +1,256 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "packedfingerprint.h"
+
+// use the popcnt instruction when the processor supports it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define CHEMKIT_PACKEDFINGERPRINT_POPCNT
+#endif
+
+namespace chemkit {
+namespace detail {
+
+namespace {
+
+typedef boost::uint64_t Word;
+
+// Returns the number of set bits in word without using any special
+// instructions.
+struct GenericPopcount
+{
+    size_t operator()(Word word) const
+    {
+        word = word - ((word >> 1) & 0x5555555555555555ULL);
+        word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+        word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+
+        return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+    }
+};
+
+#ifdef CHEMKIT_PACKEDFINGERPRINT_POPCNT
+// Returns the number of set bits in word. This compiles to a single
+// popcnt instruction when inlined into a function targeting popcnt.
+struct BuiltinPopcount
+{
+    size_t operator()(Word word) const
+    {
+        return __builtin_popcountll(word);
+    }
+};
+#endif
+
+template<typename Popcount>
+inline size_t popcount(const Word *words, size_t size, const Popcount &popcount)
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < size; i++){
+        count += popcount(words[i]);
+    }
+
+    return count;
+}
+
+template<typename Popcount>
+inline size_t intersectionCount(const Word *a, const Word *b, size_t size, const Popcount &popcount)
+{
+    size_t count = 0;
+
+    for(size_t i = 0; i < size; i++){
+        count += popcount(a[i] & b[i]);
+    }
+
+    return count;
+}
+
+// Calculates the tversky index between query and each fingerprint in
+// block. The popcount of each fingerprint and its intersection with
+// the query are found in a single pass over the fingerprint.
+template<typename Popcount>
+inline void tverskyIndices(const Word *query,
+                           const Word *block,
+                           size_t size,
+                           size_t count,
+                           Real alpha,
+                           Real beta,
+                           Real *indices,
+                           const Popcount &popcount)
+{
+    size_t queryCount = 0;
+    for(size_t i = 0; i < size; i++){
+        queryCount += popcount(query[i]);
+    }
+
+    for(size_t i = 0; i < count; i++){
+        const Word *fingerprint = block + i * size;
+
+        size_t fingerprintCount = 0;
+        size_t intersection = 0;
+
+        for(size_t j = 0; j < size; j++){
+            fingerprintCount += popcount(fingerprint[j]);
+            intersection += popcount(query[j] & fingerprint[j]);
+        }
+
+        indices[i] = Real(intersection) / (alpha * Real(queryCount - intersection) +
+                                           beta * Real(fingerprintCount - intersection) +
+                                           Real(intersection));
+    }
+}
+
+// --- Generic Kernels ----------------------------------------------------- //
+size_t genericPopcount(const Word *words, size_t size)
+{
+    return popcount(words, size, GenericPopcount());
+}
+
+size_t genericIntersectionCount(const Word *a, const Word *b, size_t size)
+{
+    return intersectionCount(a, b, size, GenericPopcount());
+}
+
+void genericTverskyIndices(const Word *query, const Word *block, size_t size, size_t count, Real alpha, Real beta, Real *indices)
+{
+    tverskyIndices(query, block, size, count, alpha, beta, indices, GenericPopcount());
+}
+
+// --- Popcnt Kernels ------------------------------------------------------ //
+#ifdef CHEMKIT_PACKEDFINGERPRINT_POPCNT
+__attribute__((target("popcnt")))
+size_t popcntPopcount(const Word *words, size_t size)
+{
+    return popcount(words, size, BuiltinPopcount());
+}
+
+__attribute__((target("popcnt")))
+size_t popcntIntersectionCount(const Word *a, const Word *b, size_t size)
+{
+    return intersectionCount(a, b, size, BuiltinPopcount());
+}
+
+__attribute__((target("popcnt")))
+void popcntTverskyIndices(const Word *query, const Word *block, size_t size, size_t count, Real alpha, Real beta, Real *indices)
+{
+    tverskyIndices(query, block, size, count, alpha, beta, indices, BuiltinPopcount());
+}
+#endif
+
+// The Kernels class contains the kernels for the processor that the
+// library is running on.
+struct Kernels
+{
+    Kernels()
+        : popcount(genericPopcount),
+          intersectionCount(genericIntersectionCount),
+          tverskyIndices(genericTverskyIndices)
+    {
+#ifdef CHEMKIT_PACKEDFINGERPRINT_POPCNT
+        __builtin_cpu_init();
+
+        if(__builtin_cpu_supports("popcnt")){
+            popcount = popcntPopcount;
+            intersectionCount = popcntIntersectionCount;
+            tverskyIndices = popcntTverskyIndices;
+        }
+#endif
+    }
+
+    size_t (*popcount)(const Word *, size_t);
+    size_t (*intersectionCount)(const Word *, const Word *, size_t);
+    void (*tverskyIndices)(const Word *, const Word *, size_t, size_t, Real, Real, Real *);
+};
+
+// Returns the kernels for the processor. They are selected the first
+// time this is called so they are ready even during static
+// initialization.
+const Kernels& kernels()
+{
+    static const Kernels kernels;
+
+    return kernels;
+}
+
+} // end anonymous namespace
+
+// --- Kernels ------------------------------------------------------------- //
+/// Returns the number of bits set in the \p size words starting at
+/// \p words.
+///
+/// \internal
+size_t packedPopcount(const boost::uint64_t *words, size_t size)
+{
+    return kernels().popcount(words, size);
+}
+
+/// Returns the number of bits set in both \p a and \p b.
+///
+/// \internal
+size_t packedIntersectionCount(const boost::uint64_t *a, const boost::uint64_t *b, size_t size)
+{
+    return kernels().intersectionCount(a, b, size);
+}
+
+/// Calculates the tanimoto coefficient between \p query and each of
+/// the \p count fingerprints in \p block.
+///
+/// \internal
+void packedTanimotoCoefficients(const boost::uint64_t *query,
+                                const boost::uint64_t *block,
+                                size_t size,
+                                size_t count,
+                                Real *coefficients)
+{
+    kernels().tverskyIndices(query, block, size, count, 1, 1, coefficients);
+}
+
+/// Calculates the tversky index between \p query and each of the
+/// \p count fingerprints in \p block.
+///
+/// \internal
+void packedTverskyIndices(const boost::uint64_t *query,
+                          const boost::uint64_t *block,
+                          size_t size,
+                          size_t count,
+                          Real alpha,
+                          Real beta,
+                          Real *indices)
+{
+    kernels().tverskyIndices(query, block, size, count, alpha, beta, indices);
+}
+
+} // end detail namespace
+} // end chemkit namespace
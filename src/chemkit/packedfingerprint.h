@@ -0,0 +1,132 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_PACKEDFINGERPRINT_H
+#define CHEMKIT_PACKEDFINGERPRINT_H
+
+#include "chemkit.h"
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#endif
+
+#include "bitset.h"
+
+namespace chemkit {
+
+namespace detail {
+
+// similarity kernels for packed fingerprints. each fingerprint is
+// stored as size 64-bit words and blocks contain count fingerprints
+// stored one after another.
+CHEMKIT_EXPORT size_t packedPopcount(const boost::uint64_t *words, size_t size);
+CHEMKIT_EXPORT size_t packedIntersectionCount(const boost::uint64_t *a, const boost::uint64_t *b, size_t size);
+CHEMKIT_EXPORT void packedTanimotoCoefficients(const boost::uint64_t *query,
+                                               const boost::uint64_t *block,
+                                               size_t size,
+                                               size_t count,
+                                               Real *coefficients);
+CHEMKIT_EXPORT void packedTverskyIndices(const boost::uint64_t *query,
+                                         const boost::uint64_t *block,
+                                         size_t size,
+                                         size_t count,
+                                         Real alpha,
+                                         Real beta,
+                                         Real *indices);
+
+} // end detail namespace
+
+template<size_t N>
+class PackedFingerprint
+{
+public:
+    // typedefs
+    typedef boost::uint64_t WordType;
+
+    // constants
+    enum {
+        BitCount = N,
+        WordCount = N / 64
+    };
+
+    // construction and destruction
+    PackedFingerprint();
+    PackedFingerprint(const Bitset &bitset);
+
+    // properties
+    size_t size() const;
+    size_t count() const;
+    bool isEmpty() const;
+    WordType* words();
+    const WordType* words() const;
+
+    // bits
+    void set(size_t bit, bool value = true);
+    void reset(size_t bit);
+    void clear();
+    bool test(size_t bit) const;
+    Bitset toBitset(size_t size = N) const;
+
+    // similarity
+    Real tanimotoCoefficient(const PackedFingerprint &other) const;
+    Real tverskyIndex(const PackedFingerprint &other, Real alpha, Real beta) const;
+    bool isSubsetOf(const PackedFingerprint &other) const;
+    void tanimotoCoefficients(const PackedFingerprint *fingerprints, size_t count, Real *coefficients) const;
+    void tverskyIndices(const PackedFingerprint *fingerprints, size_t count, Real alpha, Real beta, Real *indices) const;
+
+    // operators
+    bool operator==(const PackedFingerprint &other) const;
+    bool operator!=(const PackedFingerprint &other) const;
+
+private:
+    // keep the size a multiple of the alignment so that arrays of
+    // fingerprints are contiguous
+    BOOST_STATIC_ASSERT(N > 0 && N % 512 == 0);
+
+    CHEMKIT_ALIGN(64) WordType m_words[WordCount];
+};
+
+/// A packed fingerprint containing 1024 bits.
+typedef PackedFingerprint<1024> PackedFingerprint1024;
+
+/// A packed fingerprint containing 2048 bits.
+typedef PackedFingerprint<2048> PackedFingerprint2048;
+
+} // end chemkit namespace
+
+#include "packedfingerprint-inline.h"
+
+#endif // CHEMKIT_PACKEDFINGERPRINT_H
@@ -58,9 +58,11 @@ namespace chemkit {
 /// methods such as Molecule::rings() and Atom::smallestRing().
 
 // --- Construction and Destruction ---------------------------------------- //
-/// Creates a new ring that contains the atoms is \p path.
-Ring::Ring(std::vector<Atom *> path)
-    : m_atoms(path)
+/// Creates a new ring that contains the atoms is \p path. The
+/// ring's \p index is its position in the molecule's list of rings.
+Ring::Ring(std::vector<Atom *> path, size_t index)
+    : m_atoms(path),
+      m_index(index)
 {
     assert(isValid());
 }
@@ -245,7 +247,62 @@ bool Ring::isFusedTo(const Ring *ring) const
 
 // --- Aromaticity --------------------------------------------------------- //
 /// Returns \c true if the ring is aromatic.
+///
+/// The aromaticity of every ring in the molecule is determined at
+/// once and cached until the molecule is modified.
+///
+/// \see Molecule::setAromaticityModel()
 bool Ring::isAromatic() const
+{
+    return molecule()->isAromaticRing(this);
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+bool Ring::isValid() const
+{
+    if(size() < 3)
+        return false;
+
+    for(size_t i = 0; i < size(); i++){
+        if(!m_atoms[i]->isBondedTo(m_atoms[(i+1) % size()])){
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const Atom* Ring::nextAtom(const Atom *atom) const
+{
+    size_t index = std::distance(m_atoms.begin(), std::find(m_atoms.begin(), m_atoms.end(), atom));
+
+    return m_atoms[(index+1) % size()];
+}
+
+const Atom* Ring::previousAtom(const Atom *atom) const
+{
+    size_t index = std::distance(m_atoms.begin(), std::find(m_atoms.begin(), m_atoms.end(), atom));
+
+    if(index == 0)
+        index = size()-1;
+    else
+        index = (index-1) % size();
+
+    return m_atoms[index];
+}
+
+const Bond* Ring::nextBond(const Atom *atom) const
+{
+    return atom->bondTo(nextAtom(atom));
+}
+
+const Bond* Ring::previousBond(const Atom *atom) const
+{
+    return atom->bondTo(previousAtom(atom));
+}
+
+// Returns true if the ring is aromatic according to huckel's rule.
+bool Ring::isHuckelAromatic() const
 {
     // check for planarity of all ring atoms
     if(!isPlanar()){
@@ -302,50 +359,6 @@ bool Ring::isAromatic() const
     return false;
 }
 
-// --- Internal Methods ---------------------------------------------------- //
-bool Ring::isValid() const
-{
-    if(size() < 3)
-        return false;
-
-    for(size_t i = 0; i < size(); i++){
-        if(!m_atoms[i]->isBondedTo(m_atoms[(i+1) % size()])){
-            return false;
-        }
-    }
-
-    return true;
-}
-
-const Atom* Ring::nextAtom(const Atom *atom) const
-{
-    size_t index = std::distance(m_atoms.begin(), std::find(m_atoms.begin(), m_atoms.end(), atom));
-
-    return m_atoms[(index+1) % size()];
-}
-
-const Atom* Ring::previousAtom(const Atom *atom) const
-{
-    size_t index = std::distance(m_atoms.begin(), std::find(m_atoms.begin(), m_atoms.end(), atom));
-
-    if(index == 0)
-        index = size()-1;
-    else
-        index = (index-1) % size();
-
-    return m_atoms[index];
-}
-
-const Bond* Ring::nextBond(const Atom *atom) const
-{
-    return atom->bondTo(nextAtom(atom));
-}
-
-const Bond* Ring::previousBond(const Atom *atom) const
-{
-    return atom->bondTo(previousAtom(atom));
-}
-
 bool Ring::isPlanar() const
 {
     foreach(const Atom *atom, m_atoms){
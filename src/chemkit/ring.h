@@ -93,7 +93,7 @@ public:
     bool isAromatic() const;
 
 private:
-    Ring(std::vector<Atom *> path);
+    Ring(std::vector<Atom *> path, size_t index);
     ~Ring();
 
     // internal methods
@@ -103,6 +103,7 @@ private:
     const Bond *nextBond(const Atom *atom) const;
     const Bond *previousBond(const Atom *atom) const;
     bool isPlanar() const;
+    bool isHuckelAromatic() const;
     size_t piElectronCount() const;
 
     CHEMKIT_DISABLE_COPY(Ring)
@@ -111,6 +112,7 @@ private:
 
 private:
     std::vector<Atom *> m_atoms;
+    size_t m_index;
 };
 
 } // end chemkit namespace
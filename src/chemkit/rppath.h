@@ -38,18 +38,14 @@
 
 #include "chemkit.h"
 
-#include <set>
 #include <limits>
 #include <algorithm>
 
-#ifndef Q_MOC_RUN
-#include <boost/bind.hpp>
-#endif
-
 #include <Eigen/Core>
 
 #include "atom.h"
 #include "graph.h"
+#include "bitset.h"
 #include "foreach.h"
 #include "fragment.h"
 #include "molecule.h"
@@ -179,133 +175,317 @@ private:
     T m_end;
 };
 
+// Returns the connected component containing each vertex in graph.
+// The components are numbered in order of their lowest vertex which
+// is the same order as Molecule::fragments().
+template<typename T>
+inline std::vector<T> connectedComponents(const Graph<T> &graph)
+{
+    T n = graph.size();
+    std::vector<T> components(n, n);
+    std::vector<T> queue;
+    T count = 0;
+
+    for(T root = 0; root < n; root++){
+        if(components[root] != n){
+            continue;
+        }
+
+        components[root] = count;
+        queue.assign(1, root);
+
+        for(size_t position = 0; position < queue.size(); position++){
+            foreach(T neighbor, graph.neighbors(queue[position])){
+                if(components[neighbor] == n){
+                    components[neighbor] = count;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        count++;
+    }
+
+    return components;
+}
+
+// Orders rings by the connected component they are in and then from
+// smallest to largest.
+template<typename T>
+class CompareRingComponent
+{
+public:
+    CompareRingComponent(const std::vector<T> &components)
+        : m_components(components)
+    {
+    }
+
+    bool operator()(const std::vector<T> &a, const std::vector<T> &b) const
+    {
+        T componentA = m_components[a.front()];
+        T componentB = m_components[b.front()];
+
+        return componentA < componentB || (componentA == componentB && a.size() < b.size());
+    }
+
+private:
+    const std::vector<T> &m_components;
+};
+
 // === Sssr ================================================================ //
+// The Sssr class collects the smallest set of smallest rings from ring
+// candidates of increasing size. Each candidate is converted to a bitset
+// of the edges it contains and is only accepted if its edges are
+// linearly independent (over GF(2)) of the rings already accepted. The
+// independence test uses incremental Gaussian elimination on a basis
+// kept sorted by pivot (the first set bit of each row).
 template<typename T>
 class Sssr
 {
 public:
+    // construction and destruction
+    Sssr(const Graph<T> &graph);
+
     // properties
     size_t size() const { return m_rings.size(); }
     bool isEmpty() const { return m_rings.empty(); }
 
     // rings
     const std::vector<std::vector<T> >& rings() const { return m_rings; }
-    void append(const std::vector<T> &ring) { m_rings.push_back(ring); }
+    bool append(const std::vector<T> &ring);
 
     // ring checks
     bool isValid(const std::vector<T> &ring) const;
-    bool isUnique(const std::vector<T> &ring) const;
+    bool isIndependent(const Bitset &edges) const;
+    Bitset edges(const std::vector<T> &ring) const;
 
 private:
+    Bitset reduce(Bitset edges) const;
+
+private:
+    T m_size;
+    T m_edgeCount;
+    std::vector<T> m_edgeIndices;
     std::vector<std::vector<T> > m_rings;
+    std::vector<Bitset> m_basis;
+    std::vector<size_t> m_pivots;
 };
 
+// --- Construction and Destruction ---------------------------------------- //
+template<typename T>
+inline Sssr<T>::Sssr(const Graph<T> &graph)
+    : m_size(graph.size()),
+      m_edgeCount(0),
+      m_edgeIndices(m_size * m_size)
+{
+    for(T i = 0; i < m_size; i++){
+        foreach(T j, graph.neighbors(i)){
+            if(i < j){
+                m_edgeIndices[i * m_size + j] = m_edgeCount;
+                m_edgeIndices[j * m_size + i] = m_edgeCount;
+                m_edgeCount++;
+            }
+        }
+    }
+}
+
+// --- Rings --------------------------------------------------------------- //
+// Adds ring to the sssr if it is valid and independent of the rings
+// already in the sssr. Returns true if the ring was added.
+template<typename T>
+inline bool Sssr<T>::append(const std::vector<T> &ring)
+{
+    if(!isValid(ring)){
+        return false;
+    }
+
+    Bitset reduced = reduce(edges(ring));
+    if(reduced.none()){
+        return false;
+    }
+
+    // insert the reduced edges into the basis sorted by pivot
+    size_t pivot = reduced.find_first();
+    size_t position = std::lower_bound(m_pivots.begin(), m_pivots.end(), pivot) - m_pivots.begin();
+    m_pivots.insert(m_pivots.begin() + position, pivot);
+    m_basis.insert(m_basis.begin() + position, reduced);
+
+    m_rings.push_back(ring);
+
+    return true;
+}
+
 // --- Ring Checks --------------------------------------------------------- //
 template<typename T>
 inline bool Sssr<T>::isValid(const std::vector<T> &ring) const
 {
     // check for any duplicate vertices
-    for(T i = 0; i < ring.size(); i++){
-        for(T j = i + 1; j < ring.size(); j++){
-            if(ring[i] == ring[j]){
-                return false;
-            }
+    Bitset vertices(m_size);
+
+    foreach(T vertex, ring){
+        if(vertices[vertex]){
+            return false;
         }
+
+        vertices.set(vertex);
     }
 
     return true;
 }
 
 template<typename T>
-inline bool Sssr<T>::isUnique(const std::vector<T> &path) const
+inline bool Sssr<T>::isIndependent(const Bitset &edges) const
 {
-    // must be unique if sssr is empty
-    if(isEmpty()){
-        return true;
-    }
+    return reduce(edges).any();
+}
 
-    // check if a ring with the same atoms is already in the sssr
-    std::set<T> pathSet;
-    pathSet.insert(path.begin(), path.end());
+// Returns the set of edges in ring.
+template<typename T>
+inline Bitset Sssr<T>::edges(const std::vector<T> &ring) const
+{
+    Bitset edges(m_edgeCount);
 
-    foreach(const std::vector<T> &ring, m_rings){
-        std::set<T> ringSet;
-        ringSet.insert(ring.begin(), ring.end());
+    for(size_t i = 0; i < ring.size(); i++){
+        T a = ring[i];
+        T b = ring[(i + 1) % ring.size()];
 
-        std::vector<T> sortedRing(ring.begin(), ring.end());
-        std::sort(sortedRing.begin(), sortedRing.end());
+        edges.set(m_edgeIndices[a * m_size + b]);
+    }
 
-        std::set<T> intersection;
-        std::set_intersection(pathSet.begin(), pathSet.end(),
-                              ringSet.begin(), ringSet.end(),
-                              std::inserter(intersection, intersection.begin()));
+    return edges;
+}
 
-        if(intersection.size() == ring.size()){
-            return false;
+// Reduces edges by each row in the basis. The rows are sorted by
+// pivot and contain no bits before their pivot so each step leaves
+// the earlier pivots cleared.
+template<typename T>
+inline Bitset Sssr<T>::reduce(Bitset edges) const
+{
+    for(size_t i = 0; i < m_basis.size(); i++){
+        if(edges[m_pivots[i]]){
+            edges ^= m_basis[i];
         }
     }
 
-    // build set of bonds in the path
-    std::set<std::pair<T, T> > pathBonds;
-    for(T i = 0; i < path.size() - 1; i++){
-        pathBonds.insert(std::make_pair(std::min(path[i], path[i+1]),
-                                        std::max(path[i], path[i+1])));
+    return edges;
+}
+
+// === Ring Systems ======================================================== //
+// Returns the edges in each ring system (biconnected component with at
+// least one cycle) of the graph. Chains of terminal vertices are removed
+// first and the remaining vertices are split with an iterative version
+// of Tarjan's algorithm.
+template<typename T>
+inline std::vector<std::vector<std::pair<T, T> > > ringSystems(const Graph<T> &graph)
+{
+    T n = graph.size();
+
+    // remove chains of terminal vertices
+    std::vector<T> degree(n);
+    std::vector<bool> removed(n, false);
+    std::vector<T> terminals;
+
+    for(T i = 0; i < n; i++){
+        degree[i] = graph.neighbors(i).size();
+
+        if(degree[i] < 2){
+            terminals.push_back(i);
+        }
     }
 
-    pathBonds.insert(std::make_pair(std::min(path.front(), path.back()),
-                                    std::max(path.front(), path.back())));
+    while(!terminals.empty()){
+        T vertex = terminals.back();
+        terminals.pop_back();
+        removed[vertex] = true;
 
-    // remove bonds from path bonds that are already in a smaller ring
-    foreach(const std::vector<T> &ring, m_rings){
-        if(ring.size() >= path.size()){
-            continue;
+        foreach(T neighbor, graph.neighbors(vertex)){
+            if(!removed[neighbor] && --degree[neighbor] == 1){
+                terminals.push_back(neighbor);
+            }
         }
+    }
 
-        for(T i = 0; i < ring.size() - 1; i++){
-            pathBonds.erase(std::make_pair(std::min(ring[i], ring[i+1]),
-                                           std::max(ring[i], ring[i+1])));
+    // split the remaining vertices into biconnected components
+    std::vector<std::vector<std::pair<T, T> > > systems;
+    std::vector<T> discovery(n, 0);
+    std::vector<T> low(n, 0);
+    std::vector<std::pair<T, T> > edges;
+    std::vector<std::pair<T, T> > stack; // (vertex, next neighbor)
+    std::vector<T> parents;
+    T time = 0;
+
+    for(T root = 0; root < n; root++){
+        if(removed[root] || discovery[root]){
+            continue;
         }
 
-        pathBonds.erase(std::make_pair(std::min(ring.front(), ring.back()),
-                                       std::max(ring.front(), ring.back())));
-    }
+        discovery[root] = low[root] = ++time;
+        stack.push_back(std::make_pair(root, T(0)));
+        parents.push_back(root);
 
-    // check if any other ring contains the same bonds
-    foreach(const std::vector<T> &ring, m_rings){
-        std::set<std::pair<T, T> > ringBonds;
+        while(!stack.empty()){
+            T vertex = stack.back().first;
+            T parent = parents.back();
+            const std::vector<T> &neighbors = graph.neighbors(vertex);
 
-        // add ring bonds
-        for(T i = 0; i < ring.size() - 1; i++){
-            ringBonds.insert(std::make_pair(std::min(ring[i], ring[i+1]),
-                                            std::max(ring[i], ring[i+1])));
-        }
+            if(stack.back().second < neighbors.size()){
+                T neighbor = neighbors[stack.back().second++];
+
+                if(removed[neighbor]){
+                    continue;
+                }
+                else if(!discovery[neighbor]){
+                    edges.push_back(std::make_pair(vertex, neighbor));
+                    discovery[neighbor] = low[neighbor] = ++time;
+                    stack.push_back(std::make_pair(neighbor, T(0)));
+                    parents.push_back(vertex);
+                }
+                else if(neighbor != parent && discovery[neighbor] < discovery[vertex]){
+                    edges.push_back(std::make_pair(vertex, neighbor));
+                    low[vertex] = std::min(low[vertex], discovery[neighbor]);
+                }
+
+                continue;
+            }
 
-        // add closure bond
-        ringBonds.insert(std::make_pair(std::min(ring.front(), ring.back()),
-                                        std::max(ring.front(), ring.back())));
+            stack.pop_back();
+            parents.pop_back();
 
-        // check intersection
-        std::set<std::pair<T, T> > intersection;
-        std::set_intersection(pathBonds.begin(), pathBonds.end(),
-                              ringBonds.begin(), ringBonds.end(),
-                              std::inserter(intersection, intersection.begin()));
+            if(stack.empty()){
+                continue;
+            }
 
-        if(intersection.size() == pathBonds.size()){
-            return false;
+            low[parent] = std::min(low[parent], low[vertex]);
+
+            if(low[vertex] >= discovery[parent]){
+                // parent is an articulation point, pop the component
+                std::vector<std::pair<T, T> > system;
+
+                for(;;){
+                    std::pair<T, T> edge = edges.back();
+                    edges.pop_back();
+                    system.push_back(edge);
+
+                    if(edge.first == parent && edge.second == vertex){
+                        break;
+                    }
+                }
+
+                // a single edge is a bridge and not part of any ring
+                if(system.size() > 1){
+                    systems.push_back(system);
+                }
+            }
         }
     }
 
-    return true;
+    return systems;
 }
 
-} // end detail namespace
-
-// Returns the smallest set of smallest rings in a graph using the
-// RP-Path algorithm.
-//
-// For a description of the algorithm see [Lee 2009].
+// Returns the smallest set of smallest rings in a connected graph
+// containing at least one cycle.
 template<typename T>
-inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
+inline std::vector<std::vector<T> > rppathRingSystem(const Graph<T> &graph)
 {
     typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> DistanceMatrix;
     using chemkit::algorithm::detail::PidMatrix;
@@ -394,7 +574,7 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
     std::sort(candidates.begin(), candidates.end(), RingCandidate<T>::compareSize);
 
     // algorithm 3 - find sssr from the ring candidate set
-    Sssr<T> sssr;
+    Sssr<T> sssr(graph);
 
     foreach(const RingCandidate<T> &candidate, candidates){
         // odd sized ring
@@ -402,17 +582,16 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
             for(size_t i = 0; i < Pt(candidate.start(), candidate.end()).size(); i++){
                 std::vector<T> ring;
                 ring.push_back(candidate.start());
-                std::vector<T> &path = Pt(candidate.start(), candidate.end())[i];
+                const std::vector<T> &path = Pt(candidate.start(), candidate.end())[i];
                 ring.insert(ring.end(), path.begin(), path.end());
                 ring.push_back(candidate.end());
                 if(!P(candidate.end(), candidate.start()).empty()){
-                    path = P(candidate.end(), candidate.start())[0];
-                    ring.insert(ring.end(), path.begin(), path.end());
+                    const std::vector<T> &returnPath = P(candidate.end(), candidate.start())[0];
+                    ring.insert(ring.end(), returnPath.begin(), returnPath.end());
                 }
 
-                // check if ring is valid and unique
-                if(sssr.isValid(ring) && sssr.isUnique(ring)){
-                    sssr.append(ring);
+                // add ring if it is valid and independent
+                if(sssr.append(ring)){
                     break;
                 }
             }
@@ -422,15 +601,14 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
             for(size_t i = 0; i < P(candidate.start(), candidate.end()).size() - 1; i++){
                 std::vector<T> ring;
                 ring.push_back(candidate.start());
-                std::vector<T> &path = P(candidate.start(), candidate.end())[i];
+                const std::vector<T> &path = P(candidate.start(), candidate.end())[i];
                 ring.insert(ring.end(), path.begin(), path.end());
                 ring.push_back(candidate.end());
-                path = P(candidate.end(), candidate.start())[i+1];
-                ring.insert(ring.end(), path.begin(), path.end());
+                const std::vector<T> &returnPath = P(candidate.end(), candidate.start())[i+1];
+                ring.insert(ring.end(), returnPath.begin(), returnPath.end());
 
-                // check if ring is valid and unique
-                if(sssr.isValid(ring) && sssr.isUnique(ring)){
-                    sssr.append(ring);
+                // add ring if it is valid and independent
+                if(sssr.append(ring)){
                     break;
                 }
             }
@@ -444,28 +622,92 @@ inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
     return sssr.rings();
 }
 
-inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
+} // end detail namespace
+
+// Returns the smallest set of smallest rings in a graph using the
+// RP-Path algorithm.
+//
+// The algorithm is run separately on each ring system in the graph
+// so its cost depends on the size of the largest ring system rather
+// than the size of the graph. The rings are ordered by connected
+// component (in order of each component's lowest vertex) and then by
+// size.
+//
+// For a description of the algorithm see [Lee 2009].
+template<typename T>
+inline std::vector<std::vector<T> > rppath(const Graph<T> &graph)
 {
-    std::vector<Atom *> atoms = fragment->atoms();
+    typedef std::pair<T, T> Edge;
+
+    std::vector<std::vector<T> > rings;
+    std::vector<T> localIndices(graph.size());
+
+    foreach(const std::vector<Edge> &system, detail::ringSystems(graph)){
+        // build the graph for the ring system
+        std::vector<T> vertices;
+        foreach(const Edge &edge, system){
+            vertices.push_back(edge.first);
+            vertices.push_back(edge.second);
+        }
+
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+        for(T i = 0; i < vertices.size(); i++){
+            localIndices[vertices[i]] = i;
+        }
+
+        Graph<T> systemGraph(vertices.size());
+        foreach(const Edge &edge, system){
+            systemGraph.addEdge(localIndices[edge.first], localIndices[edge.second]);
+        }
+
+        // perceive rings and convert back to the original vertices
+        foreach(std::vector<T> ring, detail::rppathRingSystem(systemGraph)){
+            for(T i = 0; i < ring.size(); i++){
+                ring[i] = vertices[ring[i]];
+            }
+
+            rings.push_back(ring);
+        }
+    }
+
+    // order rings by connected component (fragment) and then from
+    // smallest to largest within each component
+    if(rings.size() > 1){
+        std::vector<T> components = detail::connectedComponents(graph);
+        std::stable_sort(rings.begin(), rings.end(), detail::CompareRingComponent<T>(components));
+    }
+
+    return rings;
+}
 
-    // remove any terminal atoms
-    atoms.erase(std::remove_if(atoms.begin(), atoms.end(), boost::bind(&Atom::isTerminal, _1)), atoms.end());
+// Returns the smallest set of smallest rings for atoms.
+inline std::vector<std::vector<Atom *> > rppath(const std::vector<Atom *> &atoms)
+{
+    if(atoms.empty()){
+        return std::vector<std::vector<Atom *> >();
+    }
 
     // create graph
+    const Molecule *molecule = atoms.front()->molecule();
+    std::vector<size_t> indices(molecule->size(), atoms.size());
+    for(size_t i = 0; i < atoms.size(); i++){
+        indices[atoms[i]->index()] = i;
+    }
+
     Graph<size_t> graph(atoms.size());
 
     for(size_t i = 0; i < atoms.size(); i++){
-        for(size_t j = i + 1; j < atoms.size(); j++){
-            if(atoms[i]->isBondedTo(atoms[j])){
+        foreach(const Atom *neighbor, atoms[i]->neighbors()){
+            size_t j = indices[neighbor->index()];
+
+            if(j < atoms.size() && i < j){
                 graph.addEdge(i, j);
             }
         }
     }
 
-    // cyclize graph
-    std::vector<size_t> originalIndices;
-    graph.cyclize(originalIndices);
-
     // perceive rings
     std::vector<std::vector<size_t> > sssr = rppath(graph);
 
@@ -476,7 +718,7 @@ inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
         std::vector<Atom *> ring(cycle.size());
 
         for(size_t i = 0; i < cycle.size(); i++){
-            ring[i] = atoms[originalIndices[cycle[i]]];
+            ring[i] = atoms[cycle[i]];
         }
 
         rings.push_back(ring);
@@ -485,17 +727,14 @@ inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
     return rings;
 }
 
-inline std::vector<std::vector<Atom *> > rppath(const Molecule *molecule)
+inline std::vector<std::vector<Atom *> > rppath(const Fragment *fragment)
 {
-    std::vector<std::vector<Atom *> > rings;
-
-    foreach(const Fragment *fragment, molecule->fragments()){
-        std::vector<std::vector<Atom *> > fragmentRings = rppath(fragment);
-
-        rings.insert(rings.end(), fragmentRings.begin(), fragmentRings.end());
-    }
+    return rppath(fragment->atoms());
+}
 
-    return rings;
+inline std::vector<std::vector<Atom *> > rppath(const Molecule *molecule)
+{
+    return rppath(std::vector<Atom *>(molecule->atoms().begin(), molecule->atoms().end()));
 }
 
 } // end algorithm namespace
@@ -78,6 +78,8 @@ private:
     const Molecule *m_molecule;
     std::map<const Atom *, Type> m_atomStereochemistry;
     std::map<const Bond *, Type> m_bondStereochemistry;
+
+    friend class Molecule;
 };
 
 } // end chemkit namespace
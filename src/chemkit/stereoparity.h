@@ -0,0 +1,156 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_STEREOPARITY_H
+#define CHEMKIT_STEREOPARITY_H
+
+#include "chemkit.h"
+
+#include <vector>
+
+#include "atom.h"
+#include "bond.h"
+#include "foreach.h"
+#include "stereochemistry.h"
+
+namespace chemkit {
+namespace algorithm {
+
+// The stereochemistry stored for atoms and bonds depends on the order
+// of their neighbors. The chirality of an atom describes its neighbors
+// in the order given by Atom::neighbors() (R for '@' and S for '@@' in
+// SMILES). The stereochemistry of a double bond describes the neighbor
+// with the highest atomic number on each side (the first one in
+// neighbor order if there is a tie). The functions below convert these
+// into parities relative to an ordering of the atoms by keys which do
+// not depend on the order of the atoms, such as symmetry classes.
+//
+// Each parity is 0 if the atom or bond has no stereochemistry or if it
+// can not be described by the keys because two of the neighbors have
+// the same key. Otherwise it is 1 or 2 and is the same for every
+// ordering of the atoms that gives the same keys.
+
+// Returns the parity of the atom's chirality relative to its neighbors
+// sorted by their keys.
+template<typename Key>
+inline int atomParity(const Atom *atom, const std::vector<Key> &keys)
+{
+    Stereochemistry::Type chirality = atom->chirality();
+    if(chirality != Stereochemistry::R && chirality != Stereochemistry::S){
+        return 0;
+    }
+
+    std::vector<Key> neighborKeys;
+    foreach(const Atom *neighbor, atom->neighbors()){
+        neighborKeys.push_back(keys[neighbor->index()]);
+    }
+
+    if(neighborKeys.size() < 3){
+        return 0;
+    }
+
+    // count the swaps needed to sort the neighbors
+    bool odd = false;
+    for(size_t i = 0; i < neighborKeys.size(); i++){
+        for(size_t j = i + 1; j < neighborKeys.size(); j++){
+            if(neighborKeys[i] == neighborKeys[j]){
+                return 0;
+            }
+            else if(neighborKeys[j] < neighborKeys[i]){
+                odd = !odd;
+            }
+        }
+    }
+
+    return (chirality == Stereochemistry::R) != odd ? 1 : 2;
+}
+
+// Returns the parity of the bond's stereochemistry relative to the
+// neighbor with the highest key on each side of the bond.
+template<typename Key>
+inline int bondParity(const Bond *bond, const std::vector<Key> &keys)
+{
+    Stereochemistry::Type stereochemistry = bond->stereochemistry();
+    if((stereochemistry != Stereochemistry::E && stereochemistry != Stereochemistry::Z) ||
+       bond->order() != Bond::Double){
+        return 0;
+    }
+
+    bool odd = false;
+
+    for(size_t i = 0; i < 2; i++){
+        const Atom *atom = bond->atom(i);
+        const Atom *partner = bond->otherAtom(atom);
+
+        const Atom *reference = 0;
+        const Atom *highest = 0;
+        size_t count = 0;
+
+        foreach(const Atom *neighbor, atom->neighbors()){
+            if(neighbor == partner){
+                continue;
+            }
+
+            if(!reference || neighbor->atomicNumber() > reference->atomicNumber()){
+                reference = neighbor;
+            }
+
+            if(highest && keys[neighbor->index()] == keys[highest->index()]){
+                return 0;
+            }
+            else if(!highest || keys[highest->index()] < keys[neighbor->index()]){
+                highest = neighbor;
+            }
+
+            count++;
+        }
+
+        if(count == 0 || count > 2){
+            return 0;
+        }
+
+        if(reference != highest){
+            odd = !odd;
+        }
+    }
+
+    return (stereochemistry == Stereochemistry::E) != odd ? 1 : 2;
+}
+
+} // end algorithm namespace
+} // end chemkit namespace
+
+#endif // CHEMKIT_STEREOPARITY_H
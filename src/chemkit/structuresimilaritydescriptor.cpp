@@ -48,6 +48,8 @@ class StructureSimilarityDescriptorPrivate
 {
 public:
     boost::shared_ptr<Molecule> molecule;
+    size_t nodeLimit;
+    int timeLimit;
 };
 
 // === StructureSimilarityDescriptor ======================================= //
@@ -62,6 +64,8 @@ StructureSimilarityDescriptor::StructureSimilarityDescriptor()
     : MolecularDescriptor("structure-similarity"),
       d(new StructureSimilarityDescriptorPrivate)
 {
+    d->nodeLimit = 0;
+    d->timeLimit = 0;
 }
 
 /// Creates a new structure similarity descriptor with \p molecule.
@@ -70,6 +74,8 @@ StructureSimilarityDescriptor::StructureSimilarityDescriptor(const boost::shared
       d(new StructureSimilarityDescriptorPrivate)
 {
     d->molecule = molecule;
+    d->nodeLimit = 0;
+    d->timeLimit = 0;
 }
 
 /// Destroys the structure similarity descriptor object.
@@ -91,6 +97,43 @@ boost::shared_ptr<Molecule> StructureSimilarityDescriptor::molecule() const
     return d->molecule;
 }
 
+/// Sets the maximum number of search nodes visited when calculating
+/// the maximum common substructure to \p limit. If \p limit is \c 0
+/// (the default) the number of nodes is not limited.
+///
+/// If the limit is reached the largest common substructure found so
+/// far is used, so the value may be lower than the exact similarity.
+///
+/// \see SubstructureQuery::setNodeLimit()
+void StructureSimilarityDescriptor::setNodeLimit(size_t limit)
+{
+    d->nodeLimit = limit;
+}
+
+/// Returns the maximum number of search nodes visited when
+/// calculating the maximum common substructure.
+size_t StructureSimilarityDescriptor::nodeLimit() const
+{
+    return d->nodeLimit;
+}
+
+/// Sets the maximum time in milliseconds spent calculating the
+/// maximum common substructure to \p milliseconds. If
+/// \p milliseconds is \c 0 (the default) the time is not limited.
+///
+/// \see SubstructureQuery::setTimeLimit()
+void StructureSimilarityDescriptor::setTimeLimit(int milliseconds)
+{
+    d->timeLimit = milliseconds;
+}
+
+/// Returns the maximum time in milliseconds spent calculating the
+/// maximum common substructure.
+int StructureSimilarityDescriptor::timeLimit() const
+{
+    return d->timeLimit;
+}
+
 // --- Descriptor ---------------------------------------------------------- //
 /// Returns the structure similarity value for \p molecule.
 Variant StructureSimilarityDescriptor::value(const Molecule *molecule) const
@@ -100,6 +143,9 @@ Variant StructureSimilarityDescriptor::value(const Molecule *molecule) const
     }
 
     SubstructureQuery query(d->molecule);
+    query.setNodeLimit(d->nodeLimit);
+    query.setTimeLimit(d->timeLimit);
+    query.setApproximateMappingsEnabled(true);
 
     size_t a = d->molecule->atomCount() - d->molecule->atomCount(Atom::Hydrogen);
     size_t b = molecule->atomCount() - molecule->atomCount(Atom::Hydrogen);
@@ -108,4 +154,26 @@ Variant StructureSimilarityDescriptor::value(const Molecule *molecule) const
     return Real(c) / Real(a + b - c);
 }
 
+/// Returns an upper bound on the structure similarity value for
+/// \p molecule.
+///
+/// The bound is calculated without searching for the maximum common
+/// substructure (see SubstructureQuery::maximumMappingBound()) and
+/// can be used to reject molecules which cannot be similar enough
+/// before calling value().
+Real StructureSimilarityDescriptor::maximumValue(const Molecule *molecule) const
+{
+    if(!d->molecule){
+        return 0;
+    }
+
+    SubstructureQuery query(d->molecule);
+
+    size_t a = d->molecule->atomCount() - d->molecule->atomCount(Atom::Hydrogen);
+    size_t b = molecule->atomCount() - molecule->atomCount(Atom::Hydrogen);
+    size_t c = query.maximumMappingBound(molecule);
+
+    return Real(c) / Real(a + b - c);
+}
+
 } // end chemkit namespace
@@ -60,9 +60,14 @@ public:
     // properties
     void setMolecule(const boost::shared_ptr<Molecule> &molecule);
     boost::shared_ptr<Molecule> molecule() const;
+    void setNodeLimit(size_t limit);
+    size_t nodeLimit() const;
+    void setTimeLimit(int milliseconds);
+    int timeLimit() const;
 
     // descriptor
     Variant value(const Molecule *molecule) const CHEMKIT_OVERRIDE;
+    Real maximumValue(const Molecule *molecule) const;
 
 private:
     StructureSimilarityDescriptorPrivate* const d;
@@ -0,0 +1,95 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_SUBSTRUCTUREPATTERN_INLINE_H
+#define CHEMKIT_SUBSTRUCTUREPATTERN_INLINE_H
+
+#include "substructurepattern.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the molecule for the pattern.
+inline const Molecule* SubstructurePattern::molecule() const
+{
+    return m_molecule;
+}
+
+/// Returns \c true if terminal hydrogens are included in the pattern.
+inline bool SubstructurePattern::hydrogens() const
+{
+    return m_hydrogens;
+}
+
+/// Returns the number of atoms in the pattern.
+inline size_t SubstructurePattern::size() const
+{
+    return m_atoms.size();
+}
+
+// --- Graph --------------------------------------------------------------- //
+/// Returns the atoms in the pattern in the order they are searched.
+inline const std::vector<Atom *>& SubstructurePattern::atoms() const
+{
+    return m_atoms;
+}
+
+/// Returns the pattern graph. Each vertex in the graph corresponds to
+/// the atom at the same index in atoms().
+inline const Graph<size_t>& SubstructurePattern::graph() const
+{
+    return m_graph;
+}
+
+/// Returns the index of the atom at \p index in the atoms for the
+/// molecule in SubstructureTarget::atoms().
+inline size_t SubstructurePattern::originalIndex(size_t index) const
+{
+    return m_originalIndices[index];
+}
+
+// --- Matching ------------------------------------------------------------ //
+/// Returns \c true if the atom at \p index can be matched to a
+/// target atom with \p atomicNumber and \p degree neighbors in the
+/// target graph.
+inline bool SubstructurePattern::isCompatible(size_t index, int atomicNumber, size_t degree) const
+{
+    return m_atomicNumbers[index] == atomicNumber && m_degrees[index] <= degree;
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_SUBSTRUCTUREPATTERN_INLINE_H
@@ -0,0 +1,208 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "substructurepattern.h"
+
+#include "atom.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "substructuretarget.h"
+
+namespace chemkit {
+
+namespace {
+
+// Returns the rarity of the element with atomicNumber in organic
+// molecules. Elements with a higher rarity match fewer target atoms.
+int elementRarity(int atomicNumber)
+{
+    // the most common elements, from most to least common
+    static const int commonElements[] = { 6, 1, 8, 7, 9, 16, 17, 35, 15, 53 };
+    static const int commonElementCount = sizeof(commonElements) / sizeof(commonElements[0]);
+
+    for(int i = 0; i < commonElementCount; i++){
+        if(commonElements[i] == atomicNumber){
+            return i;
+        }
+    }
+
+    return commonElementCount;
+}
+
+// The PatternAtomScore class contains the values used to order the
+// pattern atoms by how selective they are. Rarer elements are matched
+// by fewer target atoms, atoms with more neighbors have more edges to
+// check and ring atoms close rings early in the search.
+class PatternAtomScore
+{
+public:
+    PatternAtomScore()
+        : m_rarity(0),
+          m_degree(0),
+          m_ring(false)
+    {
+    }
+
+    PatternAtomScore(const Atom *atom, size_t degree)
+        : m_rarity(elementRarity(atom->atomicNumber())),
+          m_degree(degree),
+          m_ring(atom->isInRing())
+    {
+    }
+
+    bool operator<(const PatternAtomScore &other) const
+    {
+        if(m_rarity != other.m_rarity){
+            return m_rarity < other.m_rarity;
+        }
+        else if(m_degree != other.m_degree){
+            return m_degree < other.m_degree;
+        }
+        else{
+            return m_ring < other.m_ring;
+        }
+    }
+
+private:
+    int m_rarity;
+    size_t m_degree;
+    bool m_ring;
+};
+
+} // end anonymous namespace
+
+// === SubstructurePattern ================================================= //
+/// \class SubstructurePattern substructurepattern.h chemkit/substructurepattern.h
+/// \ingroup chemkit
+/// \brief The SubstructurePattern class contains a query molecule
+///        compiled for substructure searching.
+///
+/// The pattern contains the graph of the query molecule with the atoms
+/// reordered so that the most selective atoms are searched first. The
+/// search starts at the atom with the rarest element (breaking ties by
+/// the number of neighbors and then ring membership). Each following
+/// atom is the unsearched neighbor of the searched atoms with the most
+/// bonds to the searched atoms, so every atom after the first in each
+/// fragment is connected to the atoms already matched and mismatches
+/// are found as early as possible.
+///
+/// The pattern also contains the values checked for each atom before
+/// comparing its bonds (see isCompatible()).
+///
+/// SubstructureQuery compiles a pattern when its molecule or flags are
+/// set and uses it for every search. The pattern must be recreated if
+/// the molecule is modified.
+///
+/// \see SubstructureQuery, SubstructureTarget
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new substructure pattern for \p molecule. If
+/// \p hydrogens is \c false terminal hydrogens are not included.
+SubstructurePattern::SubstructurePattern(const Molecule *molecule, bool hydrogens)
+    : m_molecule(molecule),
+      m_hydrogens(hydrogens)
+{
+    SubstructureTarget source(molecule);
+    const std::vector<Atom *> &sourceAtoms = source.atoms(hydrogens);
+    const Graph<size_t> &sourceGraph = source.graph(hydrogens);
+    size_t size = sourceAtoms.size();
+
+    std::vector<PatternAtomScore> scores(size);
+    for(size_t i = 0; i < size; i++){
+        scores[i] = PatternAtomScore(sourceAtoms[i], sourceGraph.neighbors(i).size());
+    }
+
+    // the number of bonds from each atom to the ordered atoms, or -1
+    // if the atom has been ordered
+    std::vector<int> connections(size, 0);
+
+    while(m_originalIndices.size() < size){
+        // select the atom with the most connections to the ordered
+        // atoms and then the highest score. when no atom is connected
+        // this starts the next fragment at its most selective atom
+        size_t next = size;
+
+        for(size_t i = 0; i < size; i++){
+            if(connections[i] < 0){
+                continue;
+            }
+
+            if(next == size ||
+               connections[i] > connections[next] ||
+               (connections[i] == connections[next] && scores[next] < scores[i])){
+                next = i;
+            }
+        }
+
+        m_originalIndices.push_back(next);
+        connections[next] = -1;
+
+        foreach(size_t neighbor, sourceGraph.neighbors(next)){
+            if(connections[neighbor] >= 0){
+                connections[neighbor]++;
+            }
+        }
+    }
+
+    // build the reordered graph
+    std::vector<size_t> indices(size);
+    for(size_t i = 0; i < size; i++){
+        indices[m_originalIndices[i]] = i;
+    }
+
+    m_graph.resize(size);
+
+    for(size_t i = 0; i < size; i++){
+        size_t original = m_originalIndices[i];
+
+        m_atoms.push_back(sourceAtoms[original]);
+        m_atomicNumbers.push_back(sourceAtoms[original]->atomicNumber());
+        m_degrees.push_back(sourceGraph.neighbors(original).size());
+
+        foreach(size_t neighbor, sourceGraph.neighbors(original)){
+            if(original < neighbor){
+                m_graph.addEdge(i, indices[neighbor]);
+            }
+        }
+    }
+}
+
+/// Destroys the substructure pattern.
+SubstructurePattern::~SubstructurePattern()
+{
+}
+
+} // end chemkit namespace
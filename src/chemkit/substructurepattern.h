@@ -0,0 +1,88 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_SUBSTRUCTUREPATTERN_H
+#define CHEMKIT_SUBSTRUCTUREPATTERN_H
+
+#include "chemkit.h"
+
+#include <vector>
+
+#include "graph.h"
+
+namespace chemkit {
+
+class Atom;
+class Molecule;
+
+class CHEMKIT_EXPORT SubstructurePattern
+{
+public:
+    // construction and destruction
+    SubstructurePattern(const Molecule *molecule, bool hydrogens);
+    ~SubstructurePattern();
+
+    // properties
+    inline const Molecule* molecule() const;
+    inline bool hydrogens() const;
+    inline size_t size() const;
+
+    // graph
+    inline const std::vector<Atom *>& atoms() const;
+    inline const Graph<size_t>& graph() const;
+    inline size_t originalIndex(size_t index) const;
+
+    // matching
+    inline bool isCompatible(size_t index, int atomicNumber, size_t degree) const;
+
+private:
+    CHEMKIT_DISABLE_COPY(SubstructurePattern)
+
+private:
+    const Molecule *m_molecule;
+    bool m_hydrogens;
+    std::vector<Atom *> m_atoms;
+    std::vector<size_t> m_originalIndices;
+    std::vector<int> m_atomicNumbers;
+    std::vector<size_t> m_degrees;
+    Graph<size_t> m_graph;
+};
+
+} // end chemkit namespace
+
+#include "substructurepattern-inline.h"
+
+#endif // CHEMKIT_SUBSTRUCTUREPATTERN_H
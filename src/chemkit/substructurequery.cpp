@@ -35,16 +35,23 @@
 
 #include "substructurequery.h"
 
+#include <algorithm>
+
+#include <boost/bind.hpp>
 #include <boost/make_shared.hpp>
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/mcgregor_common_subgraphs.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "vf2.h"
 #include "atom.h"
 #include "bond.h"
 #include "ring.h"
 #include "foreach.h"
+#include "mcsplit.h"
 #include "molecule.h"
+#include "concurrent.h"
+#include "moleculewatcher.h"
+#include "substructurepattern.h"
+#include "substructuretarget.h"
 
 namespace chemkit {
 
@@ -52,25 +59,28 @@ namespace {
 
 struct AtomComparator
 {
-    AtomComparator(const std::vector<Atom *> &sourceAtoms, const std::vector<Atom *> &targetAtoms)
-        : m_sourceAtoms(sourceAtoms),
-          m_targetAtoms(targetAtoms)
+    AtomComparator(const SubstructurePattern &pattern, const std::vector<Atom *> &targetAtoms, const Graph<size_t> &targetGraph)
+        : m_pattern(pattern),
+          m_targetAtoms(targetAtoms),
+          m_targetGraph(targetGraph)
     {
     }
 
     AtomComparator(const AtomComparator &other)
-        : m_sourceAtoms(other.m_sourceAtoms),
-          m_targetAtoms(other.m_targetAtoms)
+        : m_pattern(other.m_pattern),
+          m_targetAtoms(other.m_targetAtoms),
+          m_targetGraph(other.m_targetGraph)
     {
     }
 
     bool operator()(size_t a, size_t b) const
     {
-        return m_sourceAtoms[a]->atomicNumber() == m_targetAtoms[b]->atomicNumber();
+        return m_pattern.isCompatible(a, m_targetAtoms[b]->atomicNumber(), m_targetGraph.neighbors(b).size());
     }
 
-    const std::vector<Atom *> &m_sourceAtoms;
+    const SubstructurePattern &m_pattern;
     const std::vector<Atom *> &m_targetAtoms;
+    const Graph<size_t> &m_targetGraph;
 };
 
 struct BondComparator
@@ -112,134 +122,145 @@ struct BondComparator
     int m_flags;
 };
 
-typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS> AdjacencyListGraph;
-
-struct AdjacencyListGraphVertexComparator
+// Perceives the aromaticity of the atoms and bonds in molecule now
+// rather than when it is first needed during a search.
+void perceiveAromaticity(const Molecule *molecule)
 {
-    AdjacencyListGraphVertexComparator(const std::vector<Atom *> &sourceAtoms,
-                                       const std::vector<Atom *> &targetAtoms)
-        : m_sourceAtoms(sourceAtoms),
-          m_targetAtoms(targetAtoms)
-    {
+    if(molecule->bondCount() > 0){
+        molecule->bond(0)->isAromatic();
     }
+}
 
-    AdjacencyListGraphVertexComparator(const AdjacencyListGraphVertexComparator &other)
-        : m_sourceAtoms(other.m_sourceAtoms),
-          m_targetAtoms(other.m_targetAtoms)
+// Perceives the aromaticity of each molecule and stores its screen
+// in its result cache. Used by the concurrent filter() before
+// searching.
+class PrepareMoleculeTask
+{
+public:
+    PrepareMoleculeTask(const std::vector<Molecule *> &molecules, int flags, bool screeningEnabled)
+        : m_molecules(molecules),
+          m_flags(flags),
+          m_screeningEnabled(screeningEnabled)
     {
     }
 
-    bool operator()(const boost::graph_traits<AdjacencyListGraph>::vertex_descriptor &vertexA,
-                    const boost::graph_traits<AdjacencyListGraph>::vertex_descriptor &vertexB)
+    void operator()(size_t index) const
     {
-        return m_sourceAtoms[vertexA]->atomicNumber() == m_targetAtoms[vertexB]->atomicNumber();
+        const Molecule *molecule = m_molecules[index];
+
+        if(m_flags & SubstructureQuery::CompareAromaticity){
+            perceiveAromaticity(molecule);
+        }
+
+        if(m_screeningEnabled && molecule->isResultCacheEnabled()){
+            SubstructureTarget::screen(molecule,
+                                       m_flags & SubstructureQuery::CompareHydrogens,
+                                       !(m_flags & SubstructureQuery::CompareAromaticity));
+        }
     }
 
-    const std::vector<Atom *> &m_sourceAtoms;
-    const std::vector<Atom *> &m_targetAtoms;
+private:
+    const std::vector<Molecule *> &m_molecules;
+    int m_flags;
+    bool m_screeningEnabled;
 };
 
-struct AdjacencyListGraphEdgeComparator
+// Checks if the query matches each molecule. Used by the concurrent
+// filter().
+class FilterTask
 {
-    AdjacencyListGraphEdgeComparator(const AdjacencyListGraph &source,
-                                     const AdjacencyListGraph &target,
-                                     const std::vector<Atom *> &sourceAtoms,
-                                     const std::vector<Atom *> &targetAtoms,
-                                     int flags)
-        : m_source(source),
-          m_target(target),
-          m_sourceAtoms(sourceAtoms),
-          m_targetAtoms(targetAtoms),
-          m_flags(flags)
+public:
+    FilterTask(const SubstructureQuery &query, const std::vector<Molecule *> &molecules, std::vector<char> &matches)
+        : m_query(query),
+          m_molecules(molecules),
+          m_matches(matches)
     {
     }
 
-    AdjacencyListGraphEdgeComparator(const AdjacencyListGraphEdgeComparator &other)
-        : m_source(other.m_source),
-          m_target(other.m_target),
-          m_sourceAtoms(other.m_sourceAtoms),
-          m_targetAtoms(other.m_targetAtoms),
-          m_flags(other.m_flags)
+    void operator()(size_t index) const
     {
+        m_matches[index] = m_query.matches(m_molecules[index]);
     }
 
-    bool operator()(const boost::graph_traits<AdjacencyListGraph>::edge_descriptor &edgeA,
-                    const boost::graph_traits<AdjacencyListGraph>::edge_descriptor &edgeB)
+private:
+    const SubstructureQuery &m_query;
+    const std::vector<Molecule *> &m_molecules;
+    std::vector<char> &m_matches;
+};
+
+// Visitor which creates a moiety for each mapping found by vf2. The
+// atoms in each moiety are in the same order as the atoms in the
+// substructure molecule rather than the order they were searched in.
+class MoietyVisitor
+{
+public:
+    MoietyVisitor(const SubstructurePattern &pattern, const std::vector<Atom *> &targetAtoms, std::vector<Moiety> &moieties)
+        : m_pattern(pattern),
+          m_targetAtoms(targetAtoms),
+          m_moieties(moieties)
     {
-        size_t a1 = boost::source(edgeA, m_source);
-        size_t a2 = boost::target(edgeA, m_source);
-        size_t b1 = boost::source(edgeB, m_target);
-        size_t b2 = boost::target(edgeB, m_target);
+    }
 
-        const Bond *bondA = m_sourceAtoms[a1]->bondTo(m_sourceAtoms[a2]);
-        const Bond *bondB = m_targetAtoms[b1]->bondTo(m_targetAtoms[b2]);
+    bool operator()(const std::vector<size_t> &mapping)
+    {
+        std::vector<Atom *> atoms(mapping.size());
 
-        if(!bondA || !bondB){
-            return false;
+        for(size_t i = 0; i < mapping.size(); i++){
+            atoms[m_pattern.originalIndex(i)] = m_targetAtoms[mapping[i]];
         }
 
-        if(m_flags & SubstructureQuery::CompareAromaticity){
-            return (bondA->order() == bondB->order()) ||
-                   (bondA->isAromatic() && bondB->isAromatic());
-        }
-        else{
-            return bondA->order() == bondB->order();
-        }
+        m_moieties.push_back(Moiety(atoms));
+
+        return true;
     }
 
-    const AdjacencyListGraph &m_source;
-    const AdjacencyListGraph &m_target;
-    const std::vector<Atom *> &m_sourceAtoms;
+private:
+    const SubstructurePattern &m_pattern;
     const std::vector<Atom *> &m_targetAtoms;
-    int m_flags;
+    std::vector<Moiety> &m_moieties;
 };
 
-struct McgregorCommonSubgraphsCallback
+// Returns the label for each atom used by the maximum common
+// substructure search. Atoms can only be matched if they have the
+// same label.
+std::vector<int> mcsVertexLabels(const std::vector<Atom *> &atoms)
 {
-    McgregorCommonSubgraphsCallback(const AdjacencyListGraph &source,
-                                    const AdjacencyListGraph &target,
-                                    std::map<size_t, size_t> &mapping)
-        : m_source(source),
-          m_target(target),
-          m_mapping(mapping)
-    {
-    }
+    std::vector<int> labels(atoms.size());
 
-    McgregorCommonSubgraphsCallback(const McgregorCommonSubgraphsCallback &other)
-        : m_source(other.m_source),
-          m_target(other.m_target),
-          m_mapping(other.m_mapping)
-    {
+    for(size_t i = 0; i < atoms.size(); i++){
+        labels[i] = atoms[i]->atomicNumber();
     }
 
-    std::map<size_t, size_t> mapping() const
-    {
-        return m_mapping;
-    }
+    return labels;
+}
 
-    template<typename MapType>
-    bool operator()(MapType map1To2,
-                    MapType map2To1,
-                    typename boost::graph_traits<AdjacencyListGraph>::vertices_size_type size)
-    {
-        CHEMKIT_UNUSED(map2To1);
-        CHEMKIT_UNUSED(size);
-
-        if(m_mapping.empty()){
-            BGL_FORALL_VERTICES_T(vertex1, m_source, AdjacencyListGraph){
-                if(boost::get(map1To2, vertex1) != boost::graph_traits<AdjacencyListGraph>::null_vertex()) {
-                    m_mapping[vertex1] = boost::get(map1To2, vertex1);
-                }
+// Returns the labels for the bonds to the neighbors of each vertex in
+// graph used by the maximum common substructure search. The labels are
+// the bond orders. If the CompareAromaticity flag is set aromatic bonds
+// are given a label that no bond order has so that they only match
+// other aromatic bonds.
+std::vector<std::vector<int> > mcsEdgeLabels(const Graph<size_t> &graph, const std::vector<Atom *> &atoms, int flags)
+{
+    std::vector<std::vector<int> > labels(graph.size());
+
+    for(size_t i = 0; i < graph.size(); i++){
+        const std::vector<size_t> &neighbors = graph.neighbors(i);
+        labels[i].resize(neighbors.size());
+
+        for(size_t j = 0; j < neighbors.size(); j++){
+            const Bond *bond = atoms[i]->bondTo(atoms[neighbors[j]]);
+
+            if(flags & SubstructureQuery::CompareAromaticity && bond->isAromatic()){
+                labels[i][j] = Bond::Quadruple + 1;
+            }
+            else{
+                labels[i][j] = bond->order();
             }
         }
-
-        return false;
     }
 
-    const AdjacencyListGraph &m_source;
-    const AdjacencyListGraph &m_target;
-    std::map<size_t, size_t> &m_mapping;
-};
+    return labels;
+}
 
 } // end anonymous namespace
 
@@ -247,10 +268,242 @@ struct McgregorCommonSubgraphsCallback
 class SubstructureQueryPrivate
 {
 public:
+    SubstructureQueryPrivate();
+
     boost::shared_ptr<Molecule> molecule;
+    MoleculeWatcher watcher;
+    bool prepared;
     int flags;
+    bool screeningEnabled;
+    Bitset screen;
+    boost::scoped_ptr<SubstructurePattern> pattern;
+    size_t nodeLimit;
+    int timeLimit;
+    bool approximateMappingsEnabled;
+
+    void setMolecule(const boost::shared_ptr<Molecule> &molecule);
+    void moleculeChanged();
+    void prepare();
+    void update();
+    bool screenMolecule(const Molecule *molecule) const;
+    bool screenTarget(const SubstructureTarget &target) const;
+    std::map<Atom *, Atom *> mapping(const SubstructureTarget &target) const;
+    std::vector<Moiety> findAll(const SubstructureTarget &target) const;
+    size_t count(const SubstructureTarget &target) const;
+    Moiety moiety(const std::map<Atom *, Atom *> &mapping) const;
 };
 
+SubstructureQueryPrivate::SubstructureQueryPrivate()
+    : prepared(false)
+{
+    watcher.atomAdded.connect(boost::bind(&SubstructureQueryPrivate::moleculeChanged, this));
+    watcher.atomRemoved.connect(boost::bind(&SubstructureQueryPrivate::moleculeChanged, this));
+    watcher.atomElementChanged.connect(boost::bind(&SubstructureQueryPrivate::moleculeChanged, this));
+    watcher.bondAdded.connect(boost::bind(&SubstructureQueryPrivate::moleculeChanged, this));
+    watcher.bondRemoved.connect(boost::bind(&SubstructureQueryPrivate::moleculeChanged, this));
+    watcher.bondOrderChanged.connect(boost::bind(&SubstructureQueryPrivate::moleculeChanged, this));
+}
+
+// Sets the substructure molecule and watches it for changes. The
+// watcher is moved first because assigning the molecule may destroy
+// the molecule it was watching.
+void SubstructureQueryPrivate::setMolecule(const boost::shared_ptr<Molecule> &molecule)
+{
+    watcher.setMolecule(molecule.get());
+    this->molecule = molecule;
+}
+
+// Called when the structure of the substructure molecule changes. The
+// pattern refers to the molecule's atoms so it is not used again until
+// it has been compiled from the new structure by update().
+void SubstructureQueryPrivate::moleculeChanged()
+{
+    prepared = false;
+}
+
+// Prepares the substructure molecule for searching. Everything that
+// the searches need from the substructure molecule which would
+// otherwise be calculated lazily is calculated here so that searches
+// never modify the query and can be run concurrently. The molecule is
+// also compiled into the pattern used by every vf2 search.
+void SubstructureQueryPrivate::prepare()
+{
+    screen.clear();
+    pattern.reset();
+
+    if(!molecule){
+        return;
+    }
+
+    if(flags & SubstructureQuery::CompareAromaticity){
+        perceiveAromaticity(molecule.get());
+    }
+
+    pattern.reset(new SubstructurePattern(molecule.get(), flags & SubstructureQuery::CompareHydrogens));
+
+    if(screeningEnabled){
+        bool hydrogens = flags & SubstructureQuery::CompareHydrogens;
+        bool bondOrders = !(flags & SubstructureQuery::CompareAromaticity);
+
+        SubstructureTarget source(molecule.get());
+        screen = source.screen(hydrogens, bondOrders);
+    }
+
+    prepared = true;
+}
+
+// Prepares the substructure molecule again if it has been modified
+// since it was last prepared.
+void SubstructureQueryPrivate::update()
+{
+    if(!prepared){
+        prepare();
+    }
+}
+
+// Returns false if the molecule can not contain the substructure
+// molecule. This is the same as screenTarget() but does not require
+// a target to be built for the molecule.
+bool SubstructureQueryPrivate::screenMolecule(const Molecule *molecule) const
+{
+    if(!screeningEnabled || !this->molecule){
+        return true;
+    }
+
+    bool hydrogens = flags & SubstructureQuery::CompareHydrogens;
+    bool bondOrders = !(flags & SubstructureQuery::CompareAromaticity);
+
+    return screen.is_subset_of(SubstructureTarget::screen(molecule, hydrogens, bondOrders));
+}
+
+// Returns false if the target can not contain the substructure
+// molecule because its screen does not contain every bit set in
+// the substructure molecule's screen.
+bool SubstructureQueryPrivate::screenTarget(const SubstructureTarget &target) const
+{
+    if(!screeningEnabled || !molecule){
+        return true;
+    }
+
+    bool hydrogens = flags & SubstructureQuery::CompareHydrogens;
+    bool bondOrders = !(flags & SubstructureQuery::CompareAromaticity);
+
+    return screen.is_subset_of(target.screen(hydrogens, bondOrders));
+}
+
+// Returns a mapping between the atoms in the substructure molecule
+// and the atoms in the molecule for target. The target is not
+// screened.
+std::map<Atom *, Atom *> SubstructureQueryPrivate::mapping(const SubstructureTarget &target) const
+{
+    if(!pattern){
+        return std::map<Atom *, Atom *>();
+    }
+
+    bool hydrogens = flags & SubstructureQuery::CompareHydrogens;
+
+    const SubstructurePattern &pattern = *this->pattern;
+    const std::vector<Atom *> &sourceAtoms = pattern.atoms();
+    const std::vector<Atom *> &targetAtoms = target.atoms(hydrogens);
+    const Graph<size_t> &targetGraph = target.graph(hydrogens);
+
+    AtomComparator atomComparator(pattern, targetAtoms, targetGraph);
+    BondComparator bondComparator(sourceAtoms, targetAtoms, flags);
+
+    // run vf2 isomorphism algorithm
+    std::vector<size_t> mapping;
+    bool found = chemkit::algorithm::vf2(pattern.graph(),
+                                         targetGraph,
+                                         atomComparator,
+                                         bondComparator,
+                                         mapping);
+
+    // check for exact match
+    if(!found || (flags & SubstructureQuery::CompareExact && mapping.size() != sourceAtoms.size())){
+        return std::map<Atom *, Atom *>();
+    }
+
+    // convert index mapping to an atom mapping
+    std::map<Atom *, Atom *> atomMapping;
+
+    for(size_t i = 0; i < mapping.size(); i++){
+        atomMapping[sourceAtoms[i]] = targetAtoms[mapping[i]];
+    }
+
+    return atomMapping;
+}
+
+// Returns a moiety for each occurrence of the substructure molecule
+// in the molecule for target. The target is not screened.
+std::vector<Moiety> SubstructureQueryPrivate::findAll(const SubstructureTarget &target) const
+{
+    std::vector<Moiety> moieties;
+
+    if(!pattern || molecule->isEmpty()){
+        return moieties;
+    }
+
+    bool hydrogens = flags & SubstructureQuery::CompareHydrogens;
+
+    const SubstructurePattern &pattern = *this->pattern;
+    const std::vector<Atom *> &targetAtoms = target.atoms(hydrogens);
+    const Graph<size_t> &targetGraph = target.graph(hydrogens);
+
+    AtomComparator atomComparator(pattern, targetAtoms, targetGraph);
+    BondComparator bondComparator(pattern.atoms(), targetAtoms, flags);
+    MoietyVisitor visitor(pattern, targetAtoms, moieties);
+
+    chemkit::algorithm::vf2Enumerate(pattern.graph(),
+                                     targetGraph,
+                                     atomComparator,
+                                     bondComparator,
+                                     visitor);
+
+    return moieties;
+}
+
+// Returns the number of occurrences of the substructure molecule in
+// the molecule for target. The target is not screened.
+size_t SubstructureQueryPrivate::count(const SubstructureTarget &target) const
+{
+    if(!pattern || molecule->isEmpty()){
+        return 0;
+    }
+
+    bool hydrogens = flags & SubstructureQuery::CompareHydrogens;
+
+    const SubstructurePattern &pattern = *this->pattern;
+    const std::vector<Atom *> &targetAtoms = target.atoms(hydrogens);
+    const Graph<size_t> &targetGraph = target.graph(hydrogens);
+
+    AtomComparator atomComparator(pattern, targetAtoms, targetGraph);
+    BondComparator bondComparator(pattern.atoms(), targetAtoms, flags);
+
+    return chemkit::algorithm::vf2Count(pattern.graph(),
+                                        targetGraph,
+                                        atomComparator,
+                                        bondComparator);
+}
+
+// Returns a moiety containing the atoms in mapping in the order of
+// the atoms in the substructure molecule.
+Moiety SubstructureQueryPrivate::moiety(const std::map<Atom *, Atom *> &mapping) const
+{
+    // no mapping found, return empty moiety
+    if(mapping.empty()){
+        return Moiety();
+    }
+
+    std::vector<Atom *> atoms;
+
+    foreach(Atom *atom, molecule->atoms()){
+        std::map<Atom *, Atom *>::const_iterator iter = mapping.find(atom);
+        atoms.push_back(iter != mapping.end() ? iter->second : 0);
+    }
+
+    return Moiety(atoms);
+}
+
 // === SubstructureQuery =================================================== //
 /// \class SubstructureQuery substructurequery.h chemkit/substructurequery.h
 /// \ingroup chemkit
@@ -262,6 +515,11 @@ SubstructureQuery::SubstructureQuery()
   : d(new SubstructureQueryPrivate)
 {
     d->flags = 0;
+    d->screeningEnabled = false;
+    d->nodeLimit = 0;
+    d->timeLimit = 0;
+    d->approximateMappingsEnabled = false;
+    d->prepare();
 }
 
 /// Creates a new substructure query with \p molecule as the
@@ -269,8 +527,13 @@ SubstructureQuery::SubstructureQuery()
 SubstructureQuery::SubstructureQuery(const boost::shared_ptr<Molecule> &molecule)
     : d(new SubstructureQueryPrivate)
 {
-    d->molecule = molecule;
+    d->setMolecule(molecule);
     d->flags = 0;
+    d->screeningEnabled = false;
+    d->nodeLimit = 0;
+    d->timeLimit = 0;
+    d->approximateMappingsEnabled = false;
+    d->prepare();
 }
 
 /// Creates a new substructure query with \p formula in \p format as
@@ -278,8 +541,13 @@ SubstructureQuery::SubstructureQuery(const boost::shared_ptr<Molecule> &molecule
 SubstructureQuery::SubstructureQuery(const std::string &formula, const std::string &format)
     : d(new SubstructureQueryPrivate)
 {
-    d->molecule = boost::make_shared<Molecule>(formula, format);
+    d->setMolecule(boost::make_shared<Molecule>(formula, format));
     d->flags = 0;
+    d->screeningEnabled = false;
+    d->nodeLimit = 0;
+    d->timeLimit = 0;
+    d->approximateMappingsEnabled = false;
+    d->prepare();
 }
 
 /// Destroys the substructure query object.
@@ -290,9 +558,15 @@ SubstructureQuery::~SubstructureQuery()
 
 // --- Properties ---------------------------------------------------------- //
 /// Sets the substructure molecule to \p molecule.
+///
+/// The molecule is compiled into a SubstructurePattern which orders
+/// its atoms so that the most selective atoms are matched first. If
+/// the molecule is modified the pattern is compiled again before the
+/// next search.
 void SubstructureQuery::setMolecule(const boost::shared_ptr<Molecule> &molecule)
 {
-    d->molecule = molecule;
+    d->setMolecule(molecule);
+    d->prepare();
 }
 
 /// Sets the substructure molecule to \p formula with \p format.
@@ -302,6 +576,10 @@ void SubstructureQuery::setMolecule(const std::string &formula, const std::strin
 }
 
 /// Returns the substructure molecule.
+///
+/// The molecule may be modified. The query is updated for the new
+/// structure before it is next searched, so the molecule must not be
+/// modified while searches are running in other threads.
 boost::shared_ptr<Molecule> SubstructureQuery::molecule() const
 {
     return d->molecule;
@@ -311,6 +589,7 @@ boost::shared_ptr<Molecule> SubstructureQuery::molecule() const
 void SubstructureQuery::setFlags(int flags)
 {
     d->flags = flags;
+    d->prepare();
 }
 
 /// Returns the query flags.
@@ -319,6 +598,88 @@ int SubstructureQuery::flags() const
     return d->flags;
 }
 
+/// Sets whether screening is enabled for the query to \p enabled.
+///
+/// When enabled, the screen of the substructure molecule is compared
+/// with the screen of each target molecule before running the full
+/// isomorphism search. Targets whose screen does not contain every
+/// bit set in the query's screen cannot match and are rejected
+/// without being searched. Screening never changes the result of a
+/// query, only how quickly it is found.
+///
+/// Screening is disabled by default. When searching molecules the
+/// screen is checked before the target graphs are built, so rejected
+/// molecules are never prepared for the full search. It is most useful
+/// when the same molecules are searched with many queries, either as
+/// SubstructureTarget objects or as molecules with their result cache
+/// enabled, because then each screen is only calculated once.
+///
+/// \see SubstructureTarget::screen()
+void SubstructureQuery::setScreeningEnabled(bool enabled)
+{
+    d->screeningEnabled = enabled;
+    d->prepare();
+}
+
+/// Returns \c true if screening is enabled for the query.
+bool SubstructureQuery::isScreeningEnabled() const
+{
+    return d->screeningEnabled;
+}
+
+/// Sets the maximum number of search nodes visited by
+/// maximumMapping() to \p limit. If \p limit is \c 0 (the default)
+/// the number of nodes is not limited.
+///
+/// \see setTimeLimit(), setApproximateMappingsEnabled()
+void SubstructureQuery::setNodeLimit(size_t limit)
+{
+    d->nodeLimit = limit;
+}
+
+/// Returns the maximum number of search nodes visited by
+/// maximumMapping().
+size_t SubstructureQuery::nodeLimit() const
+{
+    return d->nodeLimit;
+}
+
+/// Sets the maximum time in milliseconds spent in each call to
+/// maximumMapping() to \p milliseconds. If \p milliseconds is \c 0
+/// (the default) the time is not limited.
+///
+/// \see setNodeLimit(), setApproximateMappingsEnabled()
+void SubstructureQuery::setTimeLimit(int milliseconds)
+{
+    d->timeLimit = milliseconds;
+}
+
+/// Returns the maximum time in milliseconds spent in each call to
+/// maximumMapping().
+int SubstructureQuery::timeLimit() const
+{
+    return d->timeLimit;
+}
+
+/// Sets whether approximate mappings are enabled to \p enabled.
+///
+/// When maximumMapping() is stopped by the node or time limit before
+/// the maximum mapping is found it returns an empty mapping. If
+/// approximate mappings are enabled it instead returns the largest
+/// mapping found before the search was stopped.
+///
+/// Approximate mappings are disabled by default.
+void SubstructureQuery::setApproximateMappingsEnabled(bool enabled)
+{
+    d->approximateMappingsEnabled = enabled;
+}
+
+/// Returns \c true if approximate mappings are enabled.
+bool SubstructureQuery::isApproximateMappingsEnabled() const
+{
+    return d->approximateMappingsEnabled;
+}
+
 // --- Queries ------------------------------------------------------------- //
 /// Returns \c true if the substructure molecule matches \p molecule.
 ///
@@ -349,192 +710,150 @@ bool SubstructureQuery::matches(const Molecule *molecule) const
     return !mapping(molecule).empty();
 }
 
-/// Returns a mapping (also known as an isomorphism) between the
-/// atoms in the substructure molecule and the atoms in \p molecule.
-std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule) const
+/// Returns \c true if the substructure molecule matches the molecule
+/// in \p target.
+bool SubstructureQuery::matches(const SubstructureTarget &target) const
 {
-    Graph<size_t> source;
-    Graph<size_t> target;
-
-    std::vector<Atom *> sourceAtoms;
-    std::vector<Atom *> targetAtoms;
-
-    if(d->flags & CompareHydrogens){
-        source.resize(d->molecule->size());
-        sourceAtoms = std::vector<Atom *>(d->molecule->atoms().begin(), d->molecule->atoms().end());
-
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, d->molecule->bonds()){
-                source.addEdge(bond->atom1()->index(), bond->atom2()->index());
-            }
-        }
-
-        target.resize(molecule->size());
-        targetAtoms = std::vector<Atom *>(molecule->atoms().begin(), molecule->atoms().end());
-
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, molecule->bonds()){
-                target.addEdge(bond->atom1()->index(), bond->atom2()->index());
-            }
-        }
+    if(!d->molecule){
+        return false;
     }
-    else{
-        foreach(Atom *atom, d->molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                sourceAtoms.push_back(atom);
-            }
-        }
-
-        foreach(Atom *atom, molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                targetAtoms.push_back(atom);
-            }
-        }
 
-        source.resize(sourceAtoms.size());
-        target.resize(targetAtoms.size());
-
-        if(!(d->flags & CompareAtomsOnly)){
-            for(size_t i = 0; i < sourceAtoms.size(); i++){
-                for(size_t j = i + 1; j < sourceAtoms.size(); j++){
-                    if(sourceAtoms[i]->isBondedTo(sourceAtoms[j])){
-                        source.addEdge(i, j);
-                    }
-                }
-            }
-
-            for(size_t i = 0; i < targetAtoms.size(); i++){
-                for(size_t j = i + 1; j < targetAtoms.size(); j++){
-                    if(targetAtoms[i]->isBondedTo(targetAtoms[j])){
-                        target.addEdge(i, j);
-                    }
-                }
-            }
-        }
+    if(d->molecule->isEmpty()){
+        return true;
     }
 
-    AtomComparator atomComparator(sourceAtoms, targetAtoms);
-    BondComparator bondComparator(sourceAtoms, targetAtoms, d->flags);
+    return !mapping(target).empty();
+}
 
-    // run vf2 isomorphism algorithm
-    std::map<size_t, size_t> mapping = chemkit::algorithm::vf2(source,
-                                                               target,
-                                                               atomComparator,
-                                                               bondComparator);
+/// Returns a mapping (also known as an isomorphism) between the
+/// atoms in the substructure molecule and the atoms in \p molecule.
+std::map<Atom *, Atom *> SubstructureQuery::mapping(const Molecule *molecule) const
+{
+    d->update();
 
-    // check for exact match
-    if(d->flags & CompareExact && mapping.size() != source.size()){
+    // the target is only built for molecules that pass the screen
+    if(!d->screenMolecule(molecule)){
         return std::map<Atom *, Atom *>();
     }
 
-    // convert index mapping to an atom mapping
-    std::map<Atom *, Atom *> atomMapping;
+    SubstructureTarget target(molecule);
 
-    for(std::map<size_t, size_t>::iterator i = mapping.begin(); i != mapping.end(); ++i){
-        atomMapping[sourceAtoms[i->first]] = targetAtoms[i->second];
+    return d->mapping(target);
+}
+
+/// Returns a mapping between the atoms in the substructure molecule
+/// and the atoms in the molecule for \p target.
+std::map<Atom *, Atom *> SubstructureQuery::mapping(const SubstructureTarget &target) const
+{
+    d->update();
+
+    if(!d->screenTarget(target)){
+        return std::map<Atom *, Atom *>();
     }
 
-    return atomMapping;
+    return d->mapping(target);
 }
 
 /// Returns the maximum mapping (also known as maximum common
 /// substructure or MCS) between the query molecule and \p molecule.
+///
+/// The search can take a long time for large molecules. It can be
+/// bounded with setNodeLimit() and setTimeLimit().
+///
+/// \see maximumMappingBound()
 std::map<Atom *, Atom *> SubstructureQuery::maximumMapping(const Molecule *molecule) const
 {
-    AdjacencyListGraph source;
-    AdjacencyListGraph target;
-
-    std::vector<Atom *> sourceAtoms;
-    std::vector<Atom *> targetAtoms;
-
-    if(d->flags & CompareHydrogens){
-        for(size_t i = 0; i < d->molecule->size(); i++){
-            boost::add_vertex(source);
-        }
-
-        sourceAtoms = std::vector<Atom *>(d->molecule->atoms().begin(), d->molecule->atoms().end());
+    SubstructureTarget target(molecule);
 
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, d->molecule->bonds()){
-                boost::add_edge(bond->atom1()->index(), bond->atom2()->index(), source);
-            }
-        }
+    return maximumMapping(target);
+}
 
-        for(size_t i = 0; i < molecule->size(); i++){
-            boost::add_vertex(target);
-        }
+/// Returns the maximum mapping between the query molecule and the
+/// molecule for \p target.
+std::map<Atom *, Atom *> SubstructureQuery::maximumMapping(const SubstructureTarget &target) const
+{
+    d->update();
 
-        targetAtoms = std::vector<Atom *>(molecule->atoms().begin(), molecule->atoms().end());
+    std::map<Atom *, Atom *> atomMapping;
 
-        if(!(d->flags & CompareAtomsOnly)){
-            foreach(const Bond *bond, molecule->bonds()){
-                boost::add_edge(bond->atom1()->index(), bond->atom2()->index(), target);
-            }
-        }
+    if(!d->molecule){
+        return atomMapping;
     }
-    else{
-        foreach(Atom *atom, d->molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                sourceAtoms.push_back(atom);
-                boost::add_vertex(source);
-            }
-        }
 
-        foreach(Atom *atom, molecule->atoms()){
-            if(!atom->isTerminalHydrogen()){
-                targetAtoms.push_back(atom);
-                boost::add_vertex(target);
-            }
-        }
+    bool hydrogens = d->flags & CompareHydrogens;
 
-        if(!(d->flags & CompareAtomsOnly)){
-            for(size_t i = 0; i < sourceAtoms.size(); i++){
-                for(size_t j = i + 1; j < sourceAtoms.size(); j++){
-                    if(sourceAtoms[i]->isBondedTo(sourceAtoms[j])){
-                        boost::add_edge(i, j, source);
-                    }
-                }
-            }
-
-            for(size_t i = 0; i < targetAtoms.size(); i++){
-                for(size_t j = i + 1; j < targetAtoms.size(); j++){
-                    if(targetAtoms[i]->isBondedTo(targetAtoms[j])){
-                        boost::add_edge(i, j, target);
-                    }
-                }
-            }
-        }
-    }
-
-    AdjacencyListGraphVertexComparator vertexComparator(sourceAtoms, targetAtoms);
-    AdjacencyListGraphEdgeComparator edgeComparator(source, target, sourceAtoms, targetAtoms, d->flags);
+    SubstructureTarget source(d->molecule.get());
+    const std::vector<Atom *> &sourceAtoms = source.atoms(hydrogens);
+    const std::vector<Atom *> &targetAtoms = target.atoms(hydrogens);
+    const Graph<size_t> &sourceGraph = source.graph(hydrogens);
+    const Graph<size_t> &targetGraph = target.graph(hydrogens);
 
-    std::map<size_t, size_t> mapping;
-    McgregorCommonSubgraphsCallback callback(source, target, mapping);
+    std::vector<int> sourceVertexLabels = mcsVertexLabels(sourceAtoms);
+    std::vector<int> targetVertexLabels = mcsVertexLabels(targetAtoms);
+    std::vector<std::vector<int> > sourceEdgeLabels = mcsEdgeLabels(sourceGraph, sourceAtoms, d->flags);
+    std::vector<std::vector<int> > targetEdgeLabels = mcsEdgeLabels(targetGraph, targetAtoms, d->flags);
 
     // search for connected subgraphs if the query molecule
     // consists only of a single connected component
     bool onlyConnectedSubgraphs = !d->molecule->isFragmented();
 
-    boost::mcgregor_common_subgraphs_maximum_unique(source,
-                                                    target,
-                                                    boost::get(boost::vertex_index, source),
-                                                    boost::get(boost::vertex_index, target),
-                                                    edgeComparator,
-                                                    vertexComparator,
-                                                    onlyConnectedSubgraphs,
-                                                    callback);
+    std::vector<std::pair<size_t, size_t> > mapping;
+    bool complete = chemkit::algorithm::mcsplit(sourceGraph,
+                                                sourceVertexLabels,
+                                                sourceEdgeLabels,
+                                                targetGraph,
+                                                targetVertexLabels,
+                                                targetEdgeLabels,
+                                                onlyConnectedSubgraphs,
+                                                d->nodeLimit,
+                                                d->timeLimit,
+                                                mapping);
+
+    if(!complete && !d->approximateMappingsEnabled){
+        return atomMapping;
+    }
 
     // convert index mapping to an atom mapping
-    std::map<Atom *, Atom *> atomMapping;
-
-    for(std::map<size_t, size_t>::iterator i = mapping.begin(); i != mapping.end(); ++i){
-        atomMapping[sourceAtoms[i->first]] = targetAtoms[i->second];
+    for(size_t i = 0; i < mapping.size(); i++){
+        atomMapping[sourceAtoms[mapping[i].first]] = targetAtoms[mapping[i].second];
     }
 
     return atomMapping;
 }
 
+/// Returns an upper bound on the size of the maximum mapping between
+/// the query molecule and \p molecule.
+///
+/// The bound is calculated from the number of atoms of each element
+/// in the two molecules without searching and is much faster to
+/// calculate than the maximum mapping. It can be used to reject
+/// molecules which cannot have a large enough maximum mapping before
+/// calling maximumMapping().
+size_t SubstructureQuery::maximumMappingBound(const Molecule *molecule) const
+{
+    SubstructureTarget target(molecule);
+
+    return maximumMappingBound(target);
+}
+
+/// Returns an upper bound on the size of the maximum mapping between
+/// the query molecule and the molecule for \p target.
+size_t SubstructureQuery::maximumMappingBound(const SubstructureTarget &target) const
+{
+    d->update();
+
+    if(!d->molecule){
+        return 0;
+    }
+
+    bool hydrogens = d->flags & CompareHydrogens;
+
+    SubstructureTarget source(d->molecule.get());
+
+    return chemkit::algorithm::mcsplitBound(mcsVertexLabels(source.atoms(hydrogens)),
+                                            mcsVertexLabels(target.atoms(hydrogens)));
+}
+
 /// Returns a vector containing each molecule in \p molecules that
 /// matches the substructure molecule.
 std::vector<Molecule *> SubstructureQuery::filter(const std::vector<Molecule *> &molecules) const
@@ -550,6 +869,51 @@ std::vector<Molecule *> SubstructureQuery::filter(const std::vector<Molecule *>
     return matchingMolecules;
 }
 
+/// Returns a vector containing each molecule in \p molecules that
+/// matches the substructure molecule. The molecules are searched
+/// concurrently using \p threadCount threads, or one thread for each
+/// processor if \p threadCount is \c 0. The matching molecules are
+/// returned in the same order as they are in \p molecules.
+///
+/// The query and the molecules must not be modified until the filter
+/// has finished.
+std::vector<Molecule *> SubstructureQuery::filter(const std::vector<Molecule *> &molecules, size_t threadCount) const
+{
+    std::vector<Molecule *> matchingMolecules;
+
+    if(!d->molecule){
+        return matchingMolecules;
+    }
+
+    // the query is updated before the search so that the threads
+    // only read from it
+    d->update();
+
+    // aromaticity and cached screens are calculated lazily so they
+    // are calculated for each molecule (only once if it is listed more
+    // than once) before the molecules are searched concurrently
+    if(d->flags & CompareAromaticity || d->screeningEnabled){
+        std::vector<Molecule *> uniqueMolecules = molecules;
+        std::sort(uniqueMolecules.begin(), uniqueMolecules.end());
+        uniqueMolecules.erase(std::unique(uniqueMolecules.begin(), uniqueMolecules.end()), uniqueMolecules.end());
+
+        concurrent::forEach(uniqueMolecules.size(),
+                            PrepareMoleculeTask(uniqueMolecules, d->flags, d->screeningEnabled),
+                            threadCount);
+    }
+
+    std::vector<char> matches(molecules.size(), false);
+    concurrent::forEach(molecules.size(), FilterTask(*this, molecules, matches), threadCount);
+
+    for(size_t i = 0; i < molecules.size(); i++){
+        if(matches[i]){
+            matchingMolecules.push_back(molecules[i]);
+        }
+    }
+
+    return matchingMolecules;
+}
+
 /// Searches the the molecule for an occurrence of the substructure
 /// molecule in \p molecule and returns it if found. If not found an
 /// empty moiety is returned.
@@ -569,20 +933,107 @@ std::vector<Molecule *> SubstructureQuery::filter(const std::vector<Molecule *>
 /// \endcode
 Moiety SubstructureQuery::find(const Molecule *molecule) const
 {
-    std::map<Atom *, Atom *> mapping = this->mapping(molecule);
+    return d->moiety(mapping(molecule));
+}
+
+/// Searches for an occurrence of the substructure molecule in the
+/// molecule for \p target and returns it if found. If not found an
+/// empty moiety is returned.
+Moiety SubstructureQuery::find(const SubstructureTarget &target) const
+{
+    return d->moiety(mapping(target));
+}
 
-    // no mapping found, return empty moiety
-    if(mapping.empty()){
-        return Moiety();
+/// Returns a moiety for each occurrence of the substructure molecule
+/// in \p molecule.
+///
+/// Each moiety contains the atoms matched to the atoms in the
+/// substructure molecule in the same order. Terminal hydrogens in the
+/// substructure molecule are only included if the CompareHydrogens
+/// flag is set. Symmetric occurrences (e.g. the two ways of matching
+/// ethane to two carbon atoms) are returned separately.
+std::vector<Moiety> SubstructureQuery::findAll(const Molecule *molecule) const
+{
+    d->update();
+
+    // the target is only built for molecules that pass the screen
+    if(!d->screenMolecule(molecule)){
+        return std::vector<Moiety>();
     }
 
-    std::vector<Atom *> atoms;
+    SubstructureTarget target(molecule);
 
-    foreach(Atom *atom, d->molecule->atoms()){
-        atoms.push_back(mapping[atom]);
+    return d->findAll(target);
+}
+
+/// Returns a moiety for each occurrence of the substructure molecule
+/// in the molecule for \p target.
+std::vector<Moiety> SubstructureQuery::findAll(const SubstructureTarget &target) const
+{
+    d->update();
+
+    if(!d->screenTarget(target)){
+        return std::vector<Moiety>();
     }
 
-    return Moiety(atoms);
+    return d->findAll(target);
+}
+
+/// Returns the number of occurrences of the substructure molecule in
+/// \p molecule. Symmetric occurrences are counted separately.
+///
+/// This is faster than calling findAll() and checking the size of
+/// the result because no moieties are created.
+size_t SubstructureQuery::count(const Molecule *molecule) const
+{
+    d->update();
+
+    // the target is only built for molecules that pass the screen
+    if(!d->screenMolecule(molecule)){
+        return 0;
+    }
+
+    SubstructureTarget target(molecule);
+
+    return d->count(target);
+}
+
+/// Returns the number of occurrences of the substructure molecule in
+/// the molecule for \p target.
+size_t SubstructureQuery::count(const SubstructureTarget &target) const
+{
+    d->update();
+
+    if(!d->screenTarget(target)){
+        return 0;
+    }
+
+    return d->count(target);
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Returns a vector containing \c true for each query in \p queries
+/// that matches the molecule in \p target and \c false for each
+/// query that does not.
+///
+/// For example, to count the functional groups found in a molecule:
+/// \code
+/// SubstructureTarget target(molecule);
+///
+/// std::vector<bool> matches = SubstructureQuery::matches(groups, target);
+///
+/// size_t count = std::count(matches.begin(), matches.end(), true);
+/// \endcode
+std::vector<bool> SubstructureQuery::matches(const std::vector<SubstructureQuery *> &queries,
+                                             const SubstructureTarget &target)
+{
+    std::vector<bool> matches(queries.size(), false);
+
+    for(size_t i = 0; i < queries.size(); i++){
+        matches[i] = queries[i]->matches(target);
+    }
+
+    return matches;
 }
 
 } // end chemkit namespace
@@ -51,6 +51,7 @@ namespace chemkit {
 
 class Atom;
 class Molecule;
+class SubstructureTarget;
 class SubstructureQueryPrivate;
 
 class CHEMKIT_EXPORT SubstructureQuery
@@ -76,13 +77,36 @@ public:
     boost::shared_ptr<Molecule> molecule() const;
     void setFlags(int flags);
     int flags() const;
+    void setScreeningEnabled(bool enabled);
+    bool isScreeningEnabled() const;
+    void setNodeLimit(size_t limit);
+    size_t nodeLimit() const;
+    void setTimeLimit(int milliseconds);
+    int timeLimit() const;
+    void setApproximateMappingsEnabled(bool enabled);
+    bool isApproximateMappingsEnabled() const;
 
     // queries
     bool matches(const Molecule *molecule) const;
+    bool matches(const SubstructureTarget &target) const;
     std::map<Atom *, Atom *> mapping(const Molecule *molecule) const;
+    std::map<Atom *, Atom *> mapping(const SubstructureTarget &target) const;
     std::map<Atom *, Atom *> maximumMapping(const Molecule *molecule) const;
+    std::map<Atom *, Atom *> maximumMapping(const SubstructureTarget &target) const;
+    size_t maximumMappingBound(const Molecule *molecule) const;
+    size_t maximumMappingBound(const SubstructureTarget &target) const;
     std::vector<Molecule *> filter(const std::vector<Molecule *> &molecules) const;
+    std::vector<Molecule *> filter(const std::vector<Molecule *> &molecules, size_t threadCount) const;
     Moiety find(const Molecule *molecule) const;
+    Moiety find(const SubstructureTarget &target) const;
+    std::vector<Moiety> findAll(const Molecule *molecule) const;
+    std::vector<Moiety> findAll(const SubstructureTarget &target) const;
+    size_t count(const Molecule *molecule) const;
+    size_t count(const SubstructureTarget &target) const;
+
+    // static methods
+    static std::vector<bool> matches(const std::vector<SubstructureQuery *> &queries,
+                                     const SubstructureTarget &target);
 
 private:
     SubstructureQueryPrivate* const d;
@@ -0,0 +1,249 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "substructuretarget.h"
+
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+
+#include "atom.h"
+#include "bond.h"
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculeprivate.h"
+
+namespace chemkit {
+
+namespace {
+
+// number of bits in a screen
+const size_t ScreenSize = 1024;
+
+// maximum count of each element added to a screen
+const size_t MaxScreenElementCount = 16;
+
+// Extends the fnv-1a hash with value.
+inline boost::uint32_t fnv(boost::uint32_t hash, boost::uint32_t value)
+{
+    return (hash ^ value) * 16777619u;
+}
+
+// Returns the screen for molecule. See SubstructureTarget::screen().
+Bitset calculateScreen(const Molecule *molecule, bool hydrogens, bool bondOrders)
+{
+    Bitset screen(ScreenSize);
+
+    // label for each atom in the screened graph, or -1 for each atom
+    // that is not in it
+    std::vector<int> labels(molecule->atomCount(), -1);
+    std::vector<size_t> elementCounts(256, 0);
+
+    foreach(const Atom *atom, molecule->atoms()){
+        if(!hydrogens && atom->isTerminalHydrogen()){
+            continue;
+        }
+
+        int element = atom->atomicNumber();
+        labels[atom->index()] = element;
+
+        // the first n bits of an element are set for n atoms so that
+        // the bits for a substructure are a subset of those for the
+        // molecule
+        size_t &count = elementCounts[element & 0xff];
+        if(count < MaxScreenElementCount){
+            count++;
+            screen.set(fnv(fnv(2166136261u, element), boost::uint32_t(count << 8)) % ScreenSize);
+        }
+    }
+
+    // paths of one bond starting at each atom and paths of two bonds
+    // centered on each atom. the neighbor labels are sorted so that
+    // each pair of neighbors is hashed in the same order
+    std::vector<boost::uint32_t> neighborLabels;
+
+    foreach(const Atom *atom, molecule->atoms()){
+        int label = labels[atom->index()];
+        if(label < 0){
+            continue;
+        }
+
+        neighborLabels.clear();
+
+        foreach(const Bond *bond, atom->bonds()){
+            int neighborLabel = labels[bond->otherAtom(atom)->index()];
+            if(neighborLabel < 0){
+                continue;
+            }
+
+            boost::uint32_t bondLabel = bondOrders ? bond->order() : 0;
+            neighborLabels.push_back((bondLabel << 8) | neighborLabel);
+        }
+
+        std::sort(neighborLabels.begin(), neighborLabels.end());
+
+        boost::uint32_t atomHash = fnv(2166136261u, label);
+
+        for(size_t i = 0; i < neighborLabels.size(); i++){
+            boost::uint32_t pathHash = fnv(atomHash, neighborLabels[i]);
+            screen.set(pathHash % ScreenSize);
+
+            for(size_t j = i + 1; j < neighborLabels.size(); j++){
+                screen.set(fnv(pathHash, neighborLabels[j]) % ScreenSize);
+            }
+        }
+    }
+
+    return screen;
+}
+
+} // end anonymous namespace
+
+// === SubstructureTarget ================================================== //
+/// \class SubstructureTarget substructuretarget.h chemkit/substructuretarget.h
+/// \ingroup chemkit
+/// \brief The SubstructureTarget class contains a molecule prepared
+///        for substructure searching.
+///
+/// The graphs used by SubstructureQuery are built once when the
+/// target is created. When many queries are run against the same
+/// molecule, passing a SubstructureTarget instead of the molecule
+/// avoids building the graphs again for every query.
+///
+/// For example, to check which of a set of queries match a molecule:
+/// \code
+/// SubstructureTarget target(molecule);
+///
+/// std::vector<bool> matches = SubstructureQuery::matches(queries, target);
+/// \endcode
+///
+/// The target must be recreated if any atoms or bonds are added to
+/// or removed from the molecule.
+///
+/// The target also provides the screens used by SubstructureQuery
+/// to quickly reject molecules without running the full isomorphism
+/// search. Screens are calculated when first requested and kept for
+/// the lifetime of the target. Keeping targets for molecules that
+/// are searched many times avoids calculating their screens again.
+///
+/// \see SubstructureQuery
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new substructure target for \p molecule.
+SubstructureTarget::SubstructureTarget(const Molecule *molecule)
+    : m_molecule(molecule)
+{
+    m_atoms.assign(molecule->atoms().begin(), molecule->atoms().end());
+
+    // map from atom index to heavy atom index
+    std::vector<size_t> heavyIndices(m_atoms.size(), size_t(-1));
+
+    foreach(Atom *atom, m_atoms){
+        if(!atom->isTerminalHydrogen()){
+            heavyIndices[atom->index()] = m_heavyAtoms.size();
+            m_heavyAtoms.push_back(atom);
+        }
+    }
+
+    m_graph.resize(m_atoms.size());
+    m_heavyGraph.resize(m_heavyAtoms.size());
+
+    foreach(const Bond *bond, molecule->bonds()){
+        size_t a = bond->atom1()->index();
+        size_t b = bond->atom2()->index();
+
+        m_graph.addEdge(a, b);
+
+        if(heavyIndices[a] != size_t(-1) && heavyIndices[b] != size_t(-1)){
+            m_heavyGraph.addEdge(heavyIndices[a], heavyIndices[b]);
+        }
+    }
+}
+
+/// Destroys the substructure target.
+SubstructureTarget::~SubstructureTarget()
+{
+}
+
+// --- Screening ----------------------------------------------------------- //
+/// Returns the screen for the target. The screen is a 1024-bit
+/// bitset with bits set for the number of atoms of each element and
+/// for each path of up to two bonds in graph(\p hydrogens). If
+/// \p bondOrders is \c true the bond orders along the paths are
+/// included, otherwise only the elements are.
+///
+/// If a query molecule is a substructure of the target molecule then
+/// every bit set in the query's screen is also set in the target's
+/// screen, so a query whose screen is not a subset of the target's
+/// screen cannot match.
+const Bitset& SubstructureTarget::screen(bool hydrogens, bool bondOrders) const
+{
+    Bitset &screen = m_screens[(hydrogens ? 2 : 0) + (bondOrders ? 1 : 0)];
+
+    if(screen.empty()){
+        screen = SubstructureTarget::screen(m_molecule, hydrogens, bondOrders);
+    }
+
+    return screen;
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Returns the screen for \p molecule. The screen is the same as the
+/// screen() of a target for \p molecule but is calculated without
+/// building the target's graphs. It is used to reject molecules
+/// before a target is built for them.
+///
+/// If the molecule's result cache is enabled the screen is stored in
+/// the molecule and reused until the molecule is modified (see
+/// Molecule::setResultCacheEnabled()).
+Bitset SubstructureTarget::screen(const Molecule *molecule, bool hydrogens, bool bondOrders)
+{
+    MoleculePrivate *d = molecule->d;
+
+    if(!d->resultCacheEnabled){
+        return calculateScreen(molecule, hydrogens, bondOrders);
+    }
+
+    std::pair<size_t, Bitset> &cached = d->substructureScreenCache[(hydrogens ? 2 : 0) + (bondOrders ? 1 : 0)];
+
+    if(cached.second.empty() || cached.first != d->version){
+        cached = std::make_pair(d->version, calculateScreen(molecule, hydrogens, bondOrders));
+    }
+
+    return cached.second;
+}
+
+} // end chemkit namespace
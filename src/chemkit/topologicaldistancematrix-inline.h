@@ -0,0 +1,79 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#ifndef CHEMKIT_TOPOLOGICALDISTANCEMATRIX_INLINE_H
+#define CHEMKIT_TOPOLOGICALDISTANCEMATRIX_INLINE_H
+
+#include "topologicaldistancematrix.h"
+
+namespace chemkit {
+
+// --- Properties ---------------------------------------------------------- //
+/// Returns the number of atoms in the matrix.
+inline size_t TopologicalDistanceMatrix::size() const
+{
+    return m_size;
+}
+
+/// Returns \c true if the matrix contains no atoms.
+inline bool TopologicalDistanceMatrix::isEmpty() const
+{
+    return m_size == 0;
+}
+
+// --- Distances ----------------------------------------------------------- //
+/// Returns the number of bonds on the shortest path between the
+/// atoms at indices \p i and \p j. Returns \c Infinity if the atoms
+/// are not connected.
+inline int TopologicalDistanceMatrix::distance(size_t i, size_t j) const
+{
+    DistanceType distance = m_distances[i * m_size + j];
+
+    return distance == InfiniteDistance ? int(Infinity) : int(distance);
+}
+
+// --- Operators ----------------------------------------------------------- //
+/// Returns the distance between the atoms at indices \p i and \p j.
+///
+/// \see distance()
+inline int TopologicalDistanceMatrix::operator()(size_t i, size_t j) const
+{
+    return distance(i, j);
+}
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_TOPOLOGICALDISTANCEMATRIX_INLINE_H
@@ -0,0 +1,208 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "topologicaldistancematrix.h"
+
+#include <limits>
+#include <cassert>
+#include <algorithm>
+
+#include "foreach.h"
+#include "molecule.h"
+#include "moleculeview.h"
+
+namespace chemkit {
+
+namespace {
+
+// Fills distances with the number of bonds from atom to each atom in
+// view using a breadth-first search. Atoms that are not connected to
+// atom are left set to infinity. Returns the largest distance found.
+template<typename T>
+T breadthFirstSearch(const MoleculeView &view,
+                     size_t atom,
+                     T *distances,
+                     T infinity,
+                     std::vector<size_t> &queue)
+{
+    std::fill(distances, distances + view.size(), infinity);
+
+    queue.clear();
+    queue.push_back(atom);
+    distances[atom] = 0;
+
+    for(size_t position = 0; position < queue.size(); position++){
+        size_t current = queue[position];
+
+        foreach(size_t neighbor, view.neighbors(current)){
+            if(distances[neighbor] == infinity){
+                distances[neighbor] = distances[current] + 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    // the last atom in the queue is the furthest from atom
+    return distances[queue.back()];
+}
+
+} // end anonymous namespace
+
+// === TopologicalDistanceMatrix =========================================== //
+/// \class TopologicalDistanceMatrix topologicaldistancematrix.h chemkit/topologicaldistancematrix.h
+/// \ingroup chemkit
+/// \brief The TopologicalDistanceMatrix class contains the graph
+///        distances between each pair of atoms in a molecule.
+///
+/// The topological distance between two atoms is the number of bonds
+/// on the shortest path between them. The matrix is calculated with
+/// one breadth-first search per atom over a MoleculeView and stored
+/// in a single flat array of 16-bit integers. The matrix uses two
+/// bytes for every pair of atoms and supports at most 65535 atoms.
+///
+/// The matrix for a molecule is also available (and cached) from
+/// Molecule::topologicalDistanceMatrix(). Code that only needs the
+/// eccentricity of each atom should use eccentricities() which does
+/// not store the matrix.
+///
+/// \see MoleculeView
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new distance matrix for \p molecule.
+TopologicalDistanceMatrix::TopologicalDistanceMatrix(const Molecule *molecule)
+{
+    calculate(MoleculeView(molecule));
+}
+
+/// Creates a new distance matrix for the molecule in \p view.
+TopologicalDistanceMatrix::TopologicalDistanceMatrix(const MoleculeView &view)
+{
+    calculate(view);
+}
+
+/// Destroys the distance matrix.
+TopologicalDistanceMatrix::~TopologicalDistanceMatrix()
+{
+}
+
+// --- Distances ----------------------------------------------------------- //
+/// Returns the largest distance from the atom at index \p atom to
+/// any atom connected to it.
+int TopologicalDistanceMatrix::eccentricity(size_t atom) const
+{
+    int eccentricity = 0;
+
+    const DistanceType *row = &m_distances[atom * m_size];
+    for(size_t i = 0; i < m_size; i++){
+        if(row[i] != InfiniteDistance){
+            eccentricity = std::max(eccentricity, int(row[i]));
+        }
+    }
+
+    return eccentricity;
+}
+
+/// Returns the largest eccentricity of any atom.
+int TopologicalDistanceMatrix::diameter() const
+{
+    int diameter = 0;
+
+    for(size_t i = 0; i < m_size; i++){
+        diameter = std::max(diameter, eccentricity(i));
+    }
+
+    return diameter;
+}
+
+/// Returns the smallest eccentricity of any atom. Returns \c 0 if the
+/// matrix is empty.
+int TopologicalDistanceMatrix::radius() const
+{
+    if(isEmpty()){
+        return 0;
+    }
+
+    int radius = std::numeric_limits<int>::max();
+
+    for(size_t i = 0; i < m_size; i++){
+        radius = std::min(radius, eccentricity(i));
+    }
+
+    return radius;
+}
+
+// --- Static Methods ------------------------------------------------------ //
+/// Returns the eccentricity of each atom in \p view. This runs one
+/// breadth-first search per atom like the matrix constructor but only
+/// keeps a single row of distances in memory.
+///
+/// \see eccentricity()
+std::vector<int> TopologicalDistanceMatrix::eccentricities(const MoleculeView &view)
+{
+    std::vector<int> eccentricities(view.size());
+
+    std::vector<int> distances(view.size());
+    std::vector<size_t> queue;
+    queue.reserve(view.size());
+
+    for(size_t i = 0; i < view.size(); i++){
+        eccentricities[i] = breadthFirstSearch(view, i, &distances[0], int(Infinity), queue);
+    }
+
+    return eccentricities;
+}
+
+// --- Internal Methods ---------------------------------------------------- //
+void TopologicalDistanceMatrix::calculate(const MoleculeView &view)
+{
+    m_size = view.size();
+    assert(m_size <= InfiniteDistance);
+    m_distances.resize(m_size * m_size);
+
+    // breadth-first search queue, reused for each atom
+    std::vector<size_t> queue;
+    queue.reserve(m_size);
+
+    for(size_t i = 0; i < m_size; i++){
+        breadthFirstSearch(view,
+                           i,
+                           &m_distances[i * m_size],
+                           DistanceType(InfiniteDistance),
+                           queue);
+    }
+}
+
+} // end chemkit namespace
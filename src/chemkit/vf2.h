@@ -33,6 +33,7 @@
 **
 ******************************************************************************/
 
+
 #ifndef CHEMKIT_VF2_H
 #define CHEMKIT_VF2_H
 
@@ -40,6 +41,7 @@
 
 #include <map>
 #include <vector>
+#include <algorithm>
 
 #include "graph.h"
 
@@ -47,269 +49,186 @@ namespace chemkit {
 namespace algorithm {
 namespace detail {
 
-// The SharedState class holds four vectors containing the mapping between
-// the two graphs and the terminal sets. It is shared between all the states
-// in each isomorphism test.
-template<typename T>
-class SharedState
-{
-public:
-    typedef T SizeType;
-    enum { NullIndex = SizeType(-1) }; // represents an invalid vertex index
-
-    SharedState(T sourceSize, T targetSize);
-
-    std::vector<T> sourceMapping;
-    std::vector<T> targetMapping;
-    std::vector<T> sourceTerminalSet;
-    std::vector<T> targetTerminalSet;
-};
-
-template<typename T>
-inline SharedState<T>::SharedState(T sourceSize, T targetSize)
-    : sourceMapping(sourceSize, NullIndex),
-      targetMapping(targetSize, NullIndex),
-      sourceTerminalSet(sourceSize, 0),
-      targetTerminalSet(targetSize, 0)
-{
-}
-
-// The State class represents a single state in the isomorphism detection
-// algorithm. Every state uses and modifies the same SharedState object.
+// The Vf2Matcher class implements the VF2 subgraph isomorphism algorithm
+// without recursion. The mapping, terminal sets and the candidate and
+// terminal set sizes for each depth of the search are stored in flat
+// arrays which share a single buffer allocated when the matcher is
+// created.
 template<typename T, typename VertexComparator, typename EdgeComparator>
-class State
+class Vf2Matcher
 {
 public:
     typedef T SizeType;
     enum { NullIndex = SizeType(-1) }; // represents an invalid vertex index
 
-    State(const Graph<T> &source, const Graph<T> &target, VertexComparator compareVertices, EdgeComparator compareEdges);
-    State(const State *state);
-    ~State();
+    Vf2Matcher(const Graph<T> &source, const Graph<T> &target, VertexComparator compareVertices, EdgeComparator compareEdges);
 
-    SizeType size() const { return m_size; }
-    const Graph<T>& source() const { return m_source; }
-    const Graph<T>& target() const { return m_target; }
-    std::map<T, T> mapping() const;
-    bool succeeded() const;
-    void addPair(const std::pair<T, T> &candidate);
-    std::pair<T, T> nextCandidate(const std::pair<T, T> &lastCandidate);
-    bool isFeasible(const std::pair<T, T> &candidate);
-    void backTrack();
+    template<typename Visitor> size_t run(Visitor &visitor);
+
+private:
+    bool nextCandidate(SizeType depth, T &sourceVertex, T &targetVertex) const;
+    bool isFeasible(T sourceVertex, T targetVertex) const;
+    void addPair(SizeType depth, T sourceVertex, T targetVertex);
+    void backTrack(SizeType depth);
 
-    static const std::pair<T, T> nullCandidate() { return std::make_pair(SizeType(-1), SizeType(-1)); }
+    CHEMKIT_DISABLE_COPY(Vf2Matcher)
 
 private:
-    SizeType m_size;
-    SizeType m_sourceTerminalSize;
-    SizeType m_targetTerminalSize;
     const Graph<T> &m_source;
     const Graph<T> &m_target;
-    std::pair<T, T> m_lastAddition;
-    SharedState<T> *m_sharedState;
-    bool m_ownSharedState;
     VertexComparator m_compareVertices;
     EdgeComparator m_compareEdges;
+    std::vector<T> m_sourceMapping;
+    std::vector<T> m_buffer;
+    T *m_targetMapping;
+    T *m_sourceTerminalSet;
+    T *m_targetTerminalSet;
+    T *m_sourceStack;
+    T *m_targetStack;
+    T *m_sourceTerminalSizes;
+    T *m_targetTerminalSizes;
 };
 
 template<typename T, typename VertexComparator, typename EdgeComparator>
-inline State<T, VertexComparator, EdgeComparator>::State(const Graph<T> &source,
-                                                         const Graph<T> &target,
-                                                         VertexComparator compareVertices,
-                                                         EdgeComparator compareEdges)
-    : m_size(0),
-      m_sourceTerminalSize(0),
-      m_targetTerminalSize(0),
-      m_source(source),
+inline Vf2Matcher<T, VertexComparator, EdgeComparator>::Vf2Matcher(const Graph<T> &source,
+                                                                   const Graph<T> &target,
+                                                                   VertexComparator compareVertices,
+                                                                   EdgeComparator compareEdges)
+    : m_source(source),
       m_target(target),
-      m_lastAddition(NullIndex, NullIndex),
-      m_sharedState(new SharedState<T>(source.size(), target.size())),
-      m_ownSharedState(true),
       m_compareVertices(compareVertices),
-      m_compareEdges(compareEdges)
+      m_compareEdges(compareEdges),
+      m_sourceMapping(source.size(), NullIndex),
+      m_buffer(2 * target.size() + 5 * (source.size() + 1), 0)
 {
+    T sourceSize = source.size();
+    T targetSize = target.size();
+
+    m_targetMapping = &m_buffer[0];
+    m_targetTerminalSet = m_targetMapping + targetSize;
+    m_sourceTerminalSet = m_targetTerminalSet + targetSize;
+    m_sourceStack = m_sourceTerminalSet + sourceSize + 1;
+    m_targetStack = m_sourceStack + sourceSize + 1;
+    m_sourceTerminalSizes = m_targetStack + sourceSize + 1;
+    m_targetTerminalSizes = m_sourceTerminalSizes + sourceSize + 1;
+
+    std::fill(m_targetMapping, m_targetMapping + targetSize, T(NullIndex));
 }
 
+// Runs the search and calls visitor with the source to target vertex
+// mapping for each isomorphism found. The search stops if the visitor
+// returns false. Returns the number of isomorphisms visited.
 template<typename T, typename VertexComparator, typename EdgeComparator>
-inline State<T, VertexComparator, EdgeComparator>::State(const State *state)
-    : m_size(state->m_size),
-      m_sourceTerminalSize(state->m_sourceTerminalSize),
-      m_targetTerminalSize(state->m_targetTerminalSize),
-      m_source(state->m_source),
-      m_target(state->m_target),
-      m_lastAddition(NullIndex, NullIndex),
-      m_sharedState(state->m_sharedState),
-      m_ownSharedState(false),
-      m_compareVertices(state->m_compareVertices),
-      m_compareEdges(state->m_compareEdges)
+template<typename Visitor>
+inline size_t Vf2Matcher<T, VertexComparator, EdgeComparator>::run(Visitor &visitor)
 {
-}
+    SizeType sourceSize = m_source.size();
+    SizeType depth = 0;
+    size_t count = 0;
 
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline State<T, VertexComparator, EdgeComparator>::~State()
-{
-    if(m_ownSharedState)
-        delete m_sharedState;
-}
+    m_sourceStack[0] = NullIndex;
+    m_targetStack[0] = NullIndex;
 
-// Returns true if the state contains an isomorphism.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool State<T, VertexComparator, EdgeComparator>::succeeded() const
-{
-    return m_size == m_source.size();
-}
+    for(;;){
+        if(depth == sourceSize){
+            count++;
 
-// Returns the current isomorphism for the state as a std::map.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline std::map<T, T> State<T, VertexComparator, EdgeComparator>::mapping() const
-{
-    std::map<T, T> mapping;
+            if(!visitor(static_cast<const std::vector<T> &>(m_sourceMapping))){
+                return count;
+            }
 
-    for(SizeType i = 0; i < m_size; i++){
-        mapping[i] = m_sharedState->sourceMapping[i];
-    }
+            if(depth == 0){
+                return count;
+            }
 
-    return mapping;
-}
+            backTrack(--depth);
+            continue;
+        }
 
-// Returns the next candidate pair (sourceAtom, targetAtom) to be added to the
-// state. The candidate should be checked for feasibility and then added using
-// the addPair() method.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline std::pair<T, T> State<T, VertexComparator, EdgeComparator>::nextCandidate(const std::pair<T, T> &lastCandidate)
-{
-    T lastSourceAtom = lastCandidate.first;
-    T lastTargetAtom = lastCandidate.second;
+        T sourceVertex = m_sourceStack[depth];
+        T targetVertex = m_targetStack[depth];
 
-    SizeType sourceSize = m_source.size();
-    SizeType targetSize = m_target.size();
+        if(!nextCandidate(depth, sourceVertex, targetVertex)){
+            if(depth == 0){
+                return count;
+            }
 
-    if(lastSourceAtom == NullIndex)
-        lastSourceAtom = 0;
+            backTrack(--depth);
+            continue;
+        }
 
-    if(lastTargetAtom == NullIndex)
-        lastTargetAtom = 0;
-    else
-        lastTargetAtom++;
+        m_sourceStack[depth] = sourceVertex;
+        m_targetStack[depth] = targetVertex;
 
-    if(m_sourceTerminalSize > m_size && m_targetTerminalSize > m_size){
-        while(lastSourceAtom < sourceSize &&
-              (m_sharedState->sourceMapping[lastSourceAtom] != NullIndex ||
-               m_sharedState->sourceTerminalSet[lastSourceAtom] == 0)){
-            lastSourceAtom++;
-            lastTargetAtom = 0;
-        }
-    }
-    else{
-        while(lastSourceAtom < sourceSize &&
-              m_sharedState->sourceMapping[lastSourceAtom] != NullIndex){
-            lastSourceAtom++;
-            lastTargetAtom = 0;
-        }
-    }
+        if(isFeasible(sourceVertex, targetVertex)){
+            addPair(depth, sourceVertex, targetVertex);
+            depth++;
 
-    if(m_sourceTerminalSize > m_size && m_targetTerminalSize > m_size){
-        while(lastTargetAtom < targetSize &&
-              (m_sharedState->targetMapping[lastTargetAtom] != NullIndex||
-               m_sharedState->targetTerminalSet[lastTargetAtom] == 0)){
-            lastTargetAtom++;
-        }
-    }
-    else{
-        while(lastTargetAtom < targetSize &&
-              m_sharedState->targetMapping[lastTargetAtom] != NullIndex){
-            lastTargetAtom++;
+            m_sourceStack[depth] = NullIndex;
+            m_targetStack[depth] = NullIndex;
         }
     }
-
-    if(lastSourceAtom < sourceSize && lastTargetAtom < targetSize){
-        return std::make_pair(lastSourceAtom, lastTargetAtom);
-    }
-
-    return nullCandidate();
 }
 
-// Adds the candidate pair (sourceAtom, targetAtom) to the state. The candidate
-// pair must be feasible to add it to the state.
+// Finds the next candidate pair (sourceVertex, targetVertex) at depth after
+// the last candidate pair passed in sourceVertex and targetVertex (or
+// NullIndex to find the first candidate). Returns false if there are no more
+// candidates.
 template<typename T, typename VertexComparator, typename EdgeComparator>
-inline void State<T, VertexComparator, EdgeComparator>::addPair(const std::pair<T, T> &candidate)
+inline bool Vf2Matcher<T, VertexComparator, EdgeComparator>::nextCandidate(SizeType depth, T &sourceVertex, T &targetVertex) const
 {
-    m_size++;
-    m_lastAddition = candidate;
-
-    T sourceAtom = candidate.first;
-    T targetAtom = candidate.second;
-
-    if(!m_sharedState->sourceTerminalSet[sourceAtom]){
-        m_sharedState->sourceTerminalSet[sourceAtom] = m_size;
-        //m_sourceTerminalSize++;
-    }
-
-    if(!m_sharedState->targetTerminalSet[targetAtom]){
-        m_sharedState->targetTerminalSet[targetAtom] = m_size;
-        //m_targetTerminalSize++;
-    }
-
-    m_sharedState->sourceMapping[sourceAtom] = targetAtom;
-    m_sharedState->targetMapping[targetAtom] = sourceAtom;
-
-    foreach(T neighbor, m_source.neighbors(sourceAtom)){
-        if(!m_sharedState->sourceTerminalSet[neighbor]){
-            m_sharedState->sourceTerminalSet[neighbor] = m_size;
-            m_sourceTerminalSize++;
+    SizeType sourceSize = m_source.size();
+    SizeType targetSize = m_target.size();
+    bool terminal = m_sourceTerminalSizes[depth] > depth && m_targetTerminalSizes[depth] > depth;
+
+    // the source vertex is the first unmapped vertex (in the terminal set if
+    // it is not empty) and is only searched for once per depth
+    if(sourceVertex == T(NullIndex)){
+        sourceVertex = 0;
+
+        if(terminal){
+            while(sourceVertex < sourceSize &&
+                  (m_sourceMapping[sourceVertex] != T(NullIndex) ||
+                   m_sourceTerminalSet[sourceVertex] == 0)){
+                sourceVertex++;
+            }
         }
-    }
-
-    foreach(T neighbor, m_target.neighbors(targetAtom)){
-        if(!m_sharedState->targetTerminalSet[neighbor]){
-            m_sharedState->targetTerminalSet[neighbor] = m_size;
-            m_targetTerminalSize++;
+        else{
+            while(sourceVertex < sourceSize &&
+                  m_sourceMapping[sourceVertex] != T(NullIndex)){
+                sourceVertex++;
+            }
         }
-    }
-}
-
-// Restores the shared state to how it was before adding the last candidate
-// pair. Assumes addPair() has been called on the state only once.
-template<typename T, typename VertexComparator, typename EdgeComparator>
-inline void State<T, VertexComparator, EdgeComparator>::backTrack()
-{
-    T addedSourceAtom = m_lastAddition.first;
 
-    if(m_sharedState->sourceTerminalSet[addedSourceAtom] == m_size){
-        m_sharedState->sourceTerminalSet[addedSourceAtom] = 0;
+        targetVertex = 0;
     }
-
-    foreach(T neighbor, m_source.neighbors(addedSourceAtom)){
-        if(m_sharedState->sourceTerminalSet[neighbor] == m_size){
-            m_sharedState->sourceTerminalSet[neighbor] = 0;
-        }
+    else{
+        targetVertex++;
     }
 
-    T addedTargetAtom = m_lastAddition.second;
-
-    if(m_sharedState->targetTerminalSet[addedTargetAtom] == m_size){
-        m_sharedState->targetTerminalSet[addedTargetAtom] = 0;
+    if(terminal){
+        while(targetVertex < targetSize &&
+              (m_targetMapping[targetVertex] != T(NullIndex) ||
+               m_targetTerminalSet[targetVertex] == 0)){
+            targetVertex++;
+        }
     }
-
-    foreach(T neighbor, m_target.neighbors(addedTargetAtom)){
-        if(m_sharedState->targetTerminalSet[neighbor] == m_size){
-            m_sharedState->targetTerminalSet[neighbor] = 0;
+    else{
+        while(targetVertex < targetSize &&
+              m_targetMapping[targetVertex] != T(NullIndex)){
+            targetVertex++;
         }
     }
 
-    m_sharedState->sourceMapping[addedSourceAtom] = NullIndex;
-    m_sharedState->targetMapping[addedTargetAtom] = NullIndex;
-    m_size--;
-    m_lastAddition = nullCandidate();
+    return sourceVertex < sourceSize && targetVertex < targetSize;
 }
 
+// Returns true if the candidate pair (sourceVertex, targetVertex) can be
+// added to the current mapping.
 template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pair<T, T> &candidate)
+inline bool Vf2Matcher<T, VertexComparator, EdgeComparator>::isFeasible(T sourceVertex, T targetVertex) const
 {
-    T sourceAtom = candidate.first;
-    T targetAtom = candidate.second;
-
-    if(!m_compareVertices(sourceAtom, targetAtom)){
+    if(!m_compareVertices(sourceVertex, targetVertex)){
         return false;
     }
 
@@ -318,20 +237,20 @@ inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pa
     SizeType sourceNewNeighborCount = 0;
     SizeType targetNewNeighborCount = 0;
 
-    foreach(T neighbor, m_source.neighbors(sourceAtom)){
-        if(m_sharedState->sourceMapping[neighbor] != NullIndex){
-            T targetNeighbor = m_sharedState->sourceMapping[neighbor];
+    foreach(T neighbor, m_source.neighbors(sourceVertex)){
+        if(m_sourceMapping[neighbor] != T(NullIndex)){
+            T targetNeighbor = m_sourceMapping[neighbor];
 
-            if(!m_target.isAdjacent(targetAtom, targetNeighbor)){
+            if(!m_target.isAdjacent(targetVertex, targetNeighbor)){
                 return false;
             }
 
-            if(!m_compareEdges(sourceAtom, neighbor, targetAtom, targetNeighbor)){
+            if(!m_compareEdges(sourceVertex, neighbor, targetVertex, targetNeighbor)){
                 return false;
             }
         }
         else{
-            if(m_sharedState->sourceTerminalSet[neighbor]){
+            if(m_sourceTerminalSet[neighbor]){
                 sourceTerminalNeighborCount++;
             }
             else{
@@ -340,9 +259,9 @@ inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pa
         }
     }
 
-    foreach(T neighbor, m_target.neighbors(targetAtom)){
-        if(m_sharedState->targetMapping[neighbor] == NullIndex){
-            if(m_sharedState->targetTerminalSet[neighbor]){
+    foreach(T neighbor, m_target.neighbors(targetVertex)){
+        if(m_targetMapping[neighbor] == T(NullIndex)){
+            if(m_targetTerminalSet[neighbor]){
                 targetTerminalNeighborCount++;
             }
             else{
@@ -351,66 +270,187 @@ inline bool State<T, VertexComparator, EdgeComparator>::isFeasible(const std::pa
         }
     }
 
+    // a new source neighbor can be mapped to a target neighbor in the
+    // terminal set because the match does not need to be induced, so
+    // the new neighbors are only compared together with the terminal
+    // neighbors
     return (sourceTerminalNeighborCount <= targetTerminalNeighborCount) &&
-           (sourceNewNeighborCount <= targetNewNeighborCount);
+           (sourceTerminalNeighborCount + sourceNewNeighborCount <=
+            targetTerminalNeighborCount + targetNewNeighborCount);
 }
 
+// Adds the candidate pair (sourceVertex, targetVertex) to the mapping at
+// depth. The terminal set entries added are marked with depth + 1 so that
+// they can be removed by backTrack().
 template<typename T, typename VertexComparator, typename EdgeComparator>
-inline bool match(State<T, VertexComparator, EdgeComparator> *state, std::map<T, T> &mapping)
+inline void Vf2Matcher<T, VertexComparator, EdgeComparator>::addPair(SizeType depth, T sourceVertex, T targetVertex)
 {
-    if(state->succeeded()){
-        mapping = state->mapping();
-        return true;
+    T mark = depth + 1;
+    SizeType sourceTerminalSize = m_sourceTerminalSizes[depth];
+    SizeType targetTerminalSize = m_targetTerminalSizes[depth];
+
+    if(!m_sourceTerminalSet[sourceVertex]){
+        m_sourceTerminalSet[sourceVertex] = mark;
+    }
+
+    if(!m_targetTerminalSet[targetVertex]){
+        m_targetTerminalSet[targetVertex] = mark;
     }
 
-    std::pair<T, T> lastCandidate = state->nullCandidate();
+    m_sourceMapping[sourceVertex] = targetVertex;
+    m_targetMapping[targetVertex] = sourceVertex;
 
-    bool found = false;
-    while(!found){
-        std::pair<T, T> candidate = state->nextCandidate(lastCandidate);
+    foreach(T neighbor, m_source.neighbors(sourceVertex)){
+        if(!m_sourceTerminalSet[neighbor]){
+            m_sourceTerminalSet[neighbor] = mark;
+            sourceTerminalSize++;
+        }
+    }
+
+    foreach(T neighbor, m_target.neighbors(targetVertex)){
+        if(!m_targetTerminalSet[neighbor]){
+            m_targetTerminalSet[neighbor] = mark;
+            targetTerminalSize++;
+        }
+    }
+
+    m_sourceTerminalSizes[depth + 1] = sourceTerminalSize;
+    m_targetTerminalSizes[depth + 1] = targetTerminalSize;
+}
+
+// Removes the candidate pair added at depth from the mapping and restores
+// the terminal sets to how they were before it was added.
+template<typename T, typename VertexComparator, typename EdgeComparator>
+inline void Vf2Matcher<T, VertexComparator, EdgeComparator>::backTrack(SizeType depth)
+{
+    T mark = depth + 1;
+    T sourceVertex = m_sourceStack[depth];
+    T targetVertex = m_targetStack[depth];
+
+    if(m_sourceTerminalSet[sourceVertex] == mark){
+        m_sourceTerminalSet[sourceVertex] = 0;
+    }
 
-        if(candidate == state->nullCandidate()){
-            return false;
+    foreach(T neighbor, m_source.neighbors(sourceVertex)){
+        if(m_sourceTerminalSet[neighbor] == mark){
+            m_sourceTerminalSet[neighbor] = 0;
         }
+    }
 
-        lastCandidate = candidate;
+    if(m_targetTerminalSet[targetVertex] == mark){
+        m_targetTerminalSet[targetVertex] = 0;
+    }
 
-        if(state->isFeasible(candidate)){
-            State<T, VertexComparator, EdgeComparator> nextState(state);
-            nextState.addPair(candidate);
-            found = match(&nextState, mapping);
-            nextState.backTrack();
+    foreach(T neighbor, m_target.neighbors(targetVertex)){
+        if(m_targetTerminalSet[neighbor] == mark){
+            m_targetTerminalSet[neighbor] = 0;
         }
     }
 
-    return found;
+    m_sourceMapping[sourceVertex] = NullIndex;
+    m_targetMapping[targetVertex] = NullIndex;
 }
 
+// Visitor which copies the first mapping found and stops the search.
+template<typename T>
+class FirstMappingVisitor
+{
+public:
+    FirstMappingVisitor(std::vector<T> &mapping)
+        : m_mapping(mapping)
+    {
+    }
+
+    bool operator()(const std::vector<T> &mapping)
+    {
+        m_mapping = mapping;
+        return false;
+    }
+
+private:
+    std::vector<T> &m_mapping;
+};
+
+// Visitor which counts every mapping.
+template<typename T>
+class CountVisitor
+{
+public:
+    bool operator()(const std::vector<T> &mapping)
+    {
+        CHEMKIT_UNUSED(mapping);
+
+        return true;
+    }
+};
+
 } // end detail namespace
 
+// Finds the first isomorphism between graph a and a subgraph of graph b.
+// Returns true and sets mapping[i] to the vertex in b mapped to vertex i in
+// a if one is found.
+template<typename T, typename VertexComparator, typename EdgeComparator>
+bool vf2(const Graph<T> &a,
+         const Graph<T> &b,
+         VertexComparator vertexComparator,
+         EdgeComparator edgeComparator,
+         std::vector<T> &mapping)
+{
+    detail::Vf2Matcher<T, VertexComparator, EdgeComparator> matcher(a, b, vertexComparator, edgeComparator);
+    detail::FirstMappingVisitor<T> visitor(mapping);
+
+    return matcher.run(visitor) != 0;
+}
+
+// Returns the first isomorphism found between graph a and a subgraph of
+// graph b as a map from vertices in a to vertices in b. Returns an empty
+// map if no isomorphism exists.
 template<typename T, typename VertexComparator, typename EdgeComparator>
 std::map<T, T> vf2(const Graph<T> &a,
                    const Graph<T> &b,
                    VertexComparator vertexComparator,
                    EdgeComparator edgeComparator)
 {
-    using detail::State;
-    using detail::match;
+    std::vector<T> mapping;
+    std::map<T, T> map;
 
-    // create initial empty state
-    State<T, VertexComparator, EdgeComparator> state(a,
-                                                     b,
-                                                     vertexComparator,
-                                                     edgeComparator);
+    if(vf2(a, b, vertexComparator, edgeComparator, mapping)){
+        for(T i = 0; i < mapping.size(); i++){
+            map[i] = mapping[i];
+        }
+    }
 
-    // create empty mapping
-    std::map<T, T> mapping;
+    return map;
+}
+
+// Returns the number of isomorphisms between graph a and subgraphs of
+// graph b. Symmetric matches are counted separately.
+template<typename T, typename VertexComparator, typename EdgeComparator>
+size_t vf2Count(const Graph<T> &a,
+                const Graph<T> &b,
+                VertexComparator vertexComparator,
+                EdgeComparator edgeComparator)
+{
+    detail::Vf2Matcher<T, VertexComparator, EdgeComparator> matcher(a, b, vertexComparator, edgeComparator);
+    detail::CountVisitor<T> visitor;
 
-    // run vf2 match algorithm
-    match(&state, mapping);
+    return matcher.run(visitor);
+}
+
+// Calls visitor with the mapping for each isomorphism between graph a and
+// a subgraph of graph b. The visitor is called as visitor(mapping) where
+// mapping[i] is the vertex in b mapped to vertex i in a, and should return
+// false to stop the search. Returns the number of isomorphisms visited.
+template<typename T, typename VertexComparator, typename EdgeComparator, typename Visitor>
+size_t vf2Enumerate(const Graph<T> &a,
+                    const Graph<T> &b,
+                    VertexComparator vertexComparator,
+                    EdgeComparator edgeComparator,
+                    Visitor &visitor)
+{
+    detail::Vf2Matcher<T, VertexComparator, EdgeComparator> matcher(a, b, vertexComparator, edgeComparator);
 
-    // return mapping
-    return mapping;
+    return matcher.run(visitor);
 }
 
 } // end algorithm namespace
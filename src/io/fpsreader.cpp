@@ -0,0 +1,532 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fpsreader.h"
+
+#include <map>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+
+#include <boost/lexical_cast.hpp>
+
+#include <chemkit/fingerprintindex.h>
+#include <chemkit/fingerprintindexwriter.h>
+
+namespace chemkit {
+
+namespace {
+
+typedef boost::uint64_t Word;
+
+// Returns the value of the hex digit c, or -1 if c is not a hex digit.
+inline int hexValue(char c)
+{
+    if(c >= '0' && c <= '9'){
+        return c - '0';
+    }
+    else if(c >= 'a' && c <= 'f'){
+        return c - 'a' + 10;
+    }
+    else if(c >= 'A' && c <= 'F'){
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+} // end anonymous namespace
+
+// === FpsReaderPrivate ==================================================== //
+class FpsReaderPrivate
+{
+public:
+    bool readHeader();
+    bool nextRecord();
+    bool parseRecord(Word *words, size_t wordCount, std::string &identifier);
+
+    std::ifstream file;
+    std::istream *input;
+    size_t size;
+    std::map<std::string, std::string> header;
+    std::string line;
+    bool hasLine;
+    size_t lineNumber;
+    std::vector<Word> words;
+    std::string errorString;
+};
+
+// Reads the header lines at the start of the file. The first record
+// line (if any) is left in line.
+bool FpsReaderPrivate::readHeader()
+{
+    size = 0;
+    header.clear();
+    hasLine = false;
+    lineNumber = 0;
+    errorString.clear();
+
+    while(std::getline(*input, line)){
+        lineNumber++;
+
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.erase(line.size() - 1);
+        }
+
+        if(line.empty()){
+            continue;
+        }
+        else if(line[0] != '#'){
+            hasLine = true;
+            break;
+        }
+        else if(lineNumber == 1){
+            if(line != "#FPS1"){
+                errorString = "File is not an FPS file.";
+                return false;
+            }
+
+            continue;
+        }
+
+        // header lines have the form "#key=value"
+        std::string::size_type equals = line.find('=');
+        if(equals != std::string::npos){
+            header[line.substr(1, equals - 1)] = line.substr(equals + 1);
+        }
+    }
+
+    if(header.count("num_bits")){
+        try {
+            size = boost::lexical_cast<size_t>(header["num_bits"]);
+        }
+        catch(boost::bad_lexical_cast&){
+            errorString = "Invalid num_bits value '" + header["num_bits"] + "'.";
+            return false;
+        }
+    }
+    else if(hasLine){
+        // without a num_bits header the size is given by the length
+        // of the first fingerprint
+        size = 4 * (std::min)(line.find_first_of("\t "), line.size());
+    }
+
+    return true;
+}
+
+// Reads the next record line into line. Returns false at the end of
+// the file.
+bool FpsReaderPrivate::nextRecord()
+{
+    if(hasLine){
+        hasLine = false;
+        return true;
+    }
+
+    while(input && std::getline(*input, line)){
+        lineNumber++;
+
+        if(!line.empty() && line[line.size() - 1] == '\r'){
+            line.erase(line.size() - 1);
+        }
+
+        if(!line.empty() && line[0] != '#'){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Parses the fingerprint and identifier from the current record line.
+// Bits past the end of the wordCount words are ignored.
+bool FpsReaderPrivate::parseRecord(Word *words, size_t wordCount, std::string &identifier)
+{
+    size_t hexLength = 2 * ((size + 7) / 8);
+
+    if(line.size() < hexLength || (line.size() > hexLength && line[hexLength] != '\t' && line[hexLength] != ' ')){
+        errorString = "Invalid fingerprint length on line " + boost::lexical_cast<std::string>(lineNumber) + ".";
+        return false;
+    }
+
+    std::fill(words, words + wordCount, Word(0));
+
+    const char *hex = line.data();
+    size_t byteCount = (std::min)(hexLength / 2, wordCount * 8);
+
+    for(size_t i = 0; i < hexLength / 2; i++){
+        int high = hexValue(hex[2 * i]);
+        int low = hexValue(hex[2 * i + 1]);
+
+        if(high < 0 || low < 0){
+            errorString = "Invalid hex character in fingerprint on line " + boost::lexical_cast<std::string>(lineNumber) + ".";
+            return false;
+        }
+
+        // each byte holds eight bits with the lowest bit first
+        if(i < byteCount){
+            words[i / 8] |= Word((high << 4) | low) << (8 * (i % 8));
+        }
+    }
+
+    // clear padding bits past the size of the fingerprint
+    size_t bitCount = (std::min)(size, wordCount * 64);
+    if(bitCount % 64){
+        words[bitCount / 64] &= (Word(1) << (bitCount % 64)) - 1;
+    }
+
+    // the identifier follows the fingerprint and ends at the next tab
+    if(line.size() > hexLength){
+        std::string::size_type end = line.find('\t', hexLength + 1);
+        identifier.assign(line, hexLength + 1, end == std::string::npos ? std::string::npos : end - hexLength - 1);
+    }
+    else{
+        identifier.clear();
+    }
+
+    return true;
+}
+
+// === FpsReader =========================================================== //
+/// \class FpsReader fpsreader.h chemkit/fpsreader.h
+/// \ingroup chemkit-io
+/// \brief The FpsReader class reads fingerprints from FPS files.
+///
+/// FPS files contain a header followed by one line for each
+/// fingerprint with the fingerprint in hex and its identifier. The
+/// reader parses the fingerprints directly without creating any
+/// molecules so files with millions of fingerprints can be read
+/// quickly. Records are read one at a time as they are requested so
+/// the whole file is never held in memory.
+///
+/// The following example shows how to convert an FPS file into a
+/// fingerprint index file which can be searched with
+/// FingerprintIndex:
+/// \code
+/// FpsReader reader("library.fps");
+/// std::vector<std::string> identifiers;
+/// reader.convert("library.fpi", &identifiers);
+/// \endcode
+///
+/// Reference:
+///   http://code.google.com/p/chem-fingerprints/wiki/FPS
+///
+/// \see FingerprintIndex, PackedFingerprint
+
+// --- Construction and Destruction ---------------------------------------- //
+/// Creates a new FPS reader.
+FpsReader::FpsReader()
+    : d(new FpsReaderPrivate)
+{
+    d->input = 0;
+    d->size = 0;
+    d->hasLine = false;
+    d->lineNumber = 0;
+}
+
+/// Creates a new FPS reader and opens \p fileName.
+FpsReader::FpsReader(const std::string &fileName)
+    : d(new FpsReaderPrivate)
+{
+    d->input = 0;
+    d->size = 0;
+    d->hasLine = false;
+    d->lineNumber = 0;
+
+    open(fileName);
+}
+
+/// Destroys the FPS reader.
+FpsReader::~FpsReader()
+{
+    delete d;
+}
+
+// --- File ---------------------------------------------------------------- //
+/// Opens the FPS file \p fileName and reads its header. Returns
+/// \c false if the file could not be opened or its header is
+/// invalid.
+bool FpsReader::open(const std::string &fileName)
+{
+    close();
+
+    d->file.open(fileName.c_str());
+    if(!d->file.is_open()){
+        d->errorString = "Failed to open file '" + fileName + "'.";
+        return false;
+    }
+
+    d->input = &d->file;
+
+    if(!d->readHeader()){
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/// Reads FPS data from \p input. The stream must remain valid until
+/// the reader is closed.
+bool FpsReader::open(std::istream &input)
+{
+    close();
+
+    d->input = &input;
+
+    if(!d->readHeader()){
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/// Closes the file.
+void FpsReader::close()
+{
+    if(d->file.is_open()){
+        d->file.close();
+    }
+
+    d->file.clear();
+    d->input = 0;
+    d->hasLine = false;
+}
+
+/// Returns \c true if the reader is open.
+bool FpsReader::isOpen() const
+{
+    return d->input != 0;
+}
+
+// --- Header -------------------------------------------------------------- //
+/// Returns the number of bits in each fingerprint. This is given by
+/// the \c num_bits header or, if it is missing, by the length of
+/// the first fingerprint.
+size_t FpsReader::size() const
+{
+    return d->size;
+}
+
+/// Returns the fingerprint type from the \c type header (e.g.
+/// "chemkit-FP2/1").
+std::string FpsReader::type() const
+{
+    return headerValue("type");
+}
+
+/// Returns the value of the header with \p key (e.g. "software" or
+/// "date"). Returns an empty string if the file does not contain the
+/// header.
+std::string FpsReader::headerValue(const std::string &key) const
+{
+    std::map<std::string, std::string>::const_iterator iter = d->header.find(key);
+    if(iter == d->header.end()){
+        return std::string();
+    }
+
+    return iter->second;
+}
+
+// --- Fingerprints -------------------------------------------------------- //
+/// Reads the next fingerprint and its identifier from the file.
+/// Returns \c false at the end of the file or if the record is
+/// invalid.
+bool FpsReader::read(Bitset &fingerprint, std::string &identifier)
+{
+    size_t wordCount = (d->size + 63) / 64;
+    d->words.resize(wordCount);
+
+    if(!read(wordCount ? &d->words[0] : 0, wordCount, identifier)){
+        return false;
+    }
+
+    fingerprint.clear();
+    fingerprint.resize(d->size);
+
+    for(size_t i = 0; i < wordCount; i++){
+        Word word = d->words[i];
+
+        for(size_t j = 0; word; j++, word >>= 1){
+            if(word & 1){
+                fingerprint.set(i * 64 + j);
+            }
+        }
+    }
+
+    return true;
+}
+
+/// Reads the next fingerprint into the \p wordCount words starting at
+/// \p words and its identifier into \p identifier. Bit \c i is stored
+/// in word \c i / 64 at position \c i % 64 as in PackedFingerprint.
+/// Returns \c false at the end of the file or if the record is
+/// invalid.
+bool FpsReader::read(boost::uint64_t *words, size_t wordCount, std::string &identifier)
+{
+    if(!d->input || !d->nextRecord()){
+        return false;
+    }
+
+    return d->parseRecord(words, wordCount, identifier);
+}
+
+/// Reads each of the remaining fingerprints in the file and adds
+/// them to \p index. If \p identifiers is not \c 0 the identifier
+/// for each fingerprint is appended to it. Returns the number of
+/// fingerprints read.
+size_t FpsReader::read(FingerprintIndex &index, std::vector<std::string> *identifiers)
+{
+    size_t wordCount = (index.size() + 63) / 64;
+    d->words.resize(wordCount);
+
+    size_t count = 0;
+    std::string identifier;
+
+    while(read(wordCount ? &d->words[0] : 0, wordCount, identifier)){
+        index.add(wordCount ? &d->words[0] : 0, wordCount);
+
+        if(identifiers){
+            identifiers->push_back(identifier);
+        }
+
+        count++;
+    }
+
+    return count;
+}
+
+/// Reads each of the remaining fingerprints in the file and writes
+/// them to the fingerprint index file \p fileName. If \p identifiers
+/// is not \c 0 the identifier for each fingerprint is appended to it
+/// in the same order as the fingerprint indices. Returns \c false if
+/// the file could not be read or written.
+///
+/// The records are read twice with a FingerprintIndexWriter: once to
+/// count the fingerprints in each bucket and once to write them to
+/// the file. Only one fingerprint (and the identifiers) is held in
+/// memory at a time. If the input stream can not be repositioned the
+/// fingerprints are instead loaded into a FingerprintIndex which
+/// needs about twice the memory of the fingerprint data.
+///
+/// \see FingerprintIndex::read(), FingerprintIndexWriter
+bool FpsReader::convert(const std::string &fileName, std::vector<std::string> *identifiers)
+{
+    // remember the position of the first remaining record so that the
+    // records can be read a second time
+    std::istream::pos_type start = d->input ? d->input->tellg() : std::istream::pos_type(-1);
+    if(start == std::istream::pos_type(-1)){
+        FingerprintIndex index(d->size);
+        read(index, identifiers);
+
+        if(!d->errorString.empty()){
+            return false;
+        }
+
+        if(!index.write(fileName)){
+            d->errorString = index.errorString();
+            return false;
+        }
+
+        return true;
+    }
+
+    std::string startLine = d->line;
+    bool startHasLine = d->hasLine;
+    size_t startLineNumber = d->lineNumber;
+
+    size_t wordCount = (d->size + 63) / 64;
+    d->words.resize(wordCount);
+    Word *words = wordCount ? &d->words[0] : 0;
+    std::string identifier;
+
+    // count the fingerprints in each bucket
+    FingerprintIndexWriter writer(d->size);
+    while(read(words, wordCount, identifier)){
+        writer.reserve(words, wordCount);
+
+        if(identifiers){
+            identifiers->push_back(identifier);
+        }
+    }
+
+    if(!d->errorString.empty()){
+        return false;
+    }
+
+    // write each fingerprint to its position in the file
+    d->input->clear();
+    d->input->seekg(start);
+    d->line = startLine;
+    d->hasLine = startHasLine;
+    d->lineNumber = startLineNumber;
+
+    if(!writer.open(fileName)){
+        d->errorString = writer.errorString();
+        return false;
+    }
+
+    bool ok = true;
+    while(ok && read(words, wordCount, identifier)){
+        ok = writer.write(words, wordCount);
+    }
+
+    if(!ok){
+        d->errorString = writer.errorString();
+        writer.close();
+        return false;
+    }
+    else if(!d->errorString.empty()){
+        writer.close();
+        return false;
+    }
+
+    if(!writer.close()){
+        d->errorString = writer.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+// --- Error Handling ------------------------------------------------------ //
+/// Returns a string describing the last error that occured.
+std::string FpsReader::errorString() const
+{
+    return d->errorString;
+}
+
+} // end chemkit namespace
@@ -0,0 +1,92 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#ifndef CHEMKIT_FPSREADER_H
+#define CHEMKIT_FPSREADER_H
+
+#include "io.h"
+
+#include <string>
+#include <vector>
+#include <istream>
+
+#ifndef Q_MOC_RUN
+#include <boost/cstdint.hpp>
+#endif
+
+#include <chemkit/bitset.h>
+
+namespace chemkit {
+
+class FingerprintIndex;
+class FpsReaderPrivate;
+
+class CHEMKIT_IO_EXPORT FpsReader
+{
+public:
+    // construction and destruction
+    FpsReader();
+    FpsReader(const std::string &fileName);
+    ~FpsReader();
+
+    // file
+    bool open(const std::string &fileName);
+    bool open(std::istream &input);
+    void close();
+    bool isOpen() const;
+
+    // header
+    size_t size() const;
+    std::string type() const;
+    std::string headerValue(const std::string &key) const;
+
+    // fingerprints
+    bool read(Bitset &fingerprint, std::string &identifier);
+    bool read(boost::uint64_t *words, size_t wordCount, std::string &identifier);
+    size_t read(FingerprintIndex &index, std::vector<std::string> *identifiers = 0);
+    bool convert(const std::string &fileName, std::vector<std::string> *identifiers = 0);
+
+    // error handling
+    std::string errorString() const;
+
+private:
+    CHEMKIT_DISABLE_COPY(FpsReader)
+
+    FpsReaderPrivate* const d;
+};
+
+} // end chemkit namespace
+
+#endif // CHEMKIT_FPSREADER_H
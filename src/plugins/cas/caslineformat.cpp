@@ -69,5 +69,9 @@ chemkit::Molecule* CasLineFormat::read(const std::string &formula)
         return 0;
     }
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    return new chemkit::Molecule(std::move(*downloadedMolecule));
+#else
     return new chemkit::Molecule(*downloadedMolecule);
+#endif
 }
@@ -0,0 +1,299 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "ecfpfingerprint.h"
+
+#include <algorithm>
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/foreach.h>
+
+namespace {
+
+// default number of iterations used to grow each atom environment
+const int DefaultRadius = 2;
+
+// default number of bits in the folded fingerprint
+const size_t DefaultSize = 1024;
+
+// Combines value into the hash seed. This is the 32-bit form of the
+// boost::hash_combine() mixing function and is used in place of it so
+// that the identifiers are the same on every platform.
+inline unsigned int hashCombine(unsigned int seed, unsigned int value)
+{
+    return seed ^ (value + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+// The EcfpGraph class contains the heavy atom invariants and the
+// heavy atom adjacency for a molecule in flat arrays. Each iteration
+// updates the identifier for every atom from the sorted identifiers
+// of its neighbors so that the whole fingerprint is computed in
+// O(atoms * radius). The arrays keep their capacity when the graph
+// is reused for another molecule.
+class EcfpGraph
+{
+public:
+    void setMolecule(const chemkit::Molecule *molecule);
+    void identifiers(int radius, std::vector<unsigned int> &identifiers);
+
+private:
+    std::vector<size_t> m_heavyIndices;
+    std::vector<unsigned int> m_invariants;
+    std::vector<size_t> m_offsets;
+    std::vector<size_t> m_neighbors;
+    std::vector<unsigned char> m_bondCodes;
+    std::vector<unsigned int> m_current;
+    std::vector<unsigned int> m_next;
+    std::vector<unsigned long long> m_environment;
+};
+
+void EcfpGraph::setMolecule(const chemkit::Molecule *molecule)
+{
+    const size_t NoAtom = size_t(-1);
+
+    // map molecule atom indices to heavy atom indices
+    m_heavyIndices.assign(molecule->atomCount(), NoAtom);
+    size_t heavyAtomCount = 0;
+
+    foreach(const chemkit::Atom *atom, molecule->atoms()){
+        if(!atom->is(chemkit::Atom::Hydrogen)){
+            m_heavyIndices[atom->index()] = heavyAtomCount++;
+        }
+    }
+
+    m_invariants.clear();
+    m_offsets.clear();
+    m_neighbors.clear();
+    m_bondCodes.clear();
+
+    foreach(const chemkit::Atom *atom, molecule->atoms()){
+        if(m_heavyIndices[atom->index()] == NoAtom){
+            continue;
+        }
+
+        m_offsets.push_back(m_neighbors.size());
+
+        unsigned int hydrogenCount = 0;
+
+        foreach(const chemkit::Bond *bond, atom->bonds()){
+            size_t neighbor = m_heavyIndices[bond->otherAtom(atom)->index()];
+
+            if(neighbor == NoAtom){
+                hydrogenCount++;
+            }
+            else{
+                m_neighbors.push_back(neighbor);
+                m_bondCodes.push_back(bond->isAromatic() ? 4 : bond->order());
+            }
+        }
+
+        // initial atom invariant (similar to the daylight invariants)
+        unsigned int degree = static_cast<unsigned int>(m_neighbors.size() - m_offsets.back());
+
+        unsigned int invariant = 0;
+        invariant = hashCombine(invariant, atom->atomicNumber());
+        invariant = hashCombine(invariant, degree);
+        invariant = hashCombine(invariant, hydrogenCount);
+        invariant = hashCombine(invariant, static_cast<unsigned int>(atom->formalCharge()));
+        invariant = hashCombine(invariant, atom->isInRing());
+        m_invariants.push_back(invariant);
+    }
+
+    m_offsets.push_back(m_neighbors.size());
+}
+
+// Appends the identifier for each atom at each iteration from zero
+// to radius to identifiers.
+void EcfpGraph::identifiers(int radius, std::vector<unsigned int> &identifiers)
+{
+    size_t atomCount = m_invariants.size();
+
+    m_current.assign(m_invariants.begin(), m_invariants.end());
+    m_next.resize(atomCount);
+    identifiers.insert(identifiers.end(), m_current.begin(), m_current.end());
+
+    for(int iteration = 1; iteration <= radius; iteration++){
+        for(size_t atom = 0; atom < atomCount; atom++){
+            // each neighbor is packed as a (bond code, identifier) pair
+            // so that sorting the environment needs no comparator
+            m_environment.clear();
+            for(size_t i = m_offsets[atom]; i < m_offsets[atom + 1]; i++){
+                m_environment.push_back((static_cast<unsigned long long>(m_bondCodes[i]) << 32) |
+                                        m_current[m_neighbors[i]]);
+            }
+
+            std::sort(m_environment.begin(), m_environment.end());
+
+            unsigned int identifier = hashCombine(static_cast<unsigned int>(iteration), m_current[atom]);
+            for(size_t i = 0; i < m_environment.size(); i++){
+                identifier = hashCombine(identifier, static_cast<unsigned int>(m_environment[i] >> 32));
+                identifier = hashCombine(identifier, static_cast<unsigned int>(m_environment[i]));
+            }
+
+            m_next[atom] = identifier;
+        }
+
+        m_current.swap(m_next);
+        identifiers.insert(identifiers.end(), m_current.begin(), m_current.end());
+    }
+}
+
+} // end anonymous namespace
+
+// === EcfpFingerprint ===================================================== //
+// The EcfpFingerprint class implements an extended-connectivity
+// (circular) fingerprint in the style of Morgan and of Rogers and
+// Hahn.
+//
+// The following options are supported:
+//   - "radius": number of bonds each atom environment is grown by
+//               (default 2, which corresponds to ECFP4).
+//   - "size": number of bits the identifiers are folded into by
+//             value() (default 1024).
+//
+// The counts() method returns the unfolded 32-bit identifiers along
+// with the number of atom environments that produced each of them.
+EcfpFingerprint::EcfpFingerprint()
+    : chemkit::Fingerprint("ecfp")
+{
+}
+
+EcfpFingerprint::~EcfpFingerprint()
+{
+}
+
+size_t EcfpFingerprint::size() const
+{
+    return option("size").toSizeT();
+}
+
+chemkit::Bitset EcfpFingerprint::value(const chemkit::Molecule *molecule) const
+{
+    size_t size = this->size();
+
+    chemkit::Bitset fingerprint(size);
+    if(!size){
+        return fingerprint;
+    }
+
+    EcfpGraph graph;
+    graph.setMolecule(molecule);
+
+    std::vector<unsigned int> identifiers;
+    graph.identifiers(radius(), identifiers);
+
+    for(size_t i = 0; i < identifiers.size(); i++){
+        fingerprint.set(identifiers[i] % size);
+    }
+
+    return fingerprint;
+}
+
+std::map<size_t, size_t> EcfpFingerprint::counts(const chemkit::Molecule *molecule) const
+{
+    EcfpGraph graph;
+    graph.setMolecule(molecule);
+
+    std::vector<unsigned int> identifiers;
+    graph.identifiers(radius(), identifiers);
+
+    std::sort(identifiers.begin(), identifiers.end());
+
+    std::map<size_t, size_t> counts;
+
+    for(size_t i = 0; i < identifiers.size(); ){
+        size_t j = i + 1;
+        while(j < identifiers.size() && identifiers[j] == identifiers[i]){
+            j++;
+        }
+
+        counts.insert(counts.end(), std::make_pair(size_t(identifiers[i]), j - i));
+        i = j;
+    }
+
+    return counts;
+}
+
+chemkit::Variant EcfpFingerprint::defaultOption(const std::string &name) const
+{
+    if(name == "radius"){
+        return DefaultRadius;
+    }
+    else if(name == "size"){
+        return DefaultSize;
+    }
+
+    return chemkit::Variant();
+}
+
+// Writes the folded fingerprint for each molecule. The graph and the
+// identifiers are reused for every molecule in the block.
+void EcfpFingerprint::writeValues(const chemkit::Molecule *const *molecules,
+                                  size_t count,
+                                  size_t wordCount,
+                                  boost::uint64_t *output) const
+{
+    size_t size = std::min(this->size(), 64 * wordCount);
+    if(!size){
+        return;
+    }
+
+    int radius = this->radius();
+
+    EcfpGraph graph;
+    std::vector<unsigned int> identifiers;
+
+    for(size_t i = 0; i < count; i++){
+        graph.setMolecule(molecules[i]);
+
+        identifiers.clear();
+        graph.identifiers(radius, identifiers);
+
+        boost::uint64_t *words = output + i * wordCount;
+
+        for(size_t j = 0; j < identifiers.size(); j++){
+            size_t bit = identifiers[j] % size;
+
+            words[bit / 64] |= boost::uint64_t(1) << (bit % 64);
+        }
+    }
+}
+
+// Returns the number of iterations used to grow each environment.
+int EcfpFingerprint::radius() const
+{
+    return std::max(0, option("radius").toInt());
+}
@@ -36,6 +36,8 @@
 
 #include "fp2fingerprint.h"
 
+#include <algorithm>
+
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
 #include <chemkit/ring.h>
@@ -44,157 +46,283 @@
 // The FP2 fingerprint implementation is adapted from code provided
 // by Chris Morley.
 
-Fp2Fingerprint::Fp2Fingerprint()
-    : chemkit::Fingerprint("fp2")
+namespace {
+
+// number of bits in the fingerprint
+const size_t FingerprintSize = 1021;
+
+// maximum number of atoms in a fragment
+const size_t MaxFragmentSize = 7;
+
+// each fragment atom is stored as a (bond order, atomic number) pair
+const size_t MaxFragmentLength = 2 * MaxFragmentSize;
+
+// Returns the canonical hash value for the fragment.
+size_t canonicalHash(const unsigned char *fragment, size_t size)
 {
+    const size_t MODINT = 108; // 2^32 % 1021
+
+    // check if we need to reverse the fragment
+    bool reverse = false;
+
+    for(size_t i = 1; i < size; i++){
+        if(fragment[i] == fragment[size - i]){
+            continue;
+        }
+
+        reverse = fragment[i] < fragment[size - i];
+        break;
+    }
+
+    // calculate hash value
+    size_t hash = 0;
+
+    if(reverse){
+        for(size_t i = size - 1; i != 0; i--){
+            hash = (hash * MODINT + (fragment[i] % FingerprintSize)) % FingerprintSize;
+        }
+    }
+    else{
+        for(size_t i = 0; i < size; i++){
+            hash = (hash * MODINT + (fragment[i] % FingerprintSize)) % FingerprintSize;
+        }
+    }
+
+    return hash;
 }
 
-Fp2Fingerprint::~Fp2Fingerprint()
+// The Fp2Graph class contains the atom and bond labels for a molecule
+// in flat arrays. Fragments are enumerated with a fixed-depth explicit
+// stack and are built in place so that no memory is allocated while
+// walking the molecule. The arrays keep their capacity when the graph
+// is reused for another molecule.
+class Fp2Graph
 {
-}
+public:
+    void setMolecule(const chemkit::Molecule *molecule);
+    void addFragments(chemkit::Bitset &fingerprint);
 
-// Returns the FP2 fingerprint value for the molecule.
-chemkit::Bitset Fp2Fingerprint::value(const chemkit::Molecule *molecule) const
+private:
+    void addFragments(size_t atom, chemkit::Bitset &fingerprint);
+    void addRing(size_t size, chemkit::Bitset &fingerprint) const;
+
+private:
+    struct Frame {
+        size_t atom;
+        size_t bond;
+        size_t next;
+        unsigned char bondOrder;
+        unsigned char front;
+    };
+
+    std::vector<unsigned char> m_atomicNumbers;
+    std::vector<char> m_terminalHydrogens;
+    std::vector<size_t> m_offsets;
+    std::vector<size_t> m_neighbors;
+    std::vector<size_t> m_bonds;
+    std::vector<unsigned char> m_bondOrders;
+    std::vector<char> m_visited;
+    Frame m_stack[MaxFragmentSize];
+    unsigned char m_fragment[MaxFragmentLength];
+};
+
+void Fp2Graph::setMolecule(const chemkit::Molecule *molecule)
 {
-    // create bitset
-    chemkit::Bitset fingerprint(1021);
+    m_atomicNumbers.resize(molecule->atomCount());
+    m_terminalHydrogens.resize(molecule->atomCount());
+    m_offsets.assign(molecule->atomCount() + 1, 0);
+    m_visited.assign(molecule->atomCount(), false);
+    m_neighbors.clear();
+    m_bonds.clear();
+    m_bondOrders.clear();
 
     foreach(const chemkit::Atom *atom, molecule->atoms()){
+        size_t index = atom->index();
+
+        m_atomicNumbers[index] = atom->atomicNumber();
+        m_terminalHydrogens[index] = atom->isTerminalHydrogen();
+        m_offsets[index] = m_neighbors.size();
+
+        // neighbors are stored in the atom's bond order so that the
+        // fragments are visited in the same order as before
+        foreach(const chemkit::Bond *bond, atom->bonds()){
+            m_neighbors.push_back(bond->otherAtom(atom)->index());
+            m_bonds.push_back(bond->index());
+            m_bondOrders.push_back(bond->isAromatic() ? 5 : bond->order());
+        }
+    }
+
+    m_offsets[molecule->atomCount()] = m_neighbors.size();
+}
+
+// Adds the fragments starting at each atom to the fingerprint.
+void Fp2Graph::addFragments(chemkit::Bitset &fingerprint)
+{
+    for(size_t atom = 0; atom < m_atomicNumbers.size(); atom++){
         // skip fragments starting at terminal hydrogens
-        if(atom->isTerminalHydrogen()){
+        if(m_terminalHydrogens[atom]){
             continue;
         }
 
-        // add each atom fragment to the fingerprint
         addFragments(atom, fingerprint);
     }
-
-    return fingerprint;
 }
 
-// Add all fragments starting at atom to the fingerprint.
-void Fp2Fingerprint::addFragments(const chemkit::Atom *atom,
-                                  chemkit::Bitset &fingerprint) const
+// Adds all fragments starting at atom to the fingerprint.
+void Fp2Graph::addFragments(size_t atom, chemkit::Bitset &fingerprint)
 {
-    Fragment fragment;
-    chemkit::Bitset visited(atom->molecule()->atomCount());
-    extendFragment(fragment, 1, visited, atom, 0, atom, fingerprint);
-}
+    const size_t NoBond = size_t(-1);
 
-// Extend the fragment to atom.
-void Fp2Fingerprint::extendFragment(Fragment fragment,
-                                    size_t depth,
-                                    chemkit::Bitset visited,
-                                    const chemkit::Atom *atom,
-                                    const chemkit::Bond *bond,
-                                    const chemkit::Atom *firstAtom,
-                                    chemkit::Bitset &fingerprint) const
-{
-    const size_t MaxFragmentSize = 7;
+    // push the first atom
+    size_t depth = 1;
+    Frame *frame = &m_stack[0];
+    frame->atom = atom;
+    frame->bond = NoBond;
+    frame->next = m_offsets[atom];
+    frame->bondOrder = 0;
+    frame->front = 0;
+    m_fragment[0] = 0;
+    m_fragment[1] = m_atomicNumbers[atom];
+    m_visited[atom] = true;
 
-    chemkit::Bond::BondOrderType bondOrder = 0;
-    if(bond){
-        bondOrder = bond->isAromatic() ? 5 : bond->order();
-    }
+    while(depth){
+        frame = &m_stack[depth - 1];
 
-    fragment.push_back(bondOrder);
-    fragment.push_back(atom->atomicNumber());
-    visited.set(atom->index());
+        if(frame->next < m_offsets[frame->atom + 1]){
+            size_t i = frame->next++;
 
-    foreach(const chemkit::Bond *neighborBond, atom->bonds()){
-        if(neighborBond == bond){
-            continue; // don't retrace steps
-        }
+            if(m_bonds[i] == frame->bond){
+                continue; // don't retrace steps
+            }
 
-        const chemkit::Atom *neighbor = neighborBond->otherAtom(atom);
-        if(neighbor->isTerminalHydrogen()){
-            continue; // don't include terminal hydrogens
-        }
+            size_t neighbor = m_neighbors[i];
+            if(m_terminalHydrogens[neighbor]){
+                continue; // don't include terminal hydrogens
+            }
 
-        // if the neighbor is an atom that we've already visited
-        // then this fragment forms a ring
-        if(visited.test(neighbor->index())){
-            if(neighbor == firstAtom){
-                // add bond at front for the ring
-                fragment[0] = bondOrder;
-
-                // insert ring
-                Fragment ring = fragment;
-                Fragment canonicalRing = fragment;
-                for(size_t i = 0; i < ring.size() / 2; i++){
-                    // rotate atoms in ring
-                    std::rotate(ring.begin(), ring.begin() + 2, ring.end());
-                    if(ring > canonicalRing){
-                        canonicalRing = ring;
-                    }
-
-                    // reverse the ring
-                    Fragment reversedRing = ring;
-                    std::reverse(reversedRing.begin() + 1, reversedRing.end());
-                    if(reversedRing > canonicalRing){
-                        canonicalRing = reversedRing;
-                    }
-
-                    // add the non-ring form of all ring rotations
-                    Fragment ringCopy = ring;
-                    ringCopy[0] = 0;
-                    fingerprint.set(canonicalHash(ringCopy));
-                }
+            // if the neighbor is an atom that we've already visited
+            // then this fragment forms a ring
+            if(m_visited[neighbor]){
+                if(neighbor == atom){
+                    // add bond at front for the ring
+                    m_fragment[0] = frame->bondOrder;
 
-                fingerprint.set(canonicalHash(canonicalRing));
+                    addRing(2 * depth, fingerprint);
+                }
+            }
+            // no ring
+            else if(depth < MaxFragmentSize){
+                // extend fragment to the next atom. the bond at the front
+                // of the fragment is saved because rings closed by the
+                // next atom overwrite it
+                Frame *next = &m_stack[depth];
+                next->atom = neighbor;
+                next->bond = m_bonds[i];
+                next->next = m_offsets[neighbor];
+                next->bondOrder = m_bondOrders[i];
+                next->front = m_fragment[0];
+                m_fragment[2 * depth] = m_bondOrders[i];
+                m_fragment[2 * depth + 1] = m_atomicNumbers[neighbor];
+                m_visited[neighbor] = true;
+                depth++;
             }
         }
-        // no ring
         else{
-            if(depth < MaxFragmentSize){
-                // extend fragment to the next atom
-                extendFragment(fragment,
-                               depth+1,
-                               visited,
-                               neighbor,
-                               neighborBond,
-                               firstAtom,
-                               fingerprint);
+            // do not save C, N, O single atom fragments
+            if(m_fragment[0] == 0 && (depth > 1 || m_fragment[1] > 8 || m_fragment[1] < 6)){
+                fingerprint.set(canonicalHash(m_fragment, 2 * depth));
             }
-        }
-    }
 
-    // do not save C, N, O single atom fragments
-    if(fragment[0] == 0 && (depth > 1 || fragment[1] > 8 || fragment[1] < 6)){
-        fingerprint.set(canonicalHash(fragment));
+            // pop the atom
+            m_visited[frame->atom] = false;
+            m_fragment[0] = frame->front;
+            depth--;
+        }
     }
 }
 
-// Returns the canonical hash value for the fragment.
-size_t Fp2Fingerprint::canonicalHash(const Fragment &fragment)
+// Adds the ring contained in the first size elements of the fragment
+// along with the non-ring form of each of its rotations.
+void Fp2Graph::addRing(size_t size, chemkit::Bitset &fingerprint) const
 {
-    const size_t MODINT = 108; // 2^32 % 1021
+    unsigned char ring[MaxFragmentLength];
+    unsigned char canonicalRing[MaxFragmentLength];
+    unsigned char reversedRing[MaxFragmentLength];
 
-    // check if we need to reverse the fragment
-    bool reverse = false;
+    std::copy(m_fragment, m_fragment + size, ring);
+    std::copy(m_fragment, m_fragment + size, canonicalRing);
 
-    for(size_t i = 1; i < fragment.size(); i++){
-        if(*(fragment.begin() + i) == *(fragment.end() - i)){
-            continue;
+    for(size_t i = 0; i < size / 2; i++){
+        // rotate atoms in ring
+        std::rotate(ring, ring + 2, ring + size);
+        if(std::lexicographical_compare(canonicalRing, canonicalRing + size, ring, ring + size)){
+            std::copy(ring, ring + size, canonicalRing);
         }
 
-        reverse = *(fragment.begin() + i) < *(fragment.end() - i);
-        break;
+        // reverse the ring
+        reversedRing[0] = ring[0];
+        std::reverse_copy(ring + 1, ring + size, reversedRing + 1);
+        if(std::lexicographical_compare(canonicalRing, canonicalRing + size, reversedRing, reversedRing + size)){
+            std::copy(reversedRing, reversedRing + size, canonicalRing);
+        }
+
+        // add the non-ring form of all ring rotations
+        unsigned char front = ring[0];
+        ring[0] = 0;
+        fingerprint.set(canonicalHash(ring, size));
+        ring[0] = front;
     }
 
-    // calculate hash value
-    size_t hash = 0;
+    fingerprint.set(canonicalHash(canonicalRing, size));
+}
 
-    if(reverse){
-        for(size_t i = fragment.size() - 1; i != 0; i--){
-            hash = (hash * MODINT + (fragment[i] % 1021)) % 1021;
-        }
-    }
-    else{
-        for(size_t i = 0; i < fragment.size(); i++){
-            hash = (hash * MODINT + (fragment[i] % 1021)) % 1021;
+} // end anonymous namespace
+
+// === Fp2Fingerprint ====================================================== //
+Fp2Fingerprint::Fp2Fingerprint()
+    : chemkit::Fingerprint("fp2")
+{
+}
+
+Fp2Fingerprint::~Fp2Fingerprint()
+{
+}
+
+// Returns the FP2 fingerprint value for the molecule.
+chemkit::Bitset Fp2Fingerprint::value(const chemkit::Molecule *molecule) const
+{
+    // create bitset
+    chemkit::Bitset fingerprint(FingerprintSize);
+
+    Fp2Graph graph;
+    graph.setMolecule(molecule);
+    graph.addFragments(fingerprint);
+
+    return fingerprint;
+}
+
+// Writes the FP2 fingerprint for each molecule. The graph and the
+// bitset are reused for every molecule in the block.
+void Fp2Fingerprint::writeValues(const chemkit::Molecule *const *molecules,
+                                 size_t count,
+                                 size_t wordCount,
+                                 boost::uint64_t *output) const
+{
+    Fp2Graph graph;
+    chemkit::Bitset fingerprint(FingerprintSize);
+
+    for(size_t i = 0; i < count; i++){
+        graph.setMolecule(molecules[i]);
+
+        fingerprint.reset();
+        graph.addFragments(fingerprint);
+
+        boost::uint64_t *words = output + i * wordCount;
+
+        for(size_t bit = fingerprint.find_first(); bit != chemkit::Bitset::npos; bit = fingerprint.find_next(bit)){
+            if(bit < 64 * wordCount){
+                words[bit / 64] |= boost::uint64_t(1) << (bit % 64);
+            }
         }
     }
-
-    return hash;
 }
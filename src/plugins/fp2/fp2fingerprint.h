@@ -36,8 +36,6 @@
 #ifndef FP2FINGERPRINT_H
 #define FP2FINGERPRINT_H
 
-#include <vector>
-
 #include <chemkit/molecule.h>
 #include <chemkit/fingerprint.h>
 
@@ -49,19 +47,11 @@ public:
 
     chemkit::Bitset value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
 
-private:
-    typedef std::vector<unsigned char> Fragment;
-
-    void addFragments(const chemkit::Atom *atom,
-                      chemkit::Bitset &fingerprint) const;
-    void extendFragment(Fragment fragment,
-                        size_t depth,
-                        chemkit::Bitset visited,
-                        const chemkit::Atom *atom,
-                        const chemkit::Bond *bond,
-                        const chemkit::Atom *firstAtom,
-                        chemkit::Bitset &fingerprint) const;
-    static size_t canonicalHash(const Fragment &fragment);
+protected:
+    void writeValues(const chemkit::Molecule *const *molecules,
+                     size_t count,
+                     size_t wordCount,
+                     boost::uint64_t *output) const CHEMKIT_OVERRIDE;
 };
 
 #endif // FP2FINGERPRINT_H
@@ -36,70 +36,39 @@
 #include "fpsfileformat.h"
 
 #include <ctime>
-#include <iomanip>
+#include <algorithm>
 
-#include <chemkit/foreach.h>
 #include <chemkit/fingerprint.h>
 #include <chemkit/moleculefile.h>
 
 namespace {
 
-// Output iterator which writes bitset blocks to an output stream.
-struct FingerprintWriter : public std::iterator<std::output_iterator_tag, void, void, void, void>
-{
-    typedef chemkit::Bitset::block_type value_type;
-
-    FingerprintWriter(std::ostream *output)
-        : m_output(output)
-    {
-    }
+// number of molecules whose fingerprints are calculated together
+const size_t BatchSize = 4096;
 
-    FingerprintWriter(const FingerprintWriter &other)
-        : m_output(other.m_output)
-    {
-    }
+// Writes the first size bits of the fingerprint stored in words to
+// the output stream as hex. Each byte is written with its low bit
+// first as required by the FPS format.
+void writeFingerprint(const boost::uint64_t *words, size_t size, std::ostream &output)
+{
+    const char *digits = "0123456789abcdef";
 
-    FingerprintWriter& operator=(const FingerprintWriter &other)
-    {
-        if(this != &other){
-            m_output = other.m_output;
-        }
+    char buffer[16];
+    size_t byteCount = (size + 7) / 8;
 
-        return *this;
-    }
+    for(size_t i = 0; i < byteCount; i += 8){
+        size_t count = (std::min)(byteCount - i, size_t(8));
 
-    FingerprintWriter& operator=(const value_type &value)
-    {
-        const unsigned char *bytes =
-            reinterpret_cast<const unsigned char *>(&value);
+        for(size_t j = 0; j < count; j++){
+            unsigned int byte = (words[i / 8] >> (8 * j)) & 0xff;
 
-        for(size_t i = 0; i < sizeof(value_type); i++){
-            *m_output << std::hex
-                      << std::setw(2)
-                      << std::setfill('0')
-                      << static_cast<int>(bytes[i]);
+            buffer[2 * j] = digits[byte >> 4];
+            buffer[2 * j + 1] = digits[byte & 0xf];
         }
 
-        return *this;
-    }
-
-    FingerprintWriter& operator*()
-    {
-        return *this;
-    }
-
-    FingerprintWriter& operator++()
-    {
-        return *this;
-    }
-
-    FingerprintWriter& operator++(int)
-    {
-        return *this;
+        output.write(buffer, 2 * count);
     }
-
-    std::ostream *m_output;
-};
+}
 
 } // end anonymous namespace
 
@@ -124,28 +93,47 @@ bool FpsFileFormat::write(const chemkit::MoleculeFile *file, std::ostream &outpu
         return false;
     }
 
+    size_t size = fingerprint->size();
+    size_t wordCount = (size + 63) / 64;
+
     // write header
     output << "#FPS1" << std::endl;
-    output << "#num_bits=" << fingerprint->size() << std::endl;
+    output << "#num_bits=" << size << std::endl;
     output << "#type=" << fingerprintTypeString() << std::endl;
     output << "#software=chemkit/" << CHEMKIT_VERSION_STRING << std::endl;
     output << "#date=" << dateTimeString() << std::endl;
 
-    // create output writer
-    FingerprintWriter writer(&output);
-
+    // calculate the fingerprints in batches on every processor and
     // write each molecule's fingerprint and identifier
-    foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file->molecules()){
-        // write fingerprint
-        boost::to_block_range(fingerprint->value(molecule.get()), writer);
-
-        // write identifier (name if available, else molecular formula)
-        std::string identifier = molecule->name();
-        if(identifier.empty()){
-            identifier = molecule->formula();
+    chemkit::MoleculeFile::MoleculeRange molecules = file->molecules();
+
+    std::vector<chemkit::Molecule *> batch;
+    std::vector<boost::uint64_t> words;
+
+    size_t moleculeCount = molecules.size();
+
+    for(size_t begin = 0; begin < moleculeCount; begin += BatchSize){
+        size_t end = (std::min)(begin + BatchSize, moleculeCount);
+
+        batch.clear();
+        for(size_t i = begin; i < end; i++){
+            batch.push_back(molecules[i].get());
         }
 
-        output << "\t" << identifier << "\n";
+        fingerprint->values(batch, words, 0);
+
+        for(size_t i = 0; i < batch.size(); i++){
+            // write fingerprint
+            writeFingerprint(&words[i * wordCount], size, output);
+
+            // write identifier (name if available, else molecular formula)
+            std::string identifier = batch[i]->name();
+            if(identifier.empty()){
+                identifier = batch[i]->formula();
+            }
+
+            output << "\t" << identifier << "\n";
+        }
     }
 
     return true;
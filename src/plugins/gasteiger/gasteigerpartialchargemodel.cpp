@@ -38,6 +38,7 @@
 #include <chemkit/atom.h>
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
+#include <chemkit/moleculeview.h>
 
 namespace {
 
@@ -95,25 +96,25 @@ void GasteigerPartialChargeModel::setMolecule(const chemkit::Molecule *molecule)
         m_electronegativies[i] = parameters->a;
     }
 
+    // flat view of the molecule's structure for the iterations below
+    chemkit::MoleculeView view(molecule);
+
     // run algorithm for six iterations
     for(int iteration = 1; iteration <= 6; iteration++){
 
         // calculate charges
-        for(size_t i = 0; i < molecule->atomCount(); i++){
-            const chemkit::Atom *atom = molecule->atom(i);
-
+        for(size_t i = 0; i < view.atomCount(); i++){
             chemkit::Real qi = 0;
             chemkit::Real Xi = m_electronegativies[i];
             const GasteigerParameters *pi = m_parameters[i];
 
-            foreach(const chemkit::Atom *neighbor, atom->neighbors()){
-                int j = neighbor->index();
+            foreach(size_t j, view.neighbors(i)){
                 chemkit::Real Xj = m_electronegativies[j];
                 const GasteigerParameters *pj = m_parameters[j];
 
                 chemkit::Real scale;
                 if(Xj > Xi){
-                    if(atom->is(chemkit::Atom::Hydrogen)){
+                    if(view.is(i, chemkit::Atom::Hydrogen)){
                         scale = 1.0 / 20.02;
                     }
                     else{
@@ -121,7 +122,7 @@ void GasteigerPartialChargeModel::setMolecule(const chemkit::Molecule *molecule)
                     }
                 }
                 else{
-                    if(neighbor->is(chemkit::Atom::Hydrogen)){
+                    if(view.is(j, chemkit::Atom::Hydrogen)){
                         scale = 1.0 / 20.02;
                     }
                     else{
@@ -144,6 +144,10 @@ bool MdlFileFormat::readMolFile(std::istream &input, chemkit::MoleculeFile *file
         molecule->setName(title);
     }
 
+    // allocate storage for the atoms and bonds
+    molecule->setAtomCapacity(atomCount);
+    molecule->setBondCapacity(bondCount);
+
     // read atoms
     readAtomBlock(input, molecule.get(), atomCount);
 
@@ -524,6 +524,16 @@ void PdbFile::writePolymerFile(chemkit::PolymerFile *file)
         polymer->setName(m_title);
     }
 
+    // allocate storage for all of the polymer's atoms at once
+    size_t atomCount = 0;
+    foreach(const PdbChain *pdbChain, m_chains){
+        foreach(const PdbResidue *pdbResidue, pdbChain->residues()){
+            atomCount += pdbResidue->atoms().size();
+        }
+    }
+
+    polymer->setAtomCapacity(atomCount);
+
     std::map<int, chemkit::Atom *> atomIds;
     PdbChain::Type chainType = PdbChain::Protein;
 
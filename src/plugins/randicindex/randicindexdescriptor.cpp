@@ -35,10 +35,12 @@
 
 #include "randicindexdescriptor.h"
 
+#include <vector>
+
 #include <chemkit/atom.h>
-#include <chemkit/bond.h>
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
+#include <chemkit/moleculeview.h>
 
 RandicIndexDescriptor::RandicIndexDescriptor()
     : chemkit::MolecularDescriptor("randic-index")
@@ -53,32 +55,32 @@ RandicIndexDescriptor::~RandicIndexDescriptor()
 // Returns the randic index for the molecule. See [Randic 1975].
 chemkit::Variant RandicIndexDescriptor::value(const chemkit::Molecule *molecule) const
 {
-    chemkit::Real value = 0;
+    chemkit::MoleculeView view(molecule);
 
-    foreach(const chemkit::Bond *bond, molecule->bonds()){
-        if(bond->isTerminal() && bond->contains(chemkit::Atom::Hydrogen)){
-            continue;
+    // count the non-hydrogen neighbors of each atom
+    std::vector<int> heavyNeighborCounts(view.size(), 0);
+    for(size_t i = 0; i < view.size(); i++){
+        foreach(size_t neighbor, view.neighbors(i)){
+            if(!view.is(neighbor, chemkit::Atom::Hydrogen)){
+                heavyNeighborCounts[i]++;
+            }
         }
-
-        const chemkit::Atom *a = bond->atom1();
-        const chemkit::Atom *b = bond->atom2();
-
-        value += 1.0 / sqrt(chemkit::Real(heavyNeighborCount(a) * heavyNeighborCount(b)));
     }
 
-    return value;
-}
+    chemkit::Real value = 0;
 
-// Returns the number of non-hydrogen neighbors for atom.
-int RandicIndexDescriptor::heavyNeighborCount(const chemkit::Atom *atom) const
-{
-    int count = 0;
+    for(size_t bond = 0; bond < view.bondCount(); bond++){
+        size_t a = view.bondAtom1(bond);
+        size_t b = view.bondAtom2(bond);
 
-    foreach(const chemkit::Atom *neighbor, atom->neighbors()){
-        if(!neighbor->is(chemkit::Atom::Hydrogen)){
-            count++;
+        // skip terminal bonds to hydrogen
+        bool terminal = view.neighborCount(a) == 1 || view.neighborCount(b) == 1;
+        if(terminal && (view.is(a, chemkit::Atom::Hydrogen) || view.is(b, chemkit::Atom::Hydrogen))){
+            continue;
         }
+
+        value += 1.0 / sqrt(chemkit::Real(heavyNeighborCounts[a] * heavyNeighborCounts[b]));
     }
 
-    return count;
+    return value;
 }
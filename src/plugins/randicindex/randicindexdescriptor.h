@@ -36,7 +36,6 @@
 #ifndef RANDICINDEXDESCRIPTOR_H
 #define RANDICINDEXDESCRIPTOR_H
 
-#include <chemkit/atom.h>
 #include <chemkit/moleculardescriptor.h>
 
 class RandicIndexDescriptor : public chemkit::MolecularDescriptor
@@ -46,9 +45,6 @@ public:
     ~RandicIndexDescriptor();
 
     chemkit::Variant value(const chemkit::Molecule *molecule) const CHEMKIT_OVERRIDE;
-
-private:
-    int heavyNeighborCount(const chemkit::Atom *atom) const;
 };
 
 #endif // RANDICINDEXDESCRIPTOR_H
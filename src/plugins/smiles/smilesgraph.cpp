@@ -51,6 +51,38 @@
 
 #include "smiles.h"
 
+namespace {
+
+// Sets the number of implicit hydrogens for node and returns the other
+// neighbors of its atom sorted from the highest to the lowest rank.
+std::vector<const chemkit::Atom *> rankedNeighbors(SmilesGraphNode *node, const std::vector<size_t> &ranks)
+{
+    std::vector<std::pair<size_t, const chemkit::Atom *> > neighbors;
+    int hydrogenCount = 0;
+
+    foreach(const chemkit::Atom *neighbor, node->atom()->neighbors()){
+        if(isImplicitHydrogen(neighbor)){
+            hydrogenCount++;
+        }
+        else{
+            neighbors.push_back(std::make_pair(ranks[neighbor->index()], neighbor));
+        }
+    }
+
+    node->setHydrogenCount(hydrogenCount);
+
+    std::sort(neighbors.rbegin(), neighbors.rend());
+
+    std::vector<const chemkit::Atom *> atoms;
+    for(size_t i = 0; i < neighbors.size(); i++){
+        atoms.push_back(neighbors[i].second);
+    }
+
+    return atoms;
+}
+
+} // end anonymous namespace
+
 // === SmilesGraphNode ===================================================== //
 SmilesGraphNode::SmilesGraphNode(const chemkit::Atom *atom)
     : m_atom(atom),
@@ -343,6 +375,73 @@ SmilesGraph::SmilesGraph(const chemkit::Molecule *molecule)
     }
 }
 
+// Builds the graph with a depth-first traversal that visits atoms and
+// their neighbors in the order given by ranks. Rings are closed at each
+// bond leading back to an atom already in the graph so the output only
+// depends on the ranks and not on the order of the atoms or the rings
+// perceived for the molecule.
+SmilesGraph::SmilesGraph(const chemkit::Molecule *molecule, const std::vector<size_t> &ranks)
+{
+    // atoms in rank order
+    std::vector<const chemkit::Atom *> atoms(molecule->size());
+    for(size_t i = 0; i < molecule->size(); i++){
+        atoms[ranks[i]] = molecule->atom(i);
+    }
+
+    std::vector<SmilesGraphNode *> nodes(molecule->size(), 0);
+    std::vector<bool> visitedBonds(molecule->bondCount(), false);
+
+    // depth-first search stack of nodes and their unvisited neighbors
+    std::vector<std::pair<SmilesGraphNode *, std::vector<const chemkit::Atom *> > > stack;
+
+    foreach(const chemkit::Atom *rootAtom, atoms){
+        if(nodes[rootAtom->index()] || isImplicitHydrogen(rootAtom)){
+            continue;
+        }
+
+        int ringNumber = 1;
+
+        SmilesGraphNode *rootNode = new SmilesGraphNode(rootAtom);
+        nodes[rootAtom->index()] = rootNode;
+        m_rootNodes.push_back(rootNode);
+        stack.push_back(std::make_pair(rootNode, rankedNeighbors(rootNode, ranks)));
+
+        while(!stack.empty()){
+            SmilesGraphNode *node = stack.back().first;
+            std::vector<const chemkit::Atom *> &neighbors = stack.back().second;
+
+            if(neighbors.empty()){
+                stack.pop_back();
+                continue;
+            }
+
+            const chemkit::Atom *neighbor = neighbors.back();
+            neighbors.pop_back();
+
+            const chemkit::Bond *bond = node->atom()->bondTo(neighbor);
+            if(visitedBonds[bond->index()]){
+                continue;
+            }
+
+            visitedBonds[bond->index()] = true;
+
+            SmilesGraphNode *neighborNode = nodes[neighbor->index()];
+            if(neighborNode){
+                // bond back to an atom already in the graph
+                neighborNode->addRing(ringNumber, bond->order());
+                node->addRing(ringNumber, 0);
+                ringNumber++;
+            }
+            else{
+                neighborNode = new SmilesGraphNode(neighbor);
+                nodes[neighbor->index()] = neighborNode;
+                neighborNode->setParent(node, bond->order());
+                stack.push_back(std::make_pair(neighborNode, rankedNeighbors(neighborNode, ranks)));
+            }
+        }
+    }
+}
+
 SmilesGraph::~SmilesGraph()
 {
     foreach(SmilesGraphNode *node, m_rootNodes){
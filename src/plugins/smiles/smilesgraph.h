@@ -78,6 +78,7 @@ class SmilesGraph
 {
 public:
     SmilesGraph(const chemkit::Molecule *molecule);
+    SmilesGraph(const chemkit::Molecule *molecule, const std::vector<size_t> &ranks);
     ~SmilesGraph();
 
     std::string toString(bool kekulize) const;
@@ -49,6 +49,7 @@
 #include <boost/format.hpp>
 
 #include <chemkit/foreach.h>
+#include <chemkit/canonicalranker.h>
 
 #include "smiles.h"
 #include "kekulizer.h"
@@ -179,6 +180,7 @@ struct RingState
     chemkit::Atom *firstAtom;
     int bondOrder;
     bool aromatic;
+    size_t position;
 };
 
 } // end anonymous namespace
@@ -198,6 +200,8 @@ chemkit::Variant SmilesLineFormat::defaultOption(const std::string &name) const
         return true;
     else if(name == "kekulize")
         return false;
+    else if(name == "canonical")
+        return false;
     else
         return chemkit::Variant();
 }
@@ -248,6 +252,7 @@ bracket_atom:
     p++; // move past opening bracket
 
     // mass number
+    number = 0;
     if(isdigit(*p)){
         number = readNumber(&p);
     }
@@ -523,6 +528,27 @@ ring:
         rings.erase(number);
         bond = molecule->addBond(ringState.firstAtom, lastAtom, ringState.bondOrder);
 
+        // the chirality of the first atom refers to the order its
+        // neighbors are written in, where the ring bond is at the
+        // position of the ring number rather than at the end
+        if(ringState.firstAtom->isChiral()){
+            size_t position = ringState.position;
+            for(std::map<int, RingState>::const_iterator i = rings.begin(); i != rings.end(); ++i){
+                if(i->second.firstAtom == ringState.firstAtom && i->second.position < ringState.position){
+                    position--;
+                }
+            }
+
+            if((ringState.firstAtom->neighborCount() - 1 - position) % 2){
+                if(ringState.firstAtom->chirality() == chemkit::Stereochemistry::R){
+                    ringState.firstAtom->setChirality(chemkit::Stereochemistry::S);
+                }
+                else if(ringState.firstAtom->chirality() == chemkit::Stereochemistry::S){
+                    ringState.firstAtom->setChirality(chemkit::Stereochemistry::R);
+                }
+            }
+        }
+
         if(aromatic && ringState.aromatic){
             aromaticBonds.push_back(bond);
         }
@@ -532,6 +558,12 @@ ring:
         ringState.firstAtom = lastAtom;
         ringState.bondOrder = bondOrder;
         ringState.aromatic = aromatic;
+        ringState.position = lastAtom->neighborCount();
+        for(std::map<int, RingState>::const_iterator i = rings.begin(); i != rings.end(); ++i){
+            if(i->second.firstAtom == lastAtom){
+                ringState.position++;
+            }
+        }
         rings[number] = ringState;
     }
 
@@ -626,5 +658,11 @@ std::string SmilesLineFormat::write(const chemkit::Molecule *molecule)
 {
     bool kekulize = option("kekulize").toBool();
 
+    if(option("canonical").toBool()){
+        chemkit::CanonicalRanker ranker(molecule);
+
+        return SmilesGraph(molecule, ranker.ranks()).toString(kekulize);
+    }
+
     return SmilesGraph(molecule).toString(kekulize);
 }
@@ -35,55 +35,13 @@
 
 #include "wienerindexdescriptor.h"
 
-#include <set>
 #include <vector>
+#include <algorithm>
 
 #include <chemkit/atom.h>
 #include <chemkit/foreach.h>
 #include <chemkit/molecule.h>
-
-namespace {
-
-// Returns the graph distance between the two atoms.
-int distanceBetween(const chemkit::Atom *a, const chemkit::Atom *b)
-{
-    int distance = 0;
-
-    std::set<const chemkit::Atom*> visited;
-
-    std::vector<const chemkit::Atom*> row;
-    row.push_back(a);
-
-    while(!row.empty()){
-        std::vector<const chemkit::Atom*> nextRow;
-
-        foreach(const chemkit::Atom *atom, row){
-            if(atom == b){
-                return distance;
-            }
-
-            visited.insert(atom);
-
-            foreach(const chemkit::Atom *neighbor, atom->neighbors()){
-                if(visited.find(neighbor) != visited.end()){
-                    continue;
-                }
-                else if(neighbor->isTerminalHydrogen()){
-                    continue;
-                }
-
-                nextRow.push_back(neighbor);
-            }
-        }
-
-        row = nextRow;
-        distance++;
-    }
-
-    return 0;
-}
-
-} // end anonymous namespace
+#include <chemkit/moleculeview.h>
 
 WienerIndexDescriptor::WienerIndexDescriptor()
     : chemkit::MolecularDescriptor("wiener-index")
@@ -95,24 +53,49 @@ WienerIndexDescriptor::~WienerIndexDescriptor()
 {
 }
 
-// Returns the wiener index for the molecule.
+// Returns the wiener index for the molecule. The distances are found
+// with one breadth-first search per atom so that no distance matrix is
+// kept in memory.
 chemkit::Variant WienerIndexDescriptor::value(const chemkit::Molecule *molecule) const
 {
+    chemkit::MoleculeView view(molecule);
+
+    // terminal hydrogens are not included in the index
+    std::vector<bool> included(view.size());
+    for(size_t i = 0; i < view.size(); i++){
+        included[i] = !view.isTerminalHydrogen(i);
+    }
+
     int index = 0;
 
-    for(size_t i = 0; i < molecule->atomCount(); i++){
-        const chemkit::Atom *a = molecule->atom(i);
-        if(a->isTerminalHydrogen()){
+    std::vector<int> distances(view.size());
+    std::vector<size_t> queue;
+    queue.reserve(view.size());
+
+    for(size_t i = 0; i < view.size(); i++){
+        if(!included[i]){
             continue;
         }
 
-        for(size_t j = i + 1; j < molecule->atomCount(); j++){
-            const chemkit::Atom *b = molecule->atom(j);
-            if(b->isTerminalHydrogen()){
-                continue;
+        std::fill(distances.begin(), distances.end(), -1);
+        queue.clear();
+        queue.push_back(i);
+        distances[i] = 0;
+
+        for(size_t position = 0; position < queue.size(); position++){
+            size_t atom = queue[position];
+
+            // count each pair of atoms once
+            if(atom > i && included[atom]){
+                index += distances[atom];
             }
 
-            index += distanceBetween(a, b);
+            foreach(size_t neighbor, view.neighbors(atom)){
+                if(distances[neighbor] == -1){
+                    distances[neighbor] = distances[atom] + 1;
+                    queue.push_back(neighbor);
+                }
+            }
         }
     }
 
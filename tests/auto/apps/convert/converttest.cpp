@@ -135,4 +135,48 @@ void ConvertTest::convertBenzenes()
     }
 }
 
+void ConvertTest::convertUnique()
+{
+    // setup input file with duplicate molecules
+    QTemporaryFile inputFile("XXXXXX.smi");
+    inputFile.open();
+    inputFile.write("CCO ethanol\n");
+    inputFile.write("c1ccccc1 benzene\n");
+    inputFile.write("OCC ethanol-2\n");
+    inputFile.write("C1=CC=CC=C1 benzene-2\n");
+    inputFile.write("COC ether\n");
+    inputFile.close();
+
+    // setup output file
+    QTemporaryFile outputFile("XXXXXX.smi");
+    outputFile.open();
+
+    // setup arguments
+    QStringList arguments;
+    arguments.append("--unique");
+    arguments.append(inputFile.fileName());
+    arguments.append(outputFile.fileName());
+
+    // run chemkit-convert
+    QProcess process;
+    process.start(convertApplication, arguments);
+    process.waitForFinished();
+    process.close();
+
+    // read and verify the output file
+    chemkit::MoleculeFile file;
+    QByteArray outputFileName = outputFile.fileName().toAscii();
+    bool ok = file.read(outputFileName.constData());
+    if(!ok){
+        qDebug() << file.errorString().c_str();
+    }
+    QCOMPARE(ok, true);
+    QCOMPARE(file.moleculeCount(), size_t(3));
+
+    // the first of each duplicate is kept
+    QCOMPARE(file.molecule(0)->name(), std::string("ethanol"));
+    QCOMPARE(file.molecule(1)->name(), std::string("benzene"));
+    QCOMPARE(file.molecule(2)->name(), std::string("ether"));
+}
+
 QTEST_APPLESS_MAIN(ConvertTest)
@@ -45,6 +45,7 @@ class ConvertTest : public QObject
     private slots:
         void convertEthanol();
         void convertBenzenes();
+        void convertUnique();
 };
 
 #endif // CONVERTTEST_H
@@ -36,6 +36,7 @@
 #include "atomtest.h"
 
 #include <chemkit/atom.h>
+#include <chemkit/ring.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
 
@@ -228,6 +229,34 @@ void AtomTest::rings()
             QVERIFY(atom->smallestRing() == benzeneRing);
         }
     }
+
+    // indane has a five and a six membered ring which share two atoms
+    chemkit::Molecule indane("C1Cc2ccccc2C1", "smiles");
+    QCOMPARE(indane.ringCount(), size_t(2));
+
+    size_t fusedAtomCount = 0;
+    foreach(chemkit::Atom *atom, indane.atoms()){
+        if(atom->ringCount() == 2){
+            fusedAtomCount++;
+            QCOMPARE(atom->isInRing(5), true);
+            QCOMPARE(atom->isInRing(6), true);
+            QCOMPARE(atom->smallestRing()->size(), size_t(5));
+        }
+    }
+    QCOMPARE(fusedAtomCount, size_t(2));
+
+    // atoms added after ring perception are not in a ring
+    chemkit::Atom *C10 = indane.addAtom("C");
+    QCOMPARE(C10->ringCount(), size_t(0));
+    QVERIFY(C10->smallestRing() == 0);
+
+    // breaking the five membered ring leaves only the six membered ring
+    indane.removeAtom(indane.atom(0));
+    QCOMPARE(indane.ringCount(), size_t(1));
+    foreach(chemkit::Atom *atom, indane.atoms()){
+        QVERIFY(atom->ringCount() <= 1);
+        QCOMPARE(atom->isInRing(5), false);
+    }
 }
 
 void AtomTest::position()
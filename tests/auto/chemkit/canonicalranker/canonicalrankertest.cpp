@@ -0,0 +1,161 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "canonicalrankertest.h"
+
+#include <algorithm>
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/foreach.h>
+#include <chemkit/molecule.h>
+#include <chemkit/canonicalranker.h>
+
+void CanonicalRankerTest::basic()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *O3 = molecule.addAtom("O");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, O3);
+
+    chemkit::CanonicalRanker ranker(&molecule);
+    QVERIFY(ranker.molecule() == &molecule);
+    QCOMPARE(ranker.size(), size_t(3));
+
+    // every atom gets a distinct rank
+    std::vector<size_t> ranks = ranker.ranks();
+    std::sort(ranks.begin(), ranks.end());
+    for(size_t i = 0; i < ranks.size(); i++){
+        QCOMPARE(ranks[i], i);
+    }
+
+    QCOMPARE(ranker.rank(C1), ranker.rank(size_t(0)));
+    QCOMPARE(ranker.rank(O3), ranker.rank(size_t(2)));
+    QCOMPARE(ranker.symmetryClassCount(), size_t(3));
+}
+
+void CanonicalRankerTest::ethane()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    molecule.addBond(C1, C2);
+
+    chemkit::CanonicalRanker ranker(&molecule);
+    QCOMPARE(ranker.symmetryClassCount(), size_t(1));
+    QCOMPARE(ranker.symmetryClass(0), ranker.symmetryClass(1));
+    QVERIFY(ranker.rank(C1) != ranker.rank(C2));
+}
+
+void CanonicalRankerTest::benzene()
+{
+    chemkit::Molecule molecule("c1ccccc1", "smiles");
+    QCOMPARE(molecule.atomCount(), size_t(12));
+
+    chemkit::CanonicalRanker ranker(&molecule);
+
+    // one class for the carbons and one for the hydrogens
+    QCOMPARE(ranker.symmetryClassCount(), size_t(2));
+
+    foreach(const chemkit::Atom *atom, molecule.atoms()){
+        foreach(const chemkit::Atom *other, molecule.atoms()){
+            QCOMPARE(ranker.symmetryClass(atom->index()) == ranker.symmetryClass(other->index()),
+                     atom->atomicNumber() == other->atomicNumber());
+        }
+    }
+}
+
+void CanonicalRankerTest::order()
+{
+    chemkit::Molecule molecule("CC(=O)O", "smiles");
+
+    chemkit::CanonicalRanker ranker(&molecule);
+    std::vector<size_t> order = ranker.order();
+    QCOMPARE(order.size(), molecule.size());
+
+    for(size_t i = 0; i < order.size(); i++){
+        QCOMPARE(ranker.rank(order[i]), i);
+    }
+}
+
+void CanonicalRankerTest::permutation()
+{
+    // build isobutanol with two different atom orders and
+    // check that equivalent atoms receive the same rank
+    chemkit::Molecule a;
+    chemkit::Atom *a1 = a.addAtom("C");
+    chemkit::Atom *a2 = a.addAtom("C");
+    chemkit::Atom *a3 = a.addAtom("C");
+    chemkit::Atom *a4 = a.addAtom("C");
+    chemkit::Atom *a5 = a.addAtom("O");
+    a.addBond(a1, a2);
+    a.addBond(a2, a3);
+    a.addBond(a2, a4);
+    a.addBond(a4, a5);
+
+    chemkit::Molecule b;
+    chemkit::Atom *b5 = b.addAtom("O");
+    chemkit::Atom *b4 = b.addAtom("C");
+    chemkit::Atom *b3 = b.addAtom("C");
+    chemkit::Atom *b2 = b.addAtom("C");
+    chemkit::Atom *b1 = b.addAtom("C");
+    b.addBond(b5, b4);
+    b.addBond(b4, b2);
+    b.addBond(b3, b2);
+    b.addBond(b2, b1);
+
+    chemkit::CanonicalRanker ra(&a);
+    chemkit::CanonicalRanker rb(&b);
+    QCOMPARE(ra.rank(a2), rb.rank(b2));
+    QCOMPARE(ra.rank(a4), rb.rank(b4));
+    QCOMPARE(ra.rank(a5), rb.rank(b5));
+    QCOMPARE(ra.symmetryClass(a1->index()), ra.symmetryClass(a3->index()));
+    QCOMPARE(ra.symmetryClassCount(), rb.symmetryClassCount());
+}
+
+void CanonicalRankerTest::empty()
+{
+    chemkit::Molecule molecule;
+
+    chemkit::CanonicalRanker ranker(&molecule);
+    QCOMPARE(ranker.size(), size_t(0));
+    QCOMPARE(ranker.symmetryClassCount(), size_t(0));
+    QVERIFY(ranker.order().empty());
+}
+
+QTEST_APPLESS_MAIN(CanonicalRankerTest)
@@ -35,6 +35,127 @@
 
 #include "fingerprinttest.h"
 
+#include <chemkit/molecule.h>
 #include <chemkit/fingerprint.h>
 
+namespace {
+
+// Fingerprint which sets the bit for the number of atoms and the
+// bit for the number of bonds in the molecule.
+class SizeFingerprint : public chemkit::Fingerprint
+{
+public:
+    SizeFingerprint()
+        : chemkit::Fingerprint("size")
+    {
+    }
+
+    size_t size() const
+    {
+        return option("size").toSizeT();
+    }
+
+    chemkit::Bitset value(const chemkit::Molecule *molecule) const
+    {
+        chemkit::Bitset fingerprint(size());
+        fingerprint.set(molecule->atomCount() % size());
+        fingerprint.set((molecule->bondCount() + size() / 2) % size());
+        return fingerprint;
+    }
+
+protected:
+    chemkit::Variant defaultOption(const std::string &name) const
+    {
+        if(name == "size"){
+            return 100;
+        }
+
+        return chemkit::Variant();
+    }
+};
+
+chemkit::Molecule* createChain(size_t length)
+{
+    chemkit::Molecule *molecule = new chemkit::Molecule;
+
+    chemkit::Atom *previous = 0;
+    for(size_t i = 0; i < length; i++){
+        chemkit::Atom *atom = molecule->addAtom("C");
+        if(previous){
+            molecule->addBond(previous, atom);
+        }
+        previous = atom;
+    }
+
+    return molecule;
+}
+
+} // end anonymous namespace
+
+void FingerprintTest::options()
+{
+    SizeFingerprint fingerprint;
+    QCOMPARE(fingerprint.size(), size_t(100));
+    QVERIFY(fingerprint.option("radius").isNull());
+
+    fingerprint.setOption("size", 130);
+    QCOMPARE(fingerprint.size(), size_t(130));
+    QCOMPARE(fingerprint.option("size").toInt(), 130);
+}
+
+void FingerprintTest::counts()
+{
+    SizeFingerprint fingerprint;
+
+    chemkit::Molecule *molecule = createChain(4);
+    std::map<size_t, size_t> counts = fingerprint.counts(molecule);
+    QCOMPARE(counts.size(), size_t(2));
+    QCOMPARE(counts[4], size_t(1));
+    QCOMPARE(counts[53], size_t(1));
+    delete molecule;
+}
+
+void FingerprintTest::values()
+{
+    SizeFingerprint fingerprint;
+    fingerprint.setOption("size", 130);
+    const size_t wordCount = 3;
+
+    std::vector<chemkit::Molecule *> molecules;
+    for(size_t i = 0; i < 300; i++){
+        molecules.push_back(createChain(i + 1));
+    }
+
+    // list one of the molecules twice
+    molecules.push_back(molecules[7]);
+
+    std::vector<boost::uint64_t> words;
+    fingerprint.values(molecules, words);
+    QCOMPARE(words.size(), molecules.size() * wordCount);
+
+    for(size_t i = 0; i < molecules.size(); i++){
+        chemkit::Bitset value = fingerprint.value(molecules[i]);
+
+        for(size_t bit = 0; bit < wordCount * 64; bit++){
+            bool set = (words[i * wordCount + bit / 64] >> (bit % 64)) & 1;
+            QCOMPARE(set, bit < value.size() && value[bit]);
+        }
+    }
+
+    // concurrent values are the same as the sequential values
+    for(size_t threadCount = 0; threadCount <= 4; threadCount++){
+        std::vector<boost::uint64_t> concurrentWords;
+        fingerprint.values(molecules, concurrentWords, threadCount);
+        QVERIFY(concurrentWords == words);
+    }
+
+    // empty range
+    fingerprint.values(std::vector<chemkit::Molecule *>(), words);
+    QVERIFY(words.empty());
+
+    for(size_t i = 0; i < 300; i++){
+        delete molecules[i];
+    }
+}
+
 QTEST_APPLESS_MAIN(FingerprintTest)
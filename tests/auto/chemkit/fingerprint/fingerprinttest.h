@@ -43,6 +43,9 @@ class FingerprintTest : public QObject
     Q_OBJECT
 
     private slots:
+        void options();
+        void counts();
+        void values();
 };
 
 #endif // FINGERPRINTTEST_H
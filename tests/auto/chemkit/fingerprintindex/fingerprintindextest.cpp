@@ -0,0 +1,285 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fingerprintindextest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+#include <chemkit/fingerprint.h>
+#include <chemkit/fingerprintindex.h>
+
+namespace {
+
+// Returns a bitset of size bits with roughly one in every density
+// bits set.
+chemkit::Bitset randomBitset(size_t size, int density)
+{
+    chemkit::Bitset bitset(size);
+
+    for(size_t i = 0; i < size; i++){
+        if(std::rand() % density == 0){
+            bitset.set(i);
+        }
+    }
+
+    return bitset;
+}
+
+// Returns a set of fingerprints with a range of densities.
+std::vector<chemkit::Bitset> randomFingerprints(size_t size, size_t count)
+{
+    std::vector<chemkit::Bitset> fingerprints;
+
+    for(size_t i = 0; i < count; i++){
+        fingerprints.push_back(randomBitset(size, 2 + i % 20));
+    }
+
+    return fingerprints;
+}
+
+bool moreSimilar(const chemkit::FingerprintIndex::Match &a, const chemkit::FingerprintIndex::Match &b)
+{
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+
+// Returns the fingerprints with a similarity of at least threshold
+// to query by comparing with each fingerprint.
+std::vector<chemkit::FingerprintIndex::Match> similar(const std::vector<chemkit::Bitset> &fingerprints,
+                                                      const chemkit::Bitset &query,
+                                                      chemkit::Real threshold)
+{
+    std::vector<chemkit::FingerprintIndex::Match> matches;
+
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        chemkit::Real similarity = chemkit::Fingerprint::tanimotoCoefficient(query, fingerprints[i]);
+
+        if(similarity >= threshold){
+            matches.push_back(std::make_pair(i, similarity));
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), moreSimilar);
+
+    return matches;
+}
+
+} // end anonymous namespace
+
+void FingerprintIndexTest::basic()
+{
+    chemkit::FingerprintIndex index;
+    QCOMPARE(index.size(), size_t(1024));
+    QCOMPARE(index.count(), size_t(0));
+    QVERIFY(index.isEmpty());
+    QVERIFY(!index.isMapped());
+
+    chemkit::FingerprintIndex largeIndex(2048);
+    QCOMPARE(largeIndex.size(), size_t(2048));
+}
+
+void FingerprintIndexTest::add()
+{
+    chemkit::FingerprintIndex index(1021);
+
+    chemkit::Bitset a(1021);
+    a.set(1);
+    a.set(5);
+    a.set(1020);
+    QCOMPARE(index.add(a), size_t(0));
+
+    chemkit::PackedFingerprint1024 b;
+    b.set(1);
+    b.set(5);
+    b.set(1023); // past the size of the index
+    QCOMPARE(index.add(b), size_t(1));
+
+    boost::uint64_t words[] = { 0x22, 0x0 };
+    QCOMPARE(index.add(words, 2), size_t(2));
+
+    QCOMPARE(index.count(), size_t(3));
+    QVERIFY(!index.isEmpty());
+
+    std::vector<chemkit::FingerprintIndex::Match> matches = index.similar(a, 0.5);
+    QCOMPARE(matches.size(), size_t(3));
+    QCOMPARE(matches[0].first, size_t(0));
+    QCOMPARE(matches[0].second, chemkit::Real(1.0));
+    QCOMPARE(matches[1].first, size_t(1));
+    QCOMPARE(matches[1].second, chemkit::Real(2.0 / 3.0));
+    QCOMPARE(matches[2].first, size_t(2));
+    QCOMPARE(matches[2].second, chemkit::Real(2.0 / 3.0));
+
+    index.clear();
+    QVERIFY(index.isEmpty());
+    QVERIFY(index.similar(a, 0.5).empty());
+}
+
+void FingerprintIndexTest::similar()
+{
+    std::srand(2012);
+    std::vector<chemkit::Bitset> fingerprints = randomFingerprints(1024, 500);
+
+    chemkit::FingerprintIndex index(1024);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        QCOMPARE(index.add(fingerprints[i]), i);
+    }
+
+    chemkit::Real thresholds[] = { 0.0, 0.1, 0.3, 0.5, 0.8, 1.0 };
+
+    for(size_t i = 0; i < 10; i++){
+        const chemkit::Bitset &query = fingerprints[i * 37];
+
+        for(size_t j = 0; j < 6; j++){
+            std::vector<chemkit::FingerprintIndex::Match> expected = ::similar(fingerprints, query, thresholds[j]);
+            std::vector<chemkit::FingerprintIndex::Match> matches = index.similar(query, thresholds[j]);
+            QVERIFY(matches == expected);
+        }
+    }
+}
+
+void FingerprintIndexTest::nearest()
+{
+    std::srand(2012);
+    std::vector<chemkit::Bitset> fingerprints = randomFingerprints(2048, 400);
+
+    chemkit::FingerprintIndex index(2048);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        index.add(fingerprints[i]);
+    }
+
+    for(size_t i = 0; i < 10; i++){
+        chemkit::Bitset query = randomBitset(2048, 3 + i);
+        std::vector<chemkit::FingerprintIndex::Match> all = ::similar(fingerprints, query, 0);
+
+        for(size_t k = 1; k < 30; k += 7){
+            std::vector<chemkit::FingerprintIndex::Match> expected(all.begin(), all.begin() + k);
+            QVERIFY(index.nearest(query, k) == expected);
+        }
+
+        // only matches above the threshold are returned
+        std::vector<chemkit::FingerprintIndex::Match> matches = index.nearest(query, 1000, 0.3);
+        QVERIFY(matches == ::similar(fingerprints, query, 0.3));
+    }
+
+    QVERIFY(index.nearest(fingerprints[0], 0).empty());
+    QCOMPARE(index.nearest(fingerprints[7], 1)[0].first, size_t(7));
+}
+
+void FingerprintIndexTest::concurrent()
+{
+    std::srand(2012);
+    std::vector<chemkit::Bitset> fingerprints = randomFingerprints(1024, 20000);
+
+    chemkit::FingerprintIndex index(1024);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        index.add(fingerprints[i]);
+    }
+
+    for(size_t i = 0; i < 5; i++){
+        const chemkit::Bitset &query = fingerprints[i * 997];
+
+        QVERIFY(index.similar(query, 0.4, 4) == index.similar(query, 0.4));
+        QVERIFY(index.similar(query, 0.4, 0) == ::similar(fingerprints, query, 0.4));
+        QVERIFY(index.nearest(query, 25, 0, 4) == index.nearest(query, 25));
+        QVERIFY(index.nearest(query, 25, 0.5, 3) == index.nearest(query, 25, 0.5));
+    }
+}
+
+void FingerprintIndexTest::empty()
+{
+    chemkit::FingerprintIndex index;
+
+    // searching an empty index
+    chemkit::Bitset query(1024);
+    query.set(10);
+    QVERIFY(index.similar(query, 0).empty());
+    QVERIFY(index.nearest(query, 5).empty());
+
+    // empty queries do not match anything
+    index.add(query);
+    index.add(chemkit::Bitset(1024));
+    QVERIFY(index.similar(chemkit::Bitset(1024), 0).empty());
+    QVERIFY(index.nearest(chemkit::Bitset(1024), 5).empty());
+    QCOMPARE(index.similar(query, 0).size(), size_t(2));
+}
+
+void FingerprintIndexTest::readWrite()
+{
+    const std::string fileName = "fingerprintindextest.fpi";
+
+    std::srand(2012);
+    std::vector<chemkit::Bitset> fingerprints = randomFingerprints(1021, 300);
+
+    chemkit::FingerprintIndex index(1021);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        index.add(fingerprints[i]);
+    }
+    QVERIFY(index.write(fileName));
+
+    chemkit::FingerprintIndex mappedIndex;
+    QVERIFY(mappedIndex.read(fileName));
+    QVERIFY(mappedIndex.isMapped());
+    QCOMPARE(mappedIndex.size(), size_t(1021));
+    QCOMPARE(mappedIndex.count(), size_t(300));
+
+    for(size_t i = 0; i < 5; i++){
+        const chemkit::Bitset &query = fingerprints[i * 50];
+
+        QVERIFY(mappedIndex.similar(query, 0.3) == index.similar(query, 0.3));
+        QVERIFY(mappedIndex.nearest(query, 10) == index.nearest(query, 10));
+    }
+
+    // adding to a mapped index copies it into memory
+    chemkit::Bitset fingerprint = randomBitset(1021, 4);
+    QCOMPARE(mappedIndex.add(fingerprint), size_t(300));
+    QCOMPARE(mappedIndex.nearest(fingerprint, 1)[0].first, size_t(300));
+    QVERIFY(!mappedIndex.isMapped());
+    QCOMPARE(mappedIndex.count(), size_t(301));
+
+    // invalid files
+    QVERIFY(!mappedIndex.read("missing.fpi"));
+    QVERIFY(!mappedIndex.errorString().empty());
+
+    std::FILE *file = std::fopen(fileName.c_str(), "wb");
+    std::fputs("not an index file, but long enough to hold a header.......", file);
+    std::fclose(file);
+    QVERIFY(!mappedIndex.read(fileName));
+    QCOMPARE(mappedIndex.count(), size_t(301));
+
+    std::remove(fileName.c_str());
+}
+
+QTEST_APPLESS_MAIN(FingerprintIndexTest)
@@ -0,0 +1,181 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "fingerprintindexwritertest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include <chemkit/fingerprintindex.h>
+#include <chemkit/fingerprintindexwriter.h>
+
+namespace {
+
+typedef boost::uint64_t Word;
+
+// Returns count random fingerprints of size bits stored as words.
+std::vector<Word> randomFingerprints(size_t size, size_t count)
+{
+    size_t wordCount = (size + 63) / 64;
+    std::vector<Word> words(count * wordCount, 0);
+
+    for(size_t i = 0; i < count; i++){
+        int density = 2 + std::rand() % 30;
+
+        for(size_t j = 0; j < size; j++){
+            if(std::rand() % density == 0){
+                words[i * wordCount + j / 64] |= Word(1) << (j % 64);
+            }
+        }
+    }
+
+    return words;
+}
+
+// Returns the contents of the file.
+std::string readFile(const std::string &fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
+
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+} // end anonymous namespace
+
+void FingerprintIndexWriterTest::basic()
+{
+    chemkit::FingerprintIndexWriter writer(512);
+    QCOMPARE(writer.size(), size_t(512));
+    QCOMPARE(writer.count(), size_t(0));
+    QCOMPARE(writer.isOpen(), false);
+
+    Word words[8] = {0};
+    writer.reserve(words, 8);
+    QCOMPARE(writer.count(), size_t(1));
+}
+
+void FingerprintIndexWriterTest::write()
+{
+    const std::string fileName = "fingerprintindexwritertest.fpi";
+    const std::string indexFileName = "fingerprintindexwritertest-index.fpi";
+
+    // more fingerprints than fit in a single buffer for each bucket
+    std::srand(2012);
+    size_t wordCount = (1021 + 63) / 64;
+    std::vector<Word> words = randomFingerprints(1021, 3000);
+
+    chemkit::FingerprintIndexWriter writer(1021);
+    chemkit::FingerprintIndex index(1021);
+    for(size_t i = 0; i < 3000; i++){
+        writer.reserve(&words[i * wordCount], wordCount);
+        index.add(&words[i * wordCount], wordCount);
+    }
+    QCOMPARE(writer.count(), size_t(3000));
+
+    QVERIFY(writer.open(fileName));
+    QVERIFY(writer.isOpen());
+    for(size_t i = 0; i < 3000; i++){
+        QVERIFY(writer.write(&words[i * wordCount], wordCount));
+    }
+    QVERIFY(writer.close());
+    QVERIFY(!writer.isOpen());
+
+    // the file is identical to one written by the index
+    QVERIFY(index.write(indexFileName));
+    QVERIFY(readFile(fileName) == readFile(indexFileName));
+
+    chemkit::FingerprintIndex mappedIndex;
+    QVERIFY(mappedIndex.read(fileName));
+    QCOMPARE(mappedIndex.size(), size_t(1021));
+    QCOMPARE(mappedIndex.count(), size_t(3000));
+
+    std::remove(fileName.c_str());
+    std::remove(indexFileName.c_str());
+}
+
+void FingerprintIndexWriterTest::empty()
+{
+    const std::string fileName = "fingerprintindexwritertest.fpi";
+
+    chemkit::FingerprintIndexWriter writer(256);
+    QVERIFY(writer.open(fileName));
+    QVERIFY(writer.close());
+
+    chemkit::FingerprintIndex index;
+    QVERIFY(index.read(fileName));
+    QCOMPARE(index.size(), size_t(256));
+    QCOMPARE(index.count(), size_t(0));
+
+    std::remove(fileName.c_str());
+}
+
+void FingerprintIndexWriterTest::invalid()
+{
+    const std::string fileName = "fingerprintindexwritertest.fpi";
+
+    Word one[1] = {0x1};
+    Word two[1] = {0x3};
+
+    // writing before the file is open
+    chemkit::FingerprintIndexWriter writer(64);
+    writer.reserve(one, 1);
+    QVERIFY(!writer.write(one, 1));
+    QVERIFY(!writer.errorString().empty());
+
+    // writing a fingerprint that was not reserved
+    QVERIFY(writer.open(fileName));
+    QVERIFY(!writer.write(two, 1));
+    QVERIFY(writer.write(one, 1));
+    QVERIFY(!writer.write(one, 1));
+    QVERIFY(writer.close());
+
+    // writing fewer fingerprints than were reserved
+    writer.reserve(one, 1);
+    writer.reserve(two, 1);
+    QVERIFY(writer.open(fileName));
+    QVERIFY(writer.write(one, 1));
+    QVERIFY(!writer.close());
+
+    // opening a file that can not be written
+    QVERIFY(!writer.open("missing/directory/file.fpi"));
+    QVERIFY(!writer.errorString().empty());
+
+    std::remove(fileName.c_str());
+}
+
+QTEST_APPLESS_MAIN(FingerprintIndexWriterTest)
@@ -35,15 +35,60 @@
 
 #include "moleculetest.h"
 
+#include <sstream>
+#include <algorithm>
+
 #include <boost/bind.hpp>
 
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
+#include <chemkit/ring.h>
 #include <chemkit/chemkit.h>
+#include <chemkit/foreach.h>
+#include <chemkit/fragment.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
+#include <chemkit/moleculefile.h>
 #include <chemkit/cartesiancoordinates.h>
 
+const std::string dataPath = "../../../data/";
+
+// returns the sorted atom indices of each ring in the molecule. the
+// rings are sorted and separated by spaces (e.g. "0,1,2 2,3,4,5").
+static std::string ringAtomIndices(const chemkit::Molecule *molecule)
+{
+    std::vector<std::string> rings;
+
+    foreach(const chemkit::Ring *ring, molecule->rings()){
+        std::vector<size_t> indices;
+        foreach(const chemkit::Atom *atom, ring->atoms()){
+            indices.push_back(atom->index());
+        }
+        std::sort(indices.begin(), indices.end());
+
+        std::stringstream ringString;
+        for(size_t i = 0; i < indices.size(); i++){
+            if(i > 0){
+                ringString << ",";
+            }
+            ringString << indices[i];
+        }
+        rings.push_back(ringString.str());
+    }
+
+    std::sort(rings.begin(), rings.end());
+
+    std::string string;
+    for(size_t i = 0; i < rings.size(); i++){
+        if(i > 0){
+            string += " ";
+        }
+        string += rings[i];
+    }
+
+    return string;
+}
+
 void MoleculeTest::name()
 {
     chemkit::Molecule molecule;
@@ -152,6 +197,49 @@ void MoleculeTest::removeAtomIf()
     QCOMPARE(ethanol.formula(), std::string("O"));
 }
 
+void MoleculeTest::removeAtoms()
+{
+    chemkit::Molecule molecule("c1ccccc1CC(=O)O", "smiles");
+    QCOMPARE(molecule.formula(), std::string("C8H8O2"));
+
+    for(size_t i = 0; i < molecule.size(); i++){
+        molecule.atom(i)->setPosition(i, 0, 0);
+    }
+
+    std::vector<chemkit::Atom *> hydrogens;
+    foreach(chemkit::Atom *atom, molecule.atoms()){
+        if(atom->is(chemkit::Atom::Hydrogen)){
+            hydrogens.push_back(atom);
+        }
+    }
+
+    molecule.removeAtoms(hydrogens);
+    QCOMPARE(molecule.formula(), std::string("C8O2"));
+    QCOMPARE(molecule.bondCount(), size_t(10));
+    QCOMPARE(molecule.ringCount(), size_t(1));
+
+    for(size_t i = 0; i < molecule.size(); i++){
+        chemkit::Atom *atom = molecule.atom(i);
+        QCOMPARE(atom->index(), i);
+        QCOMPARE(qRound(atom->position().x()), int(i));
+
+        foreach(const chemkit::Bond *bond, atom->bonds()){
+            QVERIFY(bond->contains(atom));
+        }
+    }
+
+    for(size_t i = 0; i < molecule.bondCount(); i++){
+        QCOMPARE(molecule.bond(i)->index(), i);
+    }
+
+    // remove the benzene ring
+    molecule.removeAtoms(std::vector<chemkit::Atom *>(molecule.atoms().begin(),
+                                                      molecule.atoms().begin() + 6));
+    QCOMPARE(molecule.formula(), std::string("C2O2"));
+    QCOMPARE(molecule.bondCount(), size_t(3));
+    QCOMPARE(molecule.ringCount(), size_t(0));
+}
+
 void MoleculeTest::atom()
 {
     chemkit::Molecule molecule;
@@ -292,6 +380,82 @@ void MoleculeTest::rings()
     cyclopropane.removeAtom(cyclopropane_C2);
     QCOMPARE(size_t(cyclopropane.rings().size()), size_t(0));
     QCOMPARE(cyclopropane.ringCount(), size_t(0));
+
+    // linked and spiro ring systems
+    chemkit::Molecule molecule("C1CC1CCC2CCC23CCCC3", "smiles");
+    QCOMPARE(molecule.ringCount(), size_t(3));
+    QCOMPARE(molecule.rings()[0]->size(), size_t(3));
+    QCOMPARE(molecule.rings()[1]->size(), size_t(4));
+    QCOMPARE(molecule.rings()[2]->size(), size_t(5));
+    QCOMPARE(molecule.atom(3)->isInRing(), false);
+    QCOMPARE(molecule.atom(4)->isInRing(), false);
+    QCOMPARE(molecule.atom(8)->ringCount(), size_t(2));
+
+    // rings are ordered by fragment and then by size
+    chemkit::Molecule fragmented("C1CCCC1.C1CC1.C1CCC1CC2CC2", "smiles");
+    QCOMPARE(fragmented.ringCount(), size_t(4));
+    QCOMPARE(fragmented.rings()[0]->size(), size_t(5));
+    QCOMPARE(fragmented.rings()[1]->size(), size_t(3));
+    QCOMPARE(fragmented.rings()[2]->size(), size_t(3));
+    QCOMPARE(fragmented.rings()[3]->size(), size_t(4));
+    QVERIFY(fragmented.rings()[1]->contains(fragmented.atom(5)));
+    QVERIFY(fragmented.rings()[2]->contains(fragmented.atom(13)));
+}
+
+void MoleculeTest::sssr()
+{
+    // testosterone
+    chemkit::Molecule testosterone("CC12CCC3C(C1CCC2O)CCC4=CC(=O)CCC34C", "smiles");
+    QCOMPARE(ringAtomIndices(&testosterone),
+             std::string("1,2,3,4,5,6 1,6,7,8,9 13,14,15,17,18,19 4,5,11,12,13,19"));
+
+    // fused ring systems with several equal-sized ring choices
+    chemkit::MoleculeFile benzenesFile(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = benzenesFile.read();
+    if(!ok)
+        qDebug() << benzenesFile.errorString().c_str();
+    QVERIFY(ok);
+
+    boost::shared_ptr<chemkit::Molecule> molecule = benzenesFile.molecule(34);
+    QVERIFY(molecule);
+    QCOMPARE(molecule->name(), std::string("2579"));
+    QCOMPARE(ringAtomIndices(molecule.get()),
+             std::string("0,4,5,7,10,14 0,5,10,11,13,14 11,13,17,18,19,20 4,5,6,8,9,12"));
+
+    molecule = benzenesFile.molecule(57);
+    QVERIFY(molecule);
+    QCOMPARE(molecule->name(), std::string("2476"));
+    QCOMPARE(ringAtomIndices(molecule.get()),
+             std::string("0,6,8,15,20 15,19,20,25,26,30 23,27,28 4,5,6,11,14,18 "
+                         "5,6,11,15,16,19 5,6,7,8,12,13 5,6,7,8,9,10"));
+
+    molecule = benzenesFile.molecule(202);
+    QVERIFY(molecule);
+    QCOMPARE(molecule->name(), std::string("2073"));
+    QCOMPARE(ringAtomIndices(molecule.get()),
+             std::string("15,16,18,20,22,23 2,4,6,7,9,11 2,5,6,7,8,12 2,5,6,8,13,14 "
+                         "3,4,9,15,16 4,5,6,10,11"));
+
+    // buckminsterfullerene (the sssr contains all 12 pentagons and
+    // 19 of the 20 hexagons)
+    chemkit::MoleculeFile fullereneFile(dataPath + "buckminsterfullerene.cml");
+    ok = fullereneFile.read();
+    if(!ok)
+        qDebug() << fullereneFile.errorString().c_str();
+    QVERIFY(ok);
+
+    molecule = fullereneFile.molecule();
+    QVERIFY(molecule);
+    QCOMPARE(molecule->ringCount(), size_t(31));
+    QCOMPARE(ringAtomIndices(molecule.get()),
+             std::string("0,1,14,15,56,57 0,1,2,3,4 0,4,5,57,58,59 1,2,11,12,13,14 "
+                         "10,11,12,20,21 12,13,17,18,19,20 13,14,15,16,17 15,16,42,43,55,56 "
+                         "16,17,18,40,41,42 18,19,38,39,40 19,20,21,22,37,38 2,3,8,9,10,11 "
+                         "22,23,35,36,37 23,24,25,26,34,35 26,27,32,33,34 27,28,29,30,31,32 "
+                         "29,30,53,54,58,59 3,4,5,6,7,8 30,31,51,52,53 31,32,33,49,50,51 "
+                         "33,34,35,36,48,49 39,40,41,45,46,47 41,42,43,44,45 43,44,52,53,54,55 "
+                         "44,45,46,50,51,52 46,47,48,49,50 5,6,28,29,59 54,55,56,57,58 "
+                         "6,7,25,26,27,28 7,8,9,24,25 9,10,21,22,23,24"));
 }
 
 void MoleculeTest::distance()
@@ -380,6 +544,29 @@ void MoleculeTest::fragments()
 
     neon.removeAtom(neon.atom(0));
     QCOMPARE(neon.fragmentCount(), size_t(0));
+
+    // join and split two water molecules
+    chemkit::Molecule water;
+    chemkit::Atom *O1 = water.addAtom("O");
+    water.addBond(O1, water.addAtom("H"));
+    water.addBond(O1, water.addAtom("H"));
+    chemkit::Atom *O4 = water.addAtom("O");
+    water.addBond(O4, water.addAtom("H"));
+    water.addBond(O4, water.addAtom("H"));
+    QCOMPARE(water.fragmentCount(), size_t(2));
+    QVERIFY(water.atom(2)->fragment() == O1->fragment());
+    QVERIFY(water.atom(5)->fragment() == O4->fragment());
+    QCOMPARE(O4->fragment()->size(), size_t(3));
+
+    water.addBond(O1, O4);
+    QCOMPARE(water.fragmentCount(), size_t(1));
+    QCOMPARE(O4->fragment()->size(), size_t(6));
+    QVERIFY(O1->fragment()->contains(water.atom(5)));
+
+    water.removeBond(O1, O4);
+    QCOMPARE(water.fragmentCount(), size_t(2));
+    QCOMPARE(O1->fragment()->size(), size_t(3));
+    QVERIFY(!O1->fragment()->contains(water.atom(5)));
 }
 
 void MoleculeTest::isFragmented()
@@ -434,6 +621,67 @@ void MoleculeTest::removeFragment()
     QCOMPARE(molecule.fragmentCount(), size_t(0));
 }
 
+void MoleculeTest::aromaticityModel()
+{
+    chemkit::Molecule benzene("c1ccccc1", "smiles");
+    QCOMPARE(benzene.aromaticityModel(), std::string());
+    QCOMPARE(benzene.atom(0)->isAromatic(), true);
+    QCOMPARE(benzene.bond(0)->isAromatic(), true);
+
+    // changing bond orders updates the aromaticity
+    foreach(chemkit::Bond *bond, benzene.bonds()){
+        bond->setOrder(chemkit::Bond::Single);
+    }
+    QCOMPARE(benzene.atom(0)->isAromatic(), false);
+    QCOMPARE(benzene.bond(0)->isAromatic(), false);
+
+    // the daylight model only checks the elements and their geometry
+    benzene.setAromaticityModel("daylight");
+    QCOMPARE(benzene.aromaticityModel(), std::string("daylight"));
+    QCOMPARE(benzene.atom(0)->isAromatic(), true);
+    QCOMPARE(benzene.bond(0)->isAromatic(), true);
+
+    benzene.setAromaticityModel(std::string());
+    QCOMPARE(benzene.atom(0)->isAromatic(), false);
+}
+
+void MoleculeTest::resultCache()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    QCOMPARE(ethanol.isResultCacheEnabled(), false);
+    QCOMPARE(ethanol.descriptor("atom-count").toInt(), 9);
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(0));
+
+    ethanol.setResultCacheEnabled(true);
+    QCOMPARE(ethanol.isResultCacheEnabled(), true);
+    QCOMPARE(ethanol.descriptor("atom-count").toInt(), 9);
+    QCOMPARE(ethanol.descriptor("atom-count").toInt(), 9);
+    QCOMPARE(ethanol.resultCacheHitCount(), size_t(1));
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(1));
+
+    chemkit::Bitset fingerprint = ethanol.fingerprint("fp2");
+    QVERIFY(ethanol.fingerprint("fp2") == fingerprint);
+    QCOMPARE(ethanol.resultCacheHitCount(), size_t(2));
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(2));
+
+    // changing the molecule discards the cached values
+    chemkit::Atom *atom = ethanol.addAtom("C");
+    QCOMPARE(ethanol.descriptor("atom-count").toInt(), 10);
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(3));
+    ethanol.addBond(ethanol.atom(0), atom);
+    QVERIFY(ethanol.fingerprint("fp2") != fingerprint);
+    QCOMPARE(ethanol.resultCacheHitCount(), size_t(2));
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(4));
+
+    ethanol.clearResultCache();
+    QCOMPARE(ethanol.resultCacheHitCount(), size_t(0));
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(0));
+
+    ethanol.setResultCacheEnabled(false);
+    QCOMPARE(ethanol.descriptor("atom-count").toInt(), 10);
+    QCOMPARE(ethanol.resultCacheMissCount(), size_t(0));
+}
+
 void MoleculeTest::rotate()
 {
     chemkit::Molecule molecule;
@@ -451,4 +699,75 @@ void MoleculeTest::rotate()
     QVERIFY(C3->position().isApprox(chemkit::Vector3(0, 1, 0)));
 }
 
+void MoleculeTest::copy()
+{
+    chemkit::Molecule phenol("c1ccccc1O", "smiles");
+    phenol.setName("phenol");
+    phenol.atom(6)->setMassNumber(18);
+    phenol.atom(0)->setPosition(1, 2, 3);
+
+    chemkit::Molecule copy(phenol);
+    QCOMPARE(copy.name(), std::string("phenol"));
+    QCOMPARE(copy.formula(), phenol.formula());
+    QCOMPARE(copy.bondCount(), phenol.bondCount());
+    QCOMPARE(copy.ringCount(), size_t(1));
+    QCOMPARE(copy.atom(6)->massNumber(), chemkit::Atom::MassNumberType(18));
+    QVERIFY(copy.atom(0)->position().isApprox(chemkit::Point3(1, 2, 3)));
+
+    for(size_t i = 0; i < copy.bondCount(); i++){
+        QVERIFY(copy.bond(i)->molecule() == &copy);
+        QCOMPARE(copy.bond(i)->atom1()->index(), phenol.bond(i)->atom1()->index());
+        QCOMPARE(copy.bond(i)->atom2()->index(), phenol.bond(i)->atom2()->index());
+        QCOMPARE(copy.bond(i)->order(), phenol.bond(i)->order());
+    }
+
+    chemkit::Molecule ethane("CC", "smiles");
+    ethane = phenol;
+    QCOMPARE(ethane.formula(), phenol.formula());
+    QCOMPARE(ethane.ringCount(), size_t(1));
+
+    // copying a molecule without coordinates into a molecule
+    // with coordinates keeps a coordinate for each atom
+    chemkit::Molecule water;
+    water.addAtom(chemkit::Atom::Oxygen);
+    water.addAtom(chemkit::Atom::Hydrogen);
+    water.addAtom(chemkit::Atom::Hydrogen);
+
+    chemkit::Molecule methanol("CO", "smiles");
+    methanol.atom(0)->setPosition(1, 2, 3);
+    methanol = water;
+    QCOMPARE(methanol.atomCount(), size_t(3));
+    QCOMPARE(methanol.coordinates()->size(), size_t(3));
+    QCOMPARE(methanol.atom(2)->position(), chemkit::Point3(0, 0, 0));
+
+    chemkit::Atom *carbon = methanol.addAtom(chemkit::Atom::Carbon);
+    carbon->setPosition(4, 5, 6);
+    QCOMPARE(methanol.coordinates()->size(), size_t(4));
+    QCOMPARE(methanol.atom(0)->position(), chemkit::Point3(0, 0, 0));
+    QVERIFY(carbon->position().isApprox(chemkit::Point3(4, 5, 6)));
+}
+
+void MoleculeTest::move()
+{
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+    chemkit::Molecule phenol("c1ccccc1O", "smiles");
+    chemkit::Atom *O7 = phenol.atom(6);
+
+    chemkit::Molecule moved(std::move(phenol));
+    QVERIFY(phenol.isEmpty());
+    QCOMPARE(moved.formula(), std::string("C6H6O"));
+    QVERIFY(moved.atom(6) == O7);
+    QVERIFY(O7->molecule() == &moved);
+    QVERIFY(O7->bond(0)->molecule() == &moved);
+    QCOMPARE(moved.fragmentCount(), size_t(1));
+
+    chemkit::Molecule ethane("CC", "smiles");
+    ethane = std::move(moved);
+    QVERIFY(moved.isEmpty());
+    QCOMPARE(ethane.formula(), std::string("C6H6O"));
+    QVERIFY(O7->molecule() == &ethane);
+    QCOMPARE(ethane.ringCount(), size_t(1));
+#endif
+}
+
 QTEST_APPLESS_MAIN(MoleculeTest)
@@ -50,12 +50,14 @@ class MoleculeTest : public QObject
         void addAtom();
         void addAtomCopy();
         void removeAtomIf();
+        void removeAtoms();
         void atom();
         void addBond();
         void bond();
         void size();
         void isEmpty();
         void rings();
+        void sssr();
         void distance();
         void center();
         void bondAngle();
@@ -64,7 +66,11 @@ class MoleculeTest : public QObject
         void fragments();
         void isFragmented();
         void removeFragment();
+        void aromaticityModel();
+        void resultCache();
         void rotate();
+        void copy();
+        void move();
 };
 
 #endif // MOLECULETEST_H
@@ -0,0 +1,237 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "moleculehashtest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/moleculehash.h>
+
+void MoleculeHashTest::basic()
+{
+    chemkit::MoleculeHash null;
+    QCOMPARE(null.isNull(), true);
+    QCOMPARE(null.toString(), std::string("00000000000000000000000000000000"));
+
+    chemkit::Molecule molecule("CCO", "smiles");
+    chemkit::MoleculeHash hash(&molecule);
+    QCOMPARE(hash.isNull(), false);
+    QCOMPARE(hash.value(), hash.low());
+    QCOMPARE(hash.toString().size(), size_t(32));
+    QVERIFY(hash == chemkit::MoleculeHash(hash.high(), hash.low()));
+    QVERIFY(hash != null);
+
+    chemkit::Molecule empty;
+    QVERIFY(chemkit::MoleculeHash(&empty) == chemkit::MoleculeHash(&empty));
+}
+
+void MoleculeHashTest::atomOrder()
+{
+    chemkit::Molecule a("CC(=O)Oc1ccccc1C(=O)O", "smiles");
+    chemkit::Molecule b("OC(=O)c1ccccc1OC(C)=O", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&a) == chemkit::MoleculeHash(&b));
+
+    chemkit::Molecule c("C1CCCCC1N", "smiles");
+    chemkit::Molecule d("NC1CCCCC1", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&c) == chemkit::MoleculeHash(&d));
+}
+
+void MoleculeHashTest::structure()
+{
+    // ethanol and dimethyl ether
+    chemkit::Molecule ethanol("CCO", "smiles");
+    chemkit::Molecule ether("COC", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&ethanol) != chemkit::MoleculeHash(&ether));
+
+    // cyclohexane and methylcyclopentane
+    chemkit::Molecule cyclohexane("C1CCCCC1", "smiles");
+    chemkit::Molecule methylcyclopentane("CC1CCCC1", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&cyclohexane) != chemkit::MoleculeHash(&methylcyclopentane));
+
+    // ethene and ethane without hydrogens
+    chemkit::Molecule ethene;
+    ethene.addBond(ethene.addAtom("C"), ethene.addAtom("C"), chemkit::Bond::Double);
+    chemkit::Molecule ethane;
+    ethane.addBond(ethane.addAtom("C"), ethane.addAtom("C"), chemkit::Bond::Single);
+    QVERIFY(chemkit::MoleculeHash(&ethene) != chemkit::MoleculeHash(&ethane));
+}
+
+void MoleculeHashTest::charge()
+{
+    chemkit::Molecule ammonia("N", "smiles");
+    chemkit::Molecule ammonium("[NH4+]", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&ammonia) != chemkit::MoleculeHash(&ammonium));
+}
+
+void MoleculeHashTest::isotope()
+{
+    chemkit::Molecule methane("C", "smiles");
+    chemkit::Molecule labeled("[13CH4]", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&methane) != chemkit::MoleculeHash(&labeled));
+
+    chemkit::Molecule deuterated("C", "smiles");
+    deuterated.atom(1)->setMassNumber(2);
+    QVERIFY(chemkit::MoleculeHash(&methane) != chemkit::MoleculeHash(&deuterated));
+}
+
+void MoleculeHashTest::kekule()
+{
+    // o-xylene with both kekule structures
+    chemkit::Molecule aromatic("Cc1ccccc1C", "smiles");
+    chemkit::Molecule kekule1("CC1=C(C)C=CC=C1", "smiles");
+    chemkit::Molecule kekule2("CC1=CC=CC=C1C", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&aromatic) == chemkit::MoleculeHash(&kekule1));
+    QVERIFY(chemkit::MoleculeHash(&kekule1) == chemkit::MoleculeHash(&kekule2));
+}
+
+void MoleculeHashTest::stereochemistry()
+{
+    chemkit::Molecule r("N[C@@H](C)C(=O)O", "smiles");
+    chemkit::Molecule s("N[C@H](C)C(=O)O", "smiles");
+
+    // stereochemistry is ignored by default
+    QVERIFY(chemkit::MoleculeHash(&r) == chemkit::MoleculeHash(&s));
+
+    QVERIFY(chemkit::MoleculeHash(&r, chemkit::MoleculeHash::IncludeStereochemistry) !=
+            chemkit::MoleculeHash(&s, chemkit::MoleculeHash::IncludeStereochemistry));
+
+    QCOMPARE(chemkit::MoleculeHash::verify(&r, &s), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&r, &s, chemkit::MoleculeHash::IncludeStereochemistry), false);
+    QCOMPARE(chemkit::MoleculeHash::verify(&r, &r, chemkit::MoleculeHash::IncludeStereochemistry), true);
+
+    chemkit::Molecule trans("C/C=C/C", "smiles");
+    chemkit::Molecule cis("C/C=C\\C", "smiles");
+    QCOMPARE(chemkit::MoleculeHash::verify(&trans, &cis), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&trans, &cis, chemkit::MoleculeHash::IncludeStereochemistry), false);
+}
+
+void MoleculeHashTest::stereochemistryOrder()
+{
+    const int flags = chemkit::MoleculeHash::IncludeStereochemistry;
+
+    // d-alanine and l-alanine with the same chirality symbol
+    chemkit::Molecule d("C[C@@H](N)C(=O)O", "smiles");
+    chemkit::Molecule l1("N[C@@H](C)C(=O)O", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&d, flags) != chemkit::MoleculeHash(&l1, flags));
+    QCOMPARE(chemkit::MoleculeHash::verify(&d, &l1, flags), false);
+
+    // l-alanine with different chirality symbols
+    chemkit::Molecule l2("C[C@H](N)C(=O)O", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&l1, flags) == chemkit::MoleculeHash(&l2, flags));
+    QCOMPARE(chemkit::MoleculeHash::verify(&l1, &l2, flags), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&d, &l2, flags), false);
+
+    // l-proline with the chiral atom opening a ring
+    chemkit::Molecule proline1("OC(=O)[C@@H]1CCCN1", "smiles");
+    chemkit::Molecule proline2("C1C[C@H](NC1)C(=O)O", "smiles");
+    chemkit::Molecule proline3("OC(=O)[C@H]1CCCN1", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&proline1, flags) == chemkit::MoleculeHash(&proline2, flags));
+    QCOMPARE(chemkit::MoleculeHash::verify(&proline1, &proline2, flags), true);
+    QVERIFY(chemkit::MoleculeHash(&proline1, flags) != chemkit::MoleculeHash(&proline3, flags));
+    QCOMPARE(chemkit::MoleculeHash::verify(&proline1, &proline3, flags), false);
+
+    // trans-2-butene written in both directions
+    chemkit::Molecule trans1("C/C=C/C", "smiles");
+    chemkit::Molecule trans2("C\\C=C\\C", "smiles");
+    chemkit::Molecule cis("C/C=C\\C", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&trans1, flags) == chemkit::MoleculeHash(&trans2, flags));
+    QCOMPARE(chemkit::MoleculeHash::verify(&trans1, &trans2, flags), true);
+    QVERIFY(chemkit::MoleculeHash(&trans1, flags) != chemkit::MoleculeHash(&cis, flags));
+
+    // chirality on an atom with two identical neighbors is ignored
+    chemkit::Molecule propanol1("C[C@H](C)O", "smiles");
+    chemkit::Molecule propanol2("C[C@@H](C)O", "smiles");
+    QVERIFY(chemkit::MoleculeHash(&propanol1, flags) == chemkit::MoleculeHash(&propanol2, flags));
+    QCOMPARE(chemkit::MoleculeHash::verify(&propanol1, &propanol2, flags), true);
+}
+
+void MoleculeHashTest::verify()
+{
+    chemkit::Molecule a("c1ccccc1O", "smiles");
+    chemkit::Molecule b("Oc1ccccc1", "smiles");
+    chemkit::Molecule c("c1ccccc1N", "smiles");
+    chemkit::Molecule d("Cc1ccccc1", "smiles");
+
+    QCOMPARE(chemkit::MoleculeHash::verify(&a, &b), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&b, &a), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&a, &c), false);
+    QCOMPARE(chemkit::MoleculeHash::verify(&a, &d), false);
+
+    // isotopes and charges in different atom orders
+    chemkit::Molecule labeled1("[13CH3]C(C)O", "smiles");
+    chemkit::Molecule labeled2("OC(C)[13CH3]", "smiles");
+    chemkit::Molecule labeled3("CC([13CH3])O", "smiles");
+    chemkit::Molecule unlabeled("CC(C)O", "smiles");
+    QCOMPARE(chemkit::MoleculeHash::verify(&labeled1, &labeled2), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&labeled1, &labeled3), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&labeled2, &labeled3), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&labeled1, &unlabeled), false);
+
+    chemkit::Molecule glycine1("[NH3+]CC([O-])=O", "smiles");
+    chemkit::Molecule glycine2("O=C([O-])C[NH3+]", "smiles");
+    chemkit::Molecule glycine3("NCC(O)=O", "smiles");
+    QCOMPARE(chemkit::MoleculeHash::verify(&glycine1, &glycine2), true);
+    QCOMPARE(chemkit::MoleculeHash::verify(&glycine1, &glycine3), false);
+
+    chemkit::Molecule empty1;
+    chemkit::Molecule empty2;
+    QCOMPARE(chemkit::MoleculeHash::verify(&empty1, &empty2), true);
+}
+
+void MoleculeHashTest::canonicalForm()
+{
+    const int flags = chemkit::MoleculeHash::IncludeStereochemistry;
+
+    chemkit::Molecule a("OC(=O)[C@@H]1CCCN1", "smiles");
+    chemkit::Molecule b("C1C[C@H](NC1)C(=O)O", "smiles");
+    chemkit::Molecule c("C1C[C@@H](NC1)C(=O)O", "smiles");
+
+    std::vector<boost::uint64_t> formA = chemkit::MoleculeHash::canonicalForm(&a, flags);
+    std::vector<boost::uint64_t> formB = chemkit::MoleculeHash::canonicalForm(&b, flags);
+    std::vector<boost::uint64_t> formC = chemkit::MoleculeHash::canonicalForm(&c, flags);
+    QVERIFY(formA == formB);
+    QVERIFY(formA != formC);
+
+    // without stereochemistry all three are the same
+    QVERIFY(chemkit::MoleculeHash::canonicalForm(&a) == chemkit::MoleculeHash::canonicalForm(&c));
+
+    chemkit::Molecule empty;
+    std::vector<boost::uint64_t> emptyForm = chemkit::MoleculeHash::canonicalForm(&empty);
+    QCOMPARE(emptyForm.size(), size_t(2));
+}
+
+QTEST_APPLESS_MAIN(MoleculeHashTest)
@@ -0,0 +1,132 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "moleculeviewtest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/bond.h>
+#include <chemkit/foreach.h>
+#include <chemkit/molecule.h>
+#include <chemkit/moleculeview.h>
+
+void MoleculeViewTest::basic()
+{
+    chemkit::Molecule molecule;
+    molecule.addAtom("C");
+    molecule.addAtom("O");
+
+    chemkit::MoleculeView view(&molecule);
+    QVERIFY(view.molecule() == &molecule);
+    QCOMPARE(view.size(), size_t(2));
+    QCOMPARE(view.isEmpty(), false);
+}
+
+void MoleculeViewTest::atoms()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *O2 = molecule.addAtom("O");
+    chemkit::Atom *H3 = molecule.addAtom("H");
+    molecule.addBond(C1, O2, chemkit::Bond::Double);
+    molecule.addBond(C1, H3);
+
+    chemkit::MoleculeView view(&molecule);
+    QCOMPARE(view.atomCount(), size_t(3));
+    QCOMPARE(int(view.atomicNumber(0)), 6);
+    QCOMPARE(int(view.atomicNumber(1)), 8);
+    QCOMPARE(int(view.atomicNumber(2)), 1);
+    QCOMPARE(view.is(0, chemkit::Atom::Carbon), true);
+    QCOMPARE(view.is(1, chemkit::Atom::Carbon), false);
+    QCOMPARE(view.valence(0), 3);
+    QCOMPARE(view.valence(1), 2);
+    QCOMPARE(view.isTerminalHydrogen(0), false);
+    QCOMPARE(view.isTerminalHydrogen(2), true);
+}
+
+void MoleculeViewTest::bonds()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *N3 = molecule.addAtom("N");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, N3, chemkit::Bond::Triple);
+
+    chemkit::MoleculeView view(&molecule);
+    QCOMPARE(view.bondCount(), size_t(2));
+    QCOMPARE(view.bondAtom1(0), size_t(0));
+    QCOMPARE(view.bondAtom2(0), size_t(1));
+    QCOMPARE(view.bondAtom1(1), size_t(1));
+    QCOMPARE(view.bondAtom2(1), size_t(2));
+    QCOMPARE(view.otherAtom(1, 2), size_t(1));
+    QCOMPARE(int(view.bondOrder(0)), 1);
+    QCOMPARE(int(view.bondOrder(1)), 3);
+    QCOMPARE(view.isBonded(0, 1), true);
+    QCOMPARE(view.isBonded(0, 2), false);
+    QCOMPARE(view.bondBetween(2, 1), size_t(1));
+    QCOMPARE(view.bondBetween(0, 2), size_t(chemkit::MoleculeView::NullIndex));
+}
+
+void MoleculeViewTest::neighbors()
+{
+    chemkit::Molecule molecule("c1ccccc1O", "smiles");
+    chemkit::MoleculeView view(&molecule);
+    QCOMPARE(view.atomCount(), molecule.atomCount());
+    QCOMPARE(view.bondCount(), molecule.bondCount());
+
+    // the view's neighbors must match those of each atom in order
+    foreach(const chemkit::Atom *atom, molecule.atoms()){
+        QCOMPARE(view.neighborCount(atom->index()), atom->neighborCount());
+
+        size_t i = 0;
+        foreach(size_t neighbor, view.neighbors(atom->index())){
+            QCOMPARE(neighbor, atom->neighbor(i)->index());
+            QCOMPARE(view.bonds(atom->index())[i], atom->bond(i)->index());
+            i++;
+        }
+    }
+}
+
+void MoleculeViewTest::empty()
+{
+    chemkit::Molecule molecule;
+    chemkit::MoleculeView view(&molecule);
+    QCOMPARE(view.isEmpty(), true);
+    QCOMPARE(view.atomCount(), size_t(0));
+    QCOMPARE(view.bondCount(), size_t(0));
+}
+
+QTEST_APPLESS_MAIN(MoleculeViewTest)
@@ -0,0 +1,236 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "packedfingerprinttest.h"
+
+#include <cstdlib>
+
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+#include <chemkit/packedfingerprint.h>
+
+namespace {
+
+// Returns a bitset of size bits with roughly one in every density
+// bits set.
+chemkit::Bitset randomBitset(size_t size, int density)
+{
+    chemkit::Bitset bitset(size);
+
+    for(size_t i = 0; i < size; i++){
+        if(std::rand() % density == 0){
+            bitset.set(i);
+        }
+    }
+
+    return bitset;
+}
+
+} // end anonymous namespace
+
+void PackedFingerprintTest::basic()
+{
+    chemkit::PackedFingerprint1024 fingerprint;
+    QCOMPARE(fingerprint.size(), size_t(1024));
+    QCOMPARE(fingerprint.count(), size_t(0));
+    QVERIFY(fingerprint.isEmpty());
+
+    fingerprint.set(0);
+    fingerprint.set(63);
+    fingerprint.set(64);
+    fingerprint.set(1023);
+    QCOMPARE(fingerprint.count(), size_t(4));
+    QVERIFY(!fingerprint.isEmpty());
+    QVERIFY(fingerprint.test(0));
+    QVERIFY(fingerprint.test(63));
+    QVERIFY(fingerprint.test(64));
+    QVERIFY(!fingerprint.test(65));
+    QVERIFY(fingerprint.test(1023));
+    QCOMPARE(fingerprint.words()[0], boost::uint64_t(0x8000000000000001ULL));
+    QCOMPARE(fingerprint.words()[1], boost::uint64_t(1));
+
+    fingerprint.reset(63);
+    QVERIFY(!fingerprint.test(63));
+    QCOMPARE(fingerprint.count(), size_t(3));
+
+    chemkit::PackedFingerprint1024 copy = fingerprint;
+    QVERIFY(copy == fingerprint);
+    copy.set(500);
+    QVERIFY(copy != fingerprint);
+
+    fingerprint.clear();
+    QVERIFY(fingerprint.isEmpty());
+
+    chemkit::PackedFingerprint2048 large;
+    QCOMPARE(large.size(), size_t(2048));
+    large.set(2047);
+    QCOMPARE(large.count(), size_t(1));
+}
+
+void PackedFingerprintTest::layout()
+{
+    // arrays of packed fingerprints are contiguous and aligned
+    QCOMPARE(sizeof(chemkit::PackedFingerprint1024), size_t(128));
+    QCOMPARE(sizeof(chemkit::PackedFingerprint2048), size_t(256));
+
+    chemkit::PackedFingerprint1024 fingerprints[3];
+    for(size_t i = 0; i < 3; i++){
+        QVERIFY(reinterpret_cast<size_t>(&fingerprints[i]) % 64 == 0);
+    }
+}
+
+void PackedFingerprintTest::bitset()
+{
+    chemkit::Molecule uracil("O=C1NC=CC(=O)N1", "smiles");
+    chemkit::Bitset fp2 = uracil.fingerprint("fp2");
+    QCOMPARE(fp2.size(), size_t(1021));
+
+    chemkit::PackedFingerprint1024 fingerprint(fp2);
+    QCOMPARE(fingerprint.count(), fp2.count());
+    for(size_t i = 0; i < fp2.size(); i++){
+        QCOMPARE(fingerprint.test(i), bool(fp2.test(i)));
+    }
+
+    QVERIFY(fingerprint.toBitset(1021) == fp2);
+    QCOMPARE(fingerprint.toBitset().size(), size_t(1024));
+
+    // bits past the end of the packed fingerprint are ignored
+    chemkit::Bitset large(1030);
+    large.set(3);
+    large.set(1027);
+    chemkit::PackedFingerprint1024 truncated(large);
+    QCOMPARE(truncated.count(), size_t(1));
+    QVERIFY(truncated.test(3));
+}
+
+void PackedFingerprintTest::tanimotoCoefficient()
+{
+    chemkit::PackedFingerprint1024 a;
+    a.set(1);
+    a.set(2);
+    a.set(3);
+    a.set(4);
+
+    chemkit::PackedFingerprint1024 b;
+    b.set(3);
+    b.set(4);
+    b.set(700);
+
+    QCOMPARE(a.tanimotoCoefficient(a), chemkit::Real(1.0));
+    QCOMPARE(a.tanimotoCoefficient(b), chemkit::Real(2.0 / 5.0));
+    QCOMPARE(b.tanimotoCoefficient(a), chemkit::Real(2.0 / 5.0));
+
+    // compare with the bitset implementation
+    std::srand(2012);
+    for(int i = 0; i < 20; i++){
+        chemkit::Bitset x = randomBitset(2048, 5);
+        chemkit::Bitset y = randomBitset(2048, 3);
+
+        size_t intersection = (x & y).count();
+        chemkit::Real expected = chemkit::Real(intersection) / chemkit::Real(x.count() + y.count() - intersection);
+
+        chemkit::PackedFingerprint2048 packedX(x);
+        chemkit::PackedFingerprint2048 packedY(y);
+        QCOMPARE(packedX.tanimotoCoefficient(packedY), expected);
+        QCOMPARE(chemkit::Fingerprint::tanimotoCoefficient(x, y), expected);
+    }
+}
+
+void PackedFingerprintTest::tverskyIndex()
+{
+    chemkit::PackedFingerprint1024 a;
+    a.set(1);
+    a.set(2);
+    a.set(3);
+    a.set(4);
+
+    chemkit::PackedFingerprint1024 b;
+    b.set(3);
+    b.set(4);
+    b.set(700);
+
+    // alpha = beta = 1 is the tanimoto coefficient
+    QCOMPARE(a.tverskyIndex(b, 1, 1), a.tanimotoCoefficient(b));
+
+    // alpha = beta = 0.5 is the dice coefficient
+    QCOMPARE(a.tverskyIndex(b, 0.5, 0.5), chemkit::Real(4.0 / 7.0));
+
+    // alpha = 0, beta = 1 gives the fraction of b's bits in a
+    QCOMPARE(a.tverskyIndex(b, 0, 1), chemkit::Real(2.0 / 3.0));
+    QCOMPARE(a.tverskyIndex(b, 1, 0), chemkit::Real(2.0 / 4.0));
+}
+
+void PackedFingerprintTest::isSubsetOf()
+{
+    chemkit::PackedFingerprint2048 a;
+    a.set(10);
+    a.set(1500);
+
+    chemkit::PackedFingerprint2048 b = a;
+    b.set(11);
+
+    QVERIFY(a.isSubsetOf(a));
+    QVERIFY(a.isSubsetOf(b));
+    QVERIFY(!b.isSubsetOf(a));
+    QVERIFY(chemkit::PackedFingerprint2048().isSubsetOf(a));
+}
+
+void PackedFingerprintTest::tanimotoCoefficients()
+{
+    std::srand(2012);
+
+    chemkit::PackedFingerprint1024 query(randomBitset(1024, 4));
+
+    std::vector<chemkit::PackedFingerprint1024> fingerprints;
+    for(int i = 0; i < 50; i++){
+        fingerprints.push_back(chemkit::PackedFingerprint1024(randomBitset(1024, 4)));
+    }
+    fingerprints.push_back(query);
+
+    std::vector<chemkit::Real> coefficients(fingerprints.size());
+    query.tanimotoCoefficients(&fingerprints[0], fingerprints.size(), &coefficients[0]);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        QCOMPARE(coefficients[i], query.tanimotoCoefficient(fingerprints[i]));
+    }
+    QCOMPARE(coefficients.back(), chemkit::Real(1.0));
+
+    std::vector<chemkit::Real> indices(fingerprints.size());
+    query.tverskyIndices(&fingerprints[0], fingerprints.size(), 0.7, 0.3, &indices[0]);
+    for(size_t i = 0; i < fingerprints.size(); i++){
+        QCOMPARE(indices[i], query.tverskyIndex(fingerprints[i], 0.7, 0.3));
+    }
+}
+
+QTEST_APPLESS_MAIN(PackedFingerprintTest)
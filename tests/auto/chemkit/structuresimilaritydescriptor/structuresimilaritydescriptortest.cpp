@@ -106,4 +106,26 @@ void StructureSimilarityDescriptorTest::value()
     QCOMPARE(qRound(descriptor.value(ethanol.get()).toDouble() * 100), 75);
 }
 
+void StructureSimilarityDescriptorTest::maximumValue()
+{
+    boost::shared_ptr<chemkit::Molecule> ethanol =
+        boost::make_shared<chemkit::Molecule>("CCO", "smiles");
+    QCOMPARE(ethanol->formula(), std::string("C2H6O"));
+
+    boost::shared_ptr<chemkit::Molecule> dimethylEther =
+        boost::make_shared<chemkit::Molecule>("COC", "smiles");
+    QCOMPARE(dimethylEther->formula(), std::string("C2H6O"));
+
+    chemkit::StructureSimilarityDescriptor descriptor(ethanol);
+
+    // same elements so the bound can not reject dimethyl ether
+    QCOMPARE(qRound(descriptor.maximumValue(dimethylEther.get()) * 100), 100);
+    QCOMPARE(qRound(descriptor.value(dimethylEther.get()).toDouble() * 100), 50);
+
+    // the value with a node limit is never more than the exact value
+    descriptor.setNodeLimit(1);
+    QCOMPARE(descriptor.nodeLimit(), size_t(1));
+    QVERIFY(descriptor.value(dimethylEther.get()).toDouble() <= 0.5);
+}
+
 QTEST_APPLESS_MAIN(StructureSimilarityDescriptorTest)
@@ -46,6 +46,7 @@ class StructureSimilarityDescriptorTest : public QObject
         void name();
         void molecule();
         void value();
+        void maximumValue();
 };
 
 #endif // STRUCTURESIMILARITYDESCRIPTORTEST_H
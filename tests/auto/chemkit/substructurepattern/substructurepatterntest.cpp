@@ -0,0 +1,136 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "substructurepatterntest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/molecule.h>
+#include <chemkit/substructurepattern.h>
+#include <chemkit/substructuretarget.h>
+
+void SubstructurePatternTest::basic()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    QCOMPARE(ethanol.size(), size_t(9));
+
+    chemkit::SubstructurePattern pattern(&ethanol, false);
+    QVERIFY(pattern.molecule() == &ethanol);
+    QCOMPARE(pattern.hydrogens(), false);
+    QCOMPARE(pattern.size(), size_t(3));
+    QCOMPARE(pattern.graph().size(), size_t(3));
+    QCOMPARE(pattern.graph().edgeCount(), size_t(2));
+
+    chemkit::SubstructurePattern hydrogenPattern(&ethanol, true);
+    QCOMPARE(hydrogenPattern.hydrogens(), true);
+    QCOMPARE(hydrogenPattern.size(), size_t(9));
+    QCOMPARE(hydrogenPattern.graph().edgeCount(), size_t(8));
+
+    // each atom is at its original index in the target atoms
+    chemkit::SubstructureTarget target(&ethanol);
+    for(size_t i = 0; i < hydrogenPattern.size(); i++){
+        QVERIFY(hydrogenPattern.atoms()[i] == target.atoms(true)[hydrogenPattern.originalIndex(i)]);
+    }
+}
+
+void SubstructurePatternTest::order()
+{
+    // the oxygen is searched first because it is the rarest element
+    chemkit::Molecule ethanol("CCO", "smiles");
+    chemkit::SubstructurePattern pattern(&ethanol, false);
+    QVERIFY(pattern.atoms()[0] == ethanol.atom(2));
+    QVERIFY(pattern.atoms()[1] == ethanol.atom(1));
+    QVERIFY(pattern.atoms()[2] == ethanol.atom(0));
+    QCOMPARE(pattern.originalIndex(0), size_t(2));
+    QCOMPARE(pattern.graph().isAdjacent(0, 1), true);
+    QCOMPARE(pattern.graph().isAdjacent(1, 2), true);
+    QCOMPARE(pattern.graph().isAdjacent(0, 2), false);
+
+    // the carbon with three neighbors is searched first and each
+    // following atom is bonded to an atom searched before it
+    chemkit::Molecule toluene("Cc1ccccc1", "smiles");
+    chemkit::SubstructurePattern toluenePattern(&toluene, false);
+    QVERIFY(toluenePattern.atoms()[0] == toluene.atom(1));
+
+    for(size_t i = 1; i < toluenePattern.size(); i++){
+        bool connected = false;
+
+        for(size_t j = 0; j < i; j++){
+            if(toluenePattern.graph().isAdjacent(i, j)){
+                connected = true;
+            }
+        }
+
+        QVERIFY(connected);
+    }
+}
+
+void SubstructurePatternTest::fragments()
+{
+    // each fragment starts at its most selective atom
+    chemkit::Molecule molecule("CCO.N", "smiles");
+    chemkit::SubstructurePattern pattern(&molecule, false);
+    QCOMPARE(pattern.size(), size_t(4));
+    QCOMPARE(pattern.atoms()[0]->atomicNumber(), 7);
+    QCOMPARE(pattern.atoms()[1]->atomicNumber(), 8);
+    QCOMPARE(pattern.atoms()[2]->atomicNumber(), 6);
+    QCOMPARE(pattern.atoms()[3]->atomicNumber(), 6);
+}
+
+void SubstructurePatternTest::isCompatible()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    chemkit::SubstructurePattern pattern(&ethanol, false);
+
+    // oxygen with one heavy neighbor
+    QCOMPARE(pattern.isCompatible(0, 8, 1), true);
+    QCOMPARE(pattern.isCompatible(0, 8, 2), true);
+    QCOMPARE(pattern.isCompatible(0, 8, 0), false);
+    QCOMPARE(pattern.isCompatible(0, 7, 1), false);
+
+    // carbon with two heavy neighbors
+    QCOMPARE(pattern.isCompatible(1, 6, 2), true);
+    QCOMPARE(pattern.isCompatible(1, 6, 1), false);
+}
+
+void SubstructurePatternTest::empty()
+{
+    chemkit::Molecule molecule;
+    chemkit::SubstructurePattern pattern(&molecule, true);
+    QCOMPARE(pattern.size(), size_t(0));
+    QCOMPARE(pattern.graph().isEmpty(), true);
+}
+
+QTEST_APPLESS_MAIN(SubstructurePatternTest)
@@ -39,8 +39,10 @@
 
 #include <chemkit/atom.h>
 #include <chemkit/bond.h>
+#include <chemkit/moiety.h>
 #include <chemkit/molecule.h>
 #include <chemkit/substructurequery.h>
+#include <chemkit/substructuretarget.h>
 
 void SubstructureQueryTest::molecule()
 {
@@ -201,6 +203,42 @@ void SubstructureQueryTest::maximumMapping()
     QCOMPARE(mapping.size(), size_t(3));
 }
 
+void SubstructureQueryTest::maximumMappingLimits()
+{
+    boost::shared_ptr<chemkit::Molecule> glycine =
+        boost::make_shared<chemkit::Molecule>("C(C(=O)O)N", "smiles");
+    boost::shared_ptr<chemkit::Molecule> phenylalanine =
+        boost::make_shared<chemkit::Molecule>("c1ccc(cc1)C[C@@H](C(=O)O)N", "smiles");
+    boost::shared_ptr<chemkit::Molecule> ethanol =
+        boost::make_shared<chemkit::Molecule>("CCO", "smiles");
+
+    chemkit::SubstructureQuery query(phenylalanine);
+    QCOMPARE(query.nodeLimit(), size_t(0));
+    QCOMPARE(query.timeLimit(), 0);
+    QCOMPARE(query.isApproximateMappingsEnabled(), false);
+
+    // the bound is calculated from the element counts
+    QCOMPARE(query.maximumMappingBound(phenylalanine.get()), size_t(12));
+    QCOMPARE(query.maximumMappingBound(glycine.get()), size_t(5));
+    QCOMPARE(query.maximumMappingBound(ethanol.get()), size_t(3));
+    QCOMPARE(query.maximumMapping(glycine.get()).size(), size_t(5));
+
+    // stopped searches return an empty mapping
+    query.setNodeLimit(3);
+    QCOMPARE(query.nodeLimit(), size_t(3));
+    QCOMPARE(query.maximumMapping(phenylalanine.get()).size(), size_t(0));
+
+    // or the largest mapping found if approximate mappings are enabled
+    query.setApproximateMappingsEnabled(true);
+    size_t size = query.maximumMapping(phenylalanine.get()).size();
+    QVERIFY(size > 0 && size < 12);
+
+    query.setNodeLimit(0);
+    query.setTimeLimit(60000);
+    QCOMPARE(query.timeLimit(), 60000);
+    QCOMPARE(query.maximumMapping(phenylalanine.get()).size(), size_t(12));
+}
+
 void SubstructureQueryTest::matches()
 {
     chemkit::SubstructureQuery query;
@@ -301,4 +339,256 @@ void SubstructureQueryTest::find()
     QCOMPARE(carboxylMoiety.isEmpty(), true);
 }
 
+void SubstructureQueryTest::target()
+{
+    chemkit::Molecule alanine("CC(N)C(=O)O", "smiles");
+    chemkit::SubstructureTarget target(&alanine);
+
+    chemkit::SubstructureQuery query("C(=O)O", "smiles");
+    QCOMPARE(query.matches(target.molecule()), true);
+    QCOMPARE(query.matches(target), true);
+    QVERIFY(query.mapping(target) == query.mapping(&alanine));
+    QCOMPARE(query.find(target).atomCount(), query.find(&alanine).atomCount());
+    QCOMPARE(query.maximumMapping(target).size(), size_t(3));
+
+    query.setFlags(chemkit::SubstructureQuery::CompareHydrogens);
+    QCOMPARE(query.matches(target), false);
+
+    query.setMolecule("[OH]", "smiles");
+    QCOMPARE(query.matches(target), true);
+    QCOMPARE(query.mapping(target).size(), size_t(2));
+
+    query.setMolecule("CS", "smiles");
+    QCOMPARE(query.matches(target), false);
+}
+
+void SubstructureQueryTest::multipleQueries()
+{
+    chemkit::Molecule phenol("c1ccccc1O", "smiles");
+    chemkit::SubstructureTarget target(&phenol);
+
+    chemkit::SubstructureQuery benzene("c1ccccc1", "smiles");
+    chemkit::SubstructureQuery hydroxyl("O", "smiles");
+    chemkit::SubstructureQuery amine("N", "smiles");
+    chemkit::SubstructureQuery empty;
+
+    std::vector<chemkit::SubstructureQuery *> queries;
+    queries.push_back(&benzene);
+    queries.push_back(&hydroxyl);
+    queries.push_back(&amine);
+    queries.push_back(&empty);
+
+    std::vector<bool> matches = chemkit::SubstructureQuery::matches(queries, target);
+    QCOMPARE(matches.size(), size_t(4));
+    QCOMPARE(bool(matches[0]), true);
+    QCOMPARE(bool(matches[1]), true);
+    QCOMPARE(bool(matches[2]), false);
+    QCOMPARE(bool(matches[3]), false);
+
+    queries.clear();
+    QVERIFY(chemkit::SubstructureQuery::matches(queries, target).empty());
+}
+
+void SubstructureQueryTest::findAll()
+{
+    chemkit::Molecule propane("CCC", "smiles");
+
+    chemkit::SubstructureQuery query("CC", "smiles");
+    std::vector<chemkit::Moiety> moieties = query.findAll(&propane);
+    QCOMPARE(moieties.size(), size_t(4));
+    foreach(const chemkit::Moiety &moiety, moieties){
+        QCOMPARE(moiety.atomCount(), size_t(2));
+        QVERIFY(moiety.molecule() == &propane);
+    }
+
+    query.setMolecule("N", "smiles");
+    QCOMPARE(query.findAll(&propane).size(), size_t(0));
+
+    chemkit::SubstructureQuery empty;
+    QCOMPARE(empty.findAll(&propane).size(), size_t(0));
+}
+
+void SubstructureQueryTest::count()
+{
+    chemkit::Molecule phenol("c1ccccc1O", "smiles");
+    chemkit::SubstructureTarget target(&phenol);
+
+    chemkit::SubstructureQuery query("O", "smiles");
+    QCOMPARE(query.count(&phenol), size_t(1));
+    QCOMPARE(query.count(target), size_t(1));
+
+    query.setMolecule("cO", "smiles");
+    QCOMPARE(query.count(target), size_t(1));
+
+    query.setMolecule("C=C", "smiles");
+    QCOMPARE(query.count(target), size_t(6));
+
+    query.setMolecule("c1ccccc1", "smiles");
+    QCOMPARE(query.count(target), size_t(6));
+    QCOMPARE(query.count(target), query.findAll(target).size());
+
+    // chains match rings without matching every ring bond
+    chemkit::Molecule cyclohexane("C1CCCCC1", "smiles");
+    query.setMolecule("CCCCCC", "smiles");
+    QCOMPARE(query.count(&cyclohexane), size_t(12));
+    query.setMolecule("CCCC", "smiles");
+    QCOMPARE(query.count(&cyclohexane), size_t(12));
+
+    query.setMolecule("N", "smiles");
+    QCOMPARE(query.count(target), size_t(0));
+
+    chemkit::SubstructureQuery empty;
+    QCOMPARE(empty.count(target), size_t(0));
+}
+
+void SubstructureQueryTest::screening()
+{
+    chemkit::SubstructureQuery query("c1ccccc1O", "smiles");
+    QCOMPARE(query.isScreeningEnabled(), false);
+    query.setScreeningEnabled(true);
+    QCOMPARE(query.isScreeningEnabled(), true);
+
+    chemkit::Molecule phenol("c1ccccc1O", "smiles");
+    chemkit::Molecule cresol("Cc1ccccc1O", "smiles");
+    chemkit::Molecule toluene("Cc1ccccc1", "smiles");
+    chemkit::Molecule ethanol("CCO", "smiles");
+
+    chemkit::SubstructureTarget phenolTarget(&phenol);
+    chemkit::SubstructureTarget tolueneTarget(&toluene);
+
+    QCOMPARE(query.matches(phenolTarget), true);
+    QCOMPARE(query.matches(tolueneTarget), false);
+    QCOMPARE(query.mapping(phenolTarget).size(), size_t(7));
+    QCOMPARE(query.count(phenolTarget), size_t(1));
+    QCOMPARE(query.count(tolueneTarget), size_t(0));
+    QCOMPARE(query.findAll(tolueneTarget).size(), size_t(0));
+
+    std::vector<chemkit::Molecule *> molecules;
+    molecules.push_back(&phenol);
+    molecules.push_back(&cresol);
+    molecules.push_back(&toluene);
+    molecules.push_back(&ethanol);
+
+    std::vector<chemkit::Molecule *> screenedMatches = query.filter(molecules);
+    QCOMPARE(screenedMatches.size(), size_t(2));
+    QVERIFY(screenedMatches[0] == &phenol);
+    QVERIFY(screenedMatches[1] == &cresol);
+
+    query.setScreeningEnabled(false);
+    QVERIFY(query.filter(molecules) == screenedMatches);
+
+    // the query screen is recalculated when the flags change
+    query.setScreeningEnabled(true);
+    query.setMolecule("C=C", "smiles");
+    QCOMPARE(query.matches(tolueneTarget), true);
+    query.setFlags(chemkit::SubstructureQuery::CompareAromaticity);
+    QCOMPARE(query.matches(tolueneTarget), true);
+    QCOMPARE(query.matches(&ethanol), false);
+
+    // screens stored in the molecules' result caches
+    query.setMolecule("c1ccccc1O", "smiles");
+    query.setFlags(0);
+    foreach(chemkit::Molecule *molecule, molecules){
+        molecule->setResultCacheEnabled(true);
+    }
+    QVERIFY(query.filter(molecules) == screenedMatches);
+    QVERIFY(query.filter(molecules, 2) == screenedMatches);
+    QVERIFY(query.filter(molecules) == screenedMatches);
+
+    toluene.atom(0)->setAtomicNumber(chemkit::Atom::Oxygen);
+    QCOMPARE(query.filter(molecules).size(), size_t(3));
+}
+
+void SubstructureQueryTest::concurrentFilter()
+{
+    const char *formulas[] = { "c1ccccc1O", "Cc1ccccc1", "CCO", "c1ccncc1", "Oc1ccncc1", "CCCO" };
+
+    std::vector<boost::shared_ptr<chemkit::Molecule> > molecules;
+    std::vector<chemkit::Molecule *> inputMolecules;
+
+    for(size_t i = 0; i < 50; i++){
+        molecules.push_back(boost::make_shared<chemkit::Molecule>(formulas[i % 6], "smiles"));
+        inputMolecules.push_back(molecules.back().get());
+    }
+
+    // molecules listed more than once
+    inputMolecules.push_back(molecules[0].get());
+    inputMolecules.push_back(molecules[4].get());
+
+    chemkit::SubstructureQuery query("O", "smiles");
+    std::vector<chemkit::Molecule *> matches = query.filter(inputMolecules);
+    QCOMPARE(matches.size(), size_t(35));
+    QVERIFY(query.filter(inputMolecules, 0) == matches);
+    QVERIFY(query.filter(inputMolecules, 1) == matches);
+    QVERIFY(query.filter(inputMolecules, 4) == matches);
+
+    query.setMolecule("c1ccncc1", "smiles");
+    query.setFlags(chemkit::SubstructureQuery::CompareAromaticity);
+    query.setScreeningEnabled(true);
+    matches = query.filter(inputMolecules);
+    QCOMPARE(matches.size(), size_t(17));
+    QVERIFY(query.filter(inputMolecules, 0) == matches);
+    QVERIFY(query.filter(inputMolecules, 3) == matches);
+
+    std::vector<chemkit::Molecule *> noMolecules;
+    QCOMPARE(query.filter(noMolecules, 4).size(), size_t(0));
+}
+
+void SubstructureQueryTest::modifiedMolecule()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    chemkit::Molecule ethylamine("CCN", "smiles");
+    chemkit::Molecule acetaldehyde("CC=O", "smiles");
+
+    chemkit::SubstructureQuery query("CO", "smiles");
+    query.setScreeningEnabled(true);
+    QCOMPARE(query.matches(&ethanol), true);
+    QCOMPARE(query.matches(&ethylamine), false);
+
+    // change the element of an atom
+    boost::shared_ptr<chemkit::Molecule> molecule = query.molecule();
+    molecule->atom(1)->setAtomicNumber(chemkit::Atom::Nitrogen);
+    QCOMPARE(query.matches(&ethanol), false);
+    QCOMPARE(query.matches(&ethylamine), true);
+    QCOMPARE(query.count(&ethylamine), size_t(1));
+
+    // change the order of a bond
+    molecule->atom(1)->setAtomicNumber(chemkit::Atom::Oxygen);
+    molecule->bond(0)->setOrder(chemkit::Bond::Double);
+    QCOMPARE(query.matches(&ethanol), false);
+    QCOMPARE(query.matches(&acetaldehyde), true);
+
+    // add atoms
+    chemkit::Atom *carbon = molecule->addAtom(chemkit::Atom::Carbon);
+    molecule->addBond(molecule->atom(0), carbon);
+    QCOMPARE(query.matches(&acetaldehyde), true);
+    QCOMPARE(query.findAll(&acetaldehyde).size(), size_t(1));
+
+    carbon = molecule->addAtom(chemkit::Atom::Carbon);
+    molecule->addBond(molecule->atom(0), carbon);
+    QCOMPARE(query.matches(&acetaldehyde), false);
+
+    // remove atoms, leaving only the oxygen
+    chemkit::Atom *oxygen = molecule->atom(1);
+    QCOMPARE(oxygen->is(chemkit::Atom::Oxygen), true);
+    while(molecule->atomCount() > 1){
+        molecule->removeAtom(molecule->atom(0) == oxygen ? molecule->atom(1) : molecule->atom(0));
+    }
+    QCOMPARE(query.matches(&ethanol), true);
+    QCOMPARE(query.matches(&ethylamine), false);
+
+    std::vector<chemkit::Molecule *> molecules;
+    molecules.push_back(&ethanol);
+    molecules.push_back(&ethylamine);
+    molecules.push_back(&acetaldehyde);
+    oxygen->setAtomicNumber(chemkit::Atom::Nitrogen);
+    QCOMPARE(query.filter(molecules, 2).size(), size_t(1));
+
+    // the old molecule is no longer watched after it is replaced
+    query.setMolecule("CN", "smiles");
+    QCOMPARE(query.matches(&ethylamine), true);
+    molecule->clear();
+    QCOMPARE(query.matches(&ethylamine), true);
+}
+
 QTEST_APPLESS_MAIN(SubstructureQueryTest)
@@ -46,8 +46,16 @@ class SubstructureQueryTest : public QObject
         void molecule();
         void mapping();
         void maximumMapping();
+        void maximumMappingLimits();
         void matches();
         void find();
+        void target();
+        void multipleQueries();
+        void findAll();
+        void count();
+        void screening();
+        void concurrentFilter();
+        void modifiedMolecule();
 };
 
 #endif // SUBSTRUCTUREQUERYTEST_H
@@ -0,0 +1,155 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "substructuretargettest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/molecule.h>
+#include <chemkit/substructuretarget.h>
+
+void SubstructureTargetTest::basic()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    QCOMPARE(ethanol.size(), size_t(9));
+
+    chemkit::SubstructureTarget target(&ethanol);
+    QVERIFY(target.molecule() == &ethanol);
+    QCOMPARE(target.atoms(true).size(), size_t(9));
+    QCOMPARE(target.atoms(false).size(), size_t(3));
+
+    for(size_t i = 0; i < target.atoms(true).size(); i++){
+        QVERIFY(target.atoms(true)[i] == ethanol.atom(i));
+    }
+
+    QVERIFY(target.atoms(false)[0] == ethanol.atom(0));
+    QVERIFY(target.atoms(false)[1] == ethanol.atom(1));
+    QVERIFY(target.atoms(false)[2] == ethanol.atom(2));
+}
+
+void SubstructureTargetTest::graph()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    chemkit::SubstructureTarget target(&ethanol);
+
+    const chemkit::Graph<size_t> &graph = target.graph(true);
+    QCOMPARE(graph.size(), size_t(9));
+    QCOMPARE(graph.edgeCount(), size_t(8));
+
+    const chemkit::Graph<size_t> &heavyGraph = target.graph(false);
+    QCOMPARE(heavyGraph.size(), size_t(3));
+    QCOMPARE(heavyGraph.edgeCount(), size_t(2));
+    QCOMPARE(heavyGraph.isAdjacent(0, 1), true);
+    QCOMPARE(heavyGraph.isAdjacent(1, 2), true);
+    QCOMPARE(heavyGraph.isAdjacent(0, 2), false);
+
+    // both atoms in molecular hydrogen are terminal hydrogens
+    chemkit::Molecule hydrogen("[H][H]", "smiles");
+    chemkit::SubstructureTarget hydrogenTarget(&hydrogen);
+    QCOMPARE(hydrogenTarget.atoms(false).size(), size_t(0));
+    QCOMPARE(hydrogenTarget.graph(false).edgeCount(), size_t(0));
+}
+
+void SubstructureTargetTest::empty()
+{
+    chemkit::Molecule molecule;
+    chemkit::SubstructureTarget target(&molecule);
+    QCOMPARE(target.atoms(true).size(), size_t(0));
+    QCOMPARE(target.atoms(false).size(), size_t(0));
+    QCOMPARE(target.graph(true).isEmpty(), true);
+}
+
+void SubstructureTargetTest::screen()
+{
+    chemkit::Molecule ethanol("CCO", "smiles");
+    chemkit::SubstructureTarget ethanolTarget(&ethanol);
+    const chemkit::Bitset &ethanolScreen = ethanolTarget.screen(false, true);
+    QCOMPARE(ethanolScreen.size(), size_t(1024));
+    QVERIFY(ethanolScreen.any());
+
+    // the screen is only calculated once
+    QVERIFY(&ethanolTarget.screen(false, true) == &ethanolScreen);
+
+    // the screen of a substructure is a subset of the screen of
+    // the molecule containing it
+    chemkit::Molecule propanol("CCCO", "smiles");
+    chemkit::SubstructureTarget propanolTarget(&propanol);
+    QVERIFY(ethanolScreen.is_subset_of(propanolTarget.screen(false, true)));
+    QVERIFY(!propanolTarget.screen(false, true).is_subset_of(ethanolScreen));
+
+    chemkit::Molecule methylamine("CN", "smiles");
+    chemkit::SubstructureTarget methylamineTarget(&methylamine);
+    QVERIFY(!methylamineTarget.screen(false, true).is_subset_of(propanolTarget.screen(false, true)));
+
+    // hydrogens are only included in the screens with hydrogens
+    chemkit::Molecule methane("C", "smiles");
+    chemkit::SubstructureTarget methaneTarget(&methane);
+    QVERIFY(methaneTarget.screen(false, true).is_subset_of(propanolTarget.screen(false, true)));
+    QVERIFY(methaneTarget.screen(true, true).is_subset_of(propanolTarget.screen(true, true)));
+    QVERIFY(!methaneTarget.screen(true, true).is_subset_of(methaneTarget.screen(false, true)));
+
+    // without bond orders a double bond matches a single bond
+    chemkit::Molecule ethene("C=C", "smiles");
+    chemkit::SubstructureTarget etheneTarget(&ethene);
+    QVERIFY(!etheneTarget.screen(false, true).is_subset_of(propanolTarget.screen(false, true)));
+    QVERIFY(etheneTarget.screen(false, false).is_subset_of(propanolTarget.screen(false, false)));
+
+    // the number of atoms of each element is included
+    chemkit::Molecule ethyleneGlycol("OCCO", "smiles");
+    chemkit::SubstructureTarget ethyleneGlycolTarget(&ethyleneGlycol);
+    QVERIFY(!ethyleneGlycolTarget.screen(false, true).is_subset_of(propanolTarget.screen(false, true)));
+    QVERIFY(ethanolScreen.is_subset_of(ethyleneGlycolTarget.screen(false, true)));
+
+    // the screen can be calculated without a target
+    QVERIFY(chemkit::SubstructureTarget::screen(&ethanol, false, true) == ethanolScreen);
+    QVERIFY(chemkit::SubstructureTarget::screen(&propanol, true, false) == propanolTarget.screen(true, false));
+
+    chemkit::Molecule empty;
+    QVERIFY(chemkit::SubstructureTarget::screen(&empty, false, true).none());
+
+    // screens are stored in the result cache until the molecule changes
+    chemkit::Molecule butane("CCCC", "smiles");
+    butane.setResultCacheEnabled(true);
+    chemkit::Bitset butaneScreen = chemkit::SubstructureTarget::screen(&butane, false, true);
+    QVERIFY(chemkit::SubstructureTarget::screen(&butane, false, true) == butaneScreen);
+    QVERIFY(!ethanolScreen.is_subset_of(butaneScreen));
+
+    butane.atom(0)->setAtomicNumber(chemkit::Atom::Oxygen);
+    QVERIFY(ethanolScreen.is_subset_of(chemkit::SubstructureTarget::screen(&butane, false, true)));
+    chemkit::SubstructureTarget butanolTarget(&butane);
+    QVERIFY(ethanolScreen.is_subset_of(butanolTarget.screen(false, true)));
+}
+
+QTEST_APPLESS_MAIN(SubstructureTargetTest)
@@ -0,0 +1,197 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+#include "topologicaldistancematrixtest.h"
+
+#include <chemkit/atom.h>
+#include <chemkit/molecule.h>
+#include <chemkit/moleculeview.h>
+#include <chemkit/topologicaldistancematrix.h>
+
+void TopologicalDistanceMatrixTest::basic()
+{
+    chemkit::Molecule molecule;
+    molecule.addAtom("C");
+    molecule.addAtom("O");
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.size(), size_t(2));
+    QCOMPARE(matrix.isEmpty(), false);
+}
+
+// propane with hydrogens on the first carbon only
+//
+//   H4   H5
+//     \ /
+//      C1 - C2 - C3
+//      |
+//      H6
+void TopologicalDistanceMatrixTest::distance()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    chemkit::Atom *H4 = molecule.addAtom("H");
+    chemkit::Atom *H5 = molecule.addAtom("H");
+    chemkit::Atom *H6 = molecule.addAtom("H");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, C3);
+    molecule.addBond(C1, H4);
+    molecule.addBond(C1, H5);
+    molecule.addBond(C1, H6);
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.distance(0, 0), 0);
+    QCOMPARE(matrix.distance(0, 1), 1);
+    QCOMPARE(matrix.distance(0, 2), 2);
+    QCOMPARE(matrix.distance(2, 0), 2);
+    QCOMPARE(matrix.distance(3, 4), 2);
+    QCOMPARE(matrix.distance(3, 2), 3);
+    QCOMPARE(matrix(5, 2), 3);
+}
+
+void TopologicalDistanceMatrixTest::disconnected()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *O1 = molecule.addAtom("O");
+    chemkit::Atom *H2 = molecule.addAtom("H");
+    chemkit::Atom *Na3 = molecule.addAtom("Na");
+    molecule.addBond(O1, H2);
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.distance(0, 1), 1);
+    QCOMPARE(matrix.distance(0, 2), int(chemkit::TopologicalDistanceMatrix::Infinity));
+    QCOMPARE(matrix.distance(2, 1), int(chemkit::TopologicalDistanceMatrix::Infinity));
+    QCOMPARE(matrix.distance(2, 2), 0);
+    QCOMPARE(matrix.eccentricity(Na3->index()), 0);
+}
+
+void TopologicalDistanceMatrixTest::eccentricity()
+{
+    // pentane
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    chemkit::Atom *C4 = molecule.addAtom("C");
+    chemkit::Atom *C5 = molecule.addAtom("C");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, C3);
+    molecule.addBond(C3, C4);
+    molecule.addBond(C4, C5);
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.eccentricity(0), 4);
+    QCOMPARE(matrix.eccentricity(1), 3);
+    QCOMPARE(matrix.eccentricity(2), 2);
+    QCOMPARE(matrix.diameter(), 4);
+    QCOMPARE(matrix.radius(), 2);
+}
+
+void TopologicalDistanceMatrixTest::eccentricities()
+{
+    // pentane and a sodium atom
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    chemkit::Atom *C4 = molecule.addAtom("C");
+    chemkit::Atom *C5 = molecule.addAtom("C");
+    molecule.addAtom("Na");
+    molecule.addBond(C1, C2);
+    molecule.addBond(C2, C3);
+    molecule.addBond(C3, C4);
+    molecule.addBond(C4, C5);
+
+    std::vector<int> eccentricities =
+        chemkit::TopologicalDistanceMatrix::eccentricities(chemkit::MoleculeView(&molecule));
+    QCOMPARE(eccentricities.size(), size_t(6));
+    QCOMPARE(eccentricities[0], 4);
+    QCOMPARE(eccentricities[1], 3);
+    QCOMPARE(eccentricities[2], 2);
+    QCOMPARE(eccentricities[3], 3);
+    QCOMPARE(eccentricities[4], 4);
+    QCOMPARE(eccentricities[5], 0);
+
+    // matches the values from the matrix
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    for(size_t i = 0; i < matrix.size(); i++){
+        QCOMPARE(eccentricities[i], matrix.eccentricity(i));
+    }
+
+    chemkit::Molecule empty;
+    QCOMPARE(chemkit::TopologicalDistanceMatrix::eccentricities(chemkit::MoleculeView(&empty)).size(), size_t(0));
+}
+
+void TopologicalDistanceMatrixTest::molecule()
+{
+    chemkit::Molecule molecule;
+    chemkit::Atom *C1 = molecule.addAtom("C");
+    chemkit::Atom *C2 = molecule.addAtom("C");
+    molecule.addBond(C1, C2);
+
+    // the matrix is shared until the structure changes
+    const chemkit::TopologicalDistanceMatrix *matrix = molecule.topologicalDistanceMatrix();
+    QCOMPARE(matrix->size(), size_t(2));
+    QVERIFY(molecule.topologicalDistanceMatrix() == matrix);
+
+    C1->setPosition(1, 2, 3);
+    QVERIFY(molecule.topologicalDistanceMatrix() == matrix);
+
+    chemkit::Atom *C3 = molecule.addAtom("C");
+    QCOMPARE(molecule.topologicalDistanceMatrix()->size(), size_t(3));
+    QCOMPARE(molecule.topologicalDistanceMatrix()->distance(0, 2), int(chemkit::TopologicalDistanceMatrix::Infinity));
+
+    molecule.addBond(C2, C3);
+    QCOMPARE(molecule.topologicalDistanceMatrix()->distance(0, 2), 2);
+
+    molecule.removeBond(C1, C2);
+    QCOMPARE(molecule.topologicalDistanceMatrix()->distance(0, 2), int(chemkit::TopologicalDistanceMatrix::Infinity));
+}
+
+void TopologicalDistanceMatrixTest::empty()
+{
+    chemkit::Molecule molecule;
+
+    chemkit::TopologicalDistanceMatrix matrix(&molecule);
+    QCOMPARE(matrix.size(), size_t(0));
+    QCOMPARE(matrix.isEmpty(), true);
+    QCOMPARE(matrix.diameter(), 0);
+    QCOMPARE(matrix.radius(), 0);
+}
+
+QTEST_APPLESS_MAIN(TopologicalDistanceMatrixTest)
@@ -0,0 +1,271 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "fpsreadertest.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include <boost/make_shared.hpp>
+
+#include <chemkit/molecule.h>
+#include <chemkit/fpsreader.h>
+#include <chemkit/moleculefile.h>
+#include <chemkit/fingerprintindex.h>
+#include <chemkit/moleculefileformat.h>
+
+namespace {
+
+const char *fpsData =
+    "#FPS1\n"
+    "#num_bits=16\n"
+    "#type=Example/1\n"
+    "#software=chemkit\n"
+    "0100\tfirst\n"
+    "8001\tsecond\textra\n"
+    "ffff\tthird\n"
+    "0000\n";
+
+} // end anonymous namespace
+
+void FpsReaderTest::header()
+{
+    std::istringstream input(fpsData);
+
+    chemkit::FpsReader reader;
+    QVERIFY(!reader.isOpen());
+    QVERIFY(reader.open(input));
+    QVERIFY(reader.isOpen());
+    QCOMPARE(reader.size(), size_t(16));
+    QCOMPARE(reader.type(), std::string("Example/1"));
+    QCOMPARE(reader.headerValue("software"), std::string("chemkit"));
+    QCOMPARE(reader.headerValue("date"), std::string());
+
+    reader.close();
+    QVERIFY(!reader.isOpen());
+}
+
+void FpsReaderTest::read()
+{
+    std::istringstream input(fpsData);
+
+    chemkit::FpsReader reader;
+    QVERIFY(reader.open(input));
+
+    chemkit::Bitset fingerprint;
+    std::string identifier;
+
+    QVERIFY(reader.read(fingerprint, identifier));
+    QCOMPARE(fingerprint.size(), size_t(16));
+    QCOMPARE(fingerprint.count(), size_t(1));
+    QVERIFY(fingerprint.test(0));
+    QCOMPARE(identifier, std::string("first"));
+
+    // bytes are stored with their lowest bit first
+    QVERIFY(reader.read(fingerprint, identifier));
+    QCOMPARE(fingerprint.count(), size_t(2));
+    QVERIFY(fingerprint.test(7));
+    QVERIFY(fingerprint.test(8));
+    QCOMPARE(identifier, std::string("second"));
+
+    QVERIFY(reader.read(fingerprint, identifier));
+    QCOMPARE(fingerprint.count(), size_t(16));
+    QCOMPARE(identifier, std::string("third"));
+
+    QVERIFY(reader.read(fingerprint, identifier));
+    QCOMPARE(fingerprint.count(), size_t(0));
+    QCOMPARE(identifier, std::string());
+
+    QVERIFY(!reader.read(fingerprint, identifier));
+    QCOMPARE(reader.errorString(), std::string());
+}
+
+void FpsReaderTest::readWords()
+{
+    std::istringstream input(fpsData);
+
+    chemkit::FpsReader reader;
+    QVERIFY(reader.open(input));
+
+    boost::uint64_t words[1];
+    std::string identifier;
+
+    QVERIFY(reader.read(words, 1, identifier));
+    QCOMPARE(words[0], boost::uint64_t(0x0001));
+    QVERIFY(reader.read(words, 1, identifier));
+    QCOMPARE(words[0], boost::uint64_t(0x0180));
+    QVERIFY(reader.read(words, 1, identifier));
+    QCOMPARE(words[0], boost::uint64_t(0xffff));
+
+    // bits past the end of the words are ignored
+    chemkit::PackedFingerprint1024 fingerprint;
+    std::istringstream largeInput("#FPS1\n#num_bits=2048\n" + std::string(512, 'f') + "\tlarge\n");
+    QVERIFY(reader.open(largeInput));
+    QVERIFY(reader.read(fingerprint.words(), chemkit::PackedFingerprint1024::WordCount, identifier));
+    QCOMPARE(fingerprint.count(), size_t(1024));
+    QCOMPARE(identifier, std::string("large"));
+}
+
+void FpsReaderTest::noHeader()
+{
+    // without a num_bits header the size is given by the first record
+    std::istringstream input("0f0f0f\tA\r\n00ff00\tB\r\n");
+
+    chemkit::FpsReader reader;
+    QVERIFY(reader.open(input));
+    QCOMPARE(reader.size(), size_t(24));
+    QCOMPARE(reader.type(), std::string());
+
+    chemkit::Bitset fingerprint;
+    std::string identifier;
+    QVERIFY(reader.read(fingerprint, identifier));
+    QCOMPARE(fingerprint.count(), size_t(12));
+    QCOMPARE(identifier, std::string("A"));
+    QVERIFY(reader.read(fingerprint, identifier));
+    QCOMPARE(fingerprint.count(), size_t(8));
+    QVERIFY(fingerprint.test(8));
+    QCOMPARE(identifier, std::string("B"));
+    QVERIFY(!reader.read(fingerprint, identifier));
+}
+
+void FpsReaderTest::invalid()
+{
+    chemkit::FpsReader reader;
+    chemkit::Bitset fingerprint;
+    std::string identifier;
+
+    QVERIFY(!reader.open("missing.fps"));
+    QVERIFY(!reader.errorString().empty());
+
+    std::istringstream badHeader("#FPS2\n#num_bits=16\n0000\tA\n");
+    QVERIFY(!reader.open(badHeader));
+
+    std::istringstream badSize("#FPS1\n#num_bits=sixteen\n");
+    QVERIFY(!reader.open(badSize));
+
+    std::istringstream badLength("#FPS1\n#num_bits=16\n000000\tA\n");
+    QVERIFY(reader.open(badLength));
+    QVERIFY(!reader.read(fingerprint, identifier));
+    QVERIFY(!reader.errorString().empty());
+
+    std::istringstream badHex("#FPS1\n#num_bits=16\n00zz\tA\n");
+    QVERIFY(reader.open(badHex));
+    QVERIFY(!reader.read(fingerprint, identifier));
+    QVERIFY(!reader.errorString().empty());
+}
+
+void FpsReaderTest::roundTrip()
+{
+    // write an fps file with the fps plugin and read it back
+    const char *formulas[] = { "CCO", "c1ccccc1O", "O=C1NC=CC(=O)N1" };
+
+    chemkit::MoleculeFile file;
+    for(size_t i = 0; i < 3; i++){
+        file.addMolecule(boost::make_shared<chemkit::Molecule>(formulas[i], "smiles"));
+    }
+
+    QVERIFY(file.setFormat("fps"));
+    file.format()->setOption("fingerprint", "fp2");
+
+    std::stringstream data;
+    QVERIFY(file.write(data));
+
+    chemkit::FpsReader reader;
+    QVERIFY(reader.open(data));
+    QCOMPARE(reader.size(), size_t(1021));
+    QCOMPARE(reader.type(), std::string("chemkit-FP2/1"));
+
+    chemkit::Bitset fingerprint;
+    std::string identifier;
+    for(size_t i = 0; i < 3; i++){
+        QVERIFY(reader.read(fingerprint, identifier));
+        QVERIFY(fingerprint == file.molecule(i)->fingerprint("fp2"));
+        QCOMPARE(identifier, file.molecule(i)->formula());
+    }
+    QVERIFY(!reader.read(fingerprint, identifier));
+}
+
+void FpsReaderTest::convert()
+{
+    const std::string fileName = "fpsreadertest.fpi";
+
+    std::istringstream input(fpsData);
+
+    chemkit::FpsReader reader;
+    QVERIFY(reader.open(input));
+
+    std::vector<std::string> identifiers;
+    QVERIFY(reader.convert(fileName, &identifiers));
+    QCOMPARE(identifiers.size(), size_t(4));
+    QCOMPARE(identifiers[1], std::string("second"));
+
+    chemkit::FingerprintIndex index;
+    QVERIFY(index.read(fileName));
+    QCOMPARE(index.size(), size_t(16));
+    QCOMPARE(index.count(), size_t(4));
+
+    chemkit::Bitset query(16);
+    query.set(7);
+    query.set(8);
+    std::vector<chemkit::FingerprintIndex::Match> matches = index.nearest(query, 2);
+    QCOMPARE(matches.size(), size_t(2));
+    QCOMPARE(matches[0].first, size_t(1));
+    QCOMPARE(matches[0].second, chemkit::Real(1.0));
+    QCOMPARE(matches[1].first, size_t(2));
+    QCOMPARE(matches[1].second, chemkit::Real(2.0 / 16.0));
+
+    // only the remaining fingerprints are converted
+    std::istringstream remainingInput(fpsData);
+    QVERIFY(reader.open(remainingInput));
+
+    chemkit::Bitset fingerprint;
+    std::string identifier;
+    QVERIFY(reader.read(fingerprint, identifier));
+
+    identifiers.clear();
+    QVERIFY(reader.convert(fileName, &identifiers));
+    QCOMPARE(identifiers.size(), size_t(3));
+    QCOMPARE(identifiers[0], std::string("second"));
+
+    QVERIFY(index.read(fileName));
+    QCOMPARE(index.count(), size_t(3));
+    matches = index.nearest(query, 1);
+    QCOMPARE(matches[0].first, size_t(0));
+    QCOMPARE(matches[0].second, chemkit::Real(1.0));
+
+    std::remove(fileName.c_str());
+}
+
+QTEST_APPLESS_MAIN(FpsReaderTest)
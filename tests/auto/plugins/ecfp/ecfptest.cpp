@@ -0,0 +1,203 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+#include "ecfptest.h"
+
+#include <boost/range/algorithm.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <chemkit/foreach.h>
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+
+void EcfpTest::initTestCase()
+{
+    // verify that the ecfp plugin registered itself correctly
+    QVERIFY(boost::count(chemkit::Fingerprint::fingerprints(), "ecfp") == 1);
+}
+
+void EcfpTest::name()
+{
+    chemkit::Fingerprint *fingerprint = chemkit::Fingerprint::create("ecfp");
+    QVERIFY(fingerprint != 0);
+    QCOMPARE(fingerprint->name(), std::string("ecfp"));
+    delete fingerprint;
+}
+
+void EcfpTest::size()
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create("ecfp"));
+    QVERIFY(fingerprint != 0);
+    QCOMPARE(fingerprint->size(), size_t(1024));
+    QCOMPARE(fingerprint->option("radius").toInt(), 2);
+
+    chemkit::Molecule molecule("CCO", "smiles");
+    QCOMPARE(fingerprint->value(&molecule).size(), size_t(1024));
+
+    fingerprint->setOption("size", 2048);
+    QCOMPARE(fingerprint->size(), size_t(2048));
+    QCOMPARE(fingerprint->value(&molecule).size(), size_t(2048));
+}
+
+void EcfpTest::counts()
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create("ecfp"));
+    QVERIFY(fingerprint != 0);
+
+    // every atom in benzene has the same environment so each of
+    // the three iterations contributes one identifier six times
+    chemkit::Molecule benzene("c1ccccc1", "smiles");
+    std::map<size_t, size_t> counts = fingerprint->counts(&benzene);
+    QCOMPARE(counts.size(), size_t(3));
+    for(std::map<size_t, size_t>::const_iterator i = counts.begin(); i != counts.end(); ++i){
+        QCOMPARE(i->second, size_t(6));
+    }
+
+    // the two carbons in propane share their environment
+    chemkit::Molecule propane("CCC", "smiles");
+    fingerprint->setOption("radius", 0);
+    counts = fingerprint->counts(&propane);
+    QCOMPARE(counts.size(), size_t(2));
+
+    size_t total = 0;
+    for(std::map<size_t, size_t>::const_iterator i = counts.begin(); i != counts.end(); ++i){
+        total += i->second;
+    }
+    QCOMPARE(total, size_t(3));
+}
+
+void EcfpTest::radius()
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create("ecfp"));
+    QVERIFY(fingerprint != 0);
+
+    chemkit::Molecule molecule("c1ccccc1CC(=O)O", "smiles");
+
+    // identifiers from smaller radii are kept at larger radii
+    std::map<size_t, size_t> previous;
+    for(int radius = 0; radius <= 3; radius++){
+        fingerprint->setOption("radius", radius);
+        std::map<size_t, size_t> counts = fingerprint->counts(&molecule);
+        QVERIFY(counts.size() > previous.size());
+
+        for(std::map<size_t, size_t>::const_iterator i = previous.begin(); i != previous.end(); ++i){
+            QVERIFY(counts.count(i->first) == 1);
+        }
+
+        previous = counts;
+    }
+}
+
+void EcfpTest::value()
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create("ecfp"));
+    QVERIFY(fingerprint != 0);
+
+    // the folded bits are the identifiers modulo the size
+    chemkit::Molecule molecule("CN1C=NC2=C1C(=O)N(C(=O)N2C)C", "smiles");
+    fingerprint->setOption("size", 512);
+    std::map<size_t, size_t> counts = fingerprint->counts(&molecule);
+    chemkit::Bitset value = fingerprint->value(&molecule);
+    QCOMPARE(value.size(), size_t(512));
+
+    chemkit::Bitset expected(512);
+    for(std::map<size_t, size_t>::const_iterator i = counts.begin(); i != counts.end(); ++i){
+        expected.set(i->first % 512);
+    }
+    QVERIFY(value == expected);
+
+    // an empty molecule has no bits set
+    chemkit::Molecule empty;
+    QCOMPARE(fingerprint->value(&empty).count(), size_t(0));
+    QVERIFY(fingerprint->counts(&empty).empty());
+}
+
+void EcfpTest::similarity()
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create("ecfp"));
+    QVERIFY(fingerprint != 0);
+
+    // the same molecule written with a different atom order
+    chemkit::Molecule a("CCO", "smiles");
+    chemkit::Molecule b("OCC", "smiles");
+    QVERIFY(fingerprint->value(&a) == fingerprint->value(&b));
+    QVERIFY(fingerprint->counts(&a) == fingerprint->counts(&b));
+
+    chemkit::Molecule c("CCCO", "smiles");
+    chemkit::Real similarity = chemkit::Fingerprint::tanimotoCoefficient(fingerprint->value(&a),
+                                                                         fingerprint->value(&c));
+    QVERIFY(similarity > 0.0 && similarity < 1.0);
+}
+
+void EcfpTest::values()
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create("ecfp"));
+    QVERIFY(fingerprint != 0);
+    fingerprint->setOption("size", 2000);
+
+    const char *formulas[] = {
+        "CCO",
+        "c1ccccc1O",
+        "O=C1NC=CC(=O)N1",
+        "CN1C=NC2=C1C(=O)N(C(=O)N2C)C",
+        "c1ccc2c(c1)c(c[nH]2)C[C@@H](C(=O)O)N"
+    };
+
+    std::vector<chemkit::Molecule *> molecules;
+    for(size_t i = 0; i < 100; i++){
+        molecules.push_back(new chemkit::Molecule(formulas[i % 5], "smiles"));
+    }
+
+    std::vector<boost::uint64_t> words;
+    fingerprint->values(molecules, words, 0);
+    QCOMPARE(words.size(), molecules.size() * 32);
+
+    for(size_t i = 0; i < molecules.size(); i++){
+        chemkit::Bitset value = fingerprint->value(molecules[i]);
+
+        chemkit::Bitset bits(2000);
+        for(size_t bit = 0; bit < 2000; bit++){
+            bits[bit] = (words[i * 32 + bit / 64] >> (bit % 64)) & 1;
+        }
+
+        QVERIFY(bits == value);
+    }
+
+    foreach(chemkit::Molecule *molecule, molecules){
+        delete molecule;
+    }
+}
+
+QTEST_APPLESS_MAIN(EcfpTest)
@@ -39,6 +39,7 @@
 #include <boost/range/algorithm.hpp>
 
 #include <chemkit/atom.h>
+#include <chemkit/bond.h>
 #include <chemkit/ring.h>
 #include <chemkit/molecule.h>
 #include <chemkit/lineformat.h>
@@ -49,6 +50,57 @@
 
 const std::string dataPath = "../../../data/";
 
+namespace {
+
+// Returns a copy of molecule with its atoms and bonds added in an
+// order that is shuffled using seed.
+chemkit::Molecule* shuffledCopy(const chemkit::Molecule *molecule, unsigned int seed)
+{
+    // simple linear congruential generator so that the shuffles are
+    // the same on every platform
+    std::vector<size_t> atoms(molecule->atomCount());
+    std::vector<size_t> bonds(molecule->bondCount());
+    for(size_t i = 0; i < atoms.size(); i++){
+        atoms[i] = i;
+    }
+    for(size_t i = 0; i < bonds.size(); i++){
+        bonds[i] = i;
+    }
+
+    for(size_t i = atoms.size(); i > 1; i--){
+        seed = seed * 1103515245 + 12345;
+        std::swap(atoms[i - 1], atoms[(seed >> 16) % i]);
+    }
+    for(size_t i = bonds.size(); i > 1; i--){
+        seed = seed * 1103515245 + 12345;
+        std::swap(bonds[i - 1], bonds[(seed >> 16) % i]);
+    }
+
+    chemkit::Molecule *copy = new chemkit::Molecule;
+    std::vector<chemkit::Atom *> copyAtoms(atoms.size());
+
+    foreach(size_t index, atoms){
+        copyAtoms[index] = copy->addAtom(molecule->atom(index)->element());
+    }
+
+    foreach(size_t index, bonds){
+        const chemkit::Bond *bond = molecule->bond(index);
+        chemkit::Atom *a = copyAtoms[bond->atom1()->index()];
+        chemkit::Atom *b = copyAtoms[bond->atom2()->index()];
+
+        seed = seed * 1103515245 + 12345;
+        if((seed >> 16) & 1){
+            std::swap(a, b);
+        }
+
+        copy->addBond(a, b, bond->order());
+    }
+
+    return copy;
+}
+
+} // end anonymous namespace
+
 void SmilesTest::initTestCase()
 {
     // verify that the smiles plugin registered itself correctly
@@ -1243,6 +1295,14 @@ void SmilesTest::isotope()
     QCOMPARE(molecule->formula(), std::string("U"));
     QCOMPARE(molecule->atom(0)->massNumber(), chemkit::Atom::MassNumberType(238));
 
+    delete molecule;
+
+    // ring closure numbers are not mass numbers
+    molecule = format->read("C1CC1[NH2]");
+    QVERIFY(molecule);
+    QCOMPARE(molecule->formula(), std::string("C3H7N"));
+    QCOMPARE(molecule->atom(3)->massNumber(), chemkit::Atom::MassNumberType(14));
+
     delete molecule;
     delete format;
 }
@@ -1264,6 +1324,82 @@ void SmilesTest::kekulize()
     delete format;
 }
 
+void SmilesTest::canonical()
+{
+    chemkit::LineFormat *format = chemkit::LineFormat::create("smiles");
+    QVERIFY(format);
+
+    // default is false
+    QCOMPARE(format->option("canonical").toBool(), false);
+
+    chemkit::Molecule ethanol1("CCO", "smiles");
+    chemkit::Molecule ethanol2("OCC", "smiles");
+    QVERIFY(format->write(&ethanol1) != format->write(&ethanol2));
+
+    format->setOption("canonical", true);
+    QCOMPARE(format->write(&ethanol1), format->write(&ethanol2));
+
+    chemkit::Molecule phenol1("c1ccccc1O", "smiles");
+    chemkit::Molecule phenol2("Oc1ccccc1", "smiles");
+    QCOMPARE(format->write(&phenol1), format->write(&phenol2));
+
+    chemkit::Molecule alanine1("CC(N)C(=O)O", "smiles");
+    chemkit::Molecule alanine2("OC(=O)C(C)N", "smiles");
+    QCOMPARE(format->write(&alanine1), format->write(&alanine2));
+
+    // canonical output does not depend on the order of the atoms and
+    // bonds, including for disconnected and symmetric molecules whose
+    // atoms can not all be distinguished by their neighbors
+    std::vector<chemkit::Molecule *> molecules;
+    molecules.push_back(new chemkit::Molecule("C1CC1.C1CCCCC1", "smiles"));
+    molecules.push_back(new chemkit::Molecule("C1CCC1.C1CCCCC1", "smiles"));
+    molecules.push_back(new chemkit::Molecule("C1CCCC1.C1CCCCC1", "smiles"));
+    molecules.push_back(new chemkit::Molecule("O.O.C1CC1.C1CCC1", "smiles"));
+    molecules.push_back(new chemkit::Molecule("c1ccc2ccccc2c1", "smiles"));
+    molecules.push_back(new chemkit::Molecule("CC(C)(C)c1ccc(cc1)C(C)(C)C", "smiles"));
+
+    // the frucht graph (a cubic graph with no symmetry)
+    const int frucht[] = { -5, -2, -4, 2, 5, -2, 2, 5, -2, -5, 4, 2 };
+    chemkit::Molecule *fruchtGraph = new chemkit::Molecule;
+    for(int i = 0; i < 12; i++){
+        fruchtGraph->addAtom(chemkit::Atom::Carbon);
+    }
+    for(int i = 0; i < 12; i++){
+        fruchtGraph->addBond(fruchtGraph->atom(i), fruchtGraph->atom((i + 1) % 12));
+
+        int j = (i + frucht[i] + 12) % 12;
+        if(i < j){
+            fruchtGraph->addBond(fruchtGraph->atom(i), fruchtGraph->atom(j));
+        }
+    }
+    QCOMPARE(fruchtGraph->bondCount(), size_t(18));
+    molecules.push_back(fruchtGraph);
+
+    foreach(chemkit::Molecule *molecule, molecules){
+        std::string smiles = format->write(molecule);
+
+        for(unsigned int seed = 1; seed <= 50; seed++){
+            chemkit::Molecule *copy = shuffledCopy(molecule, seed);
+            QCOMPARE(format->write(copy), smiles);
+            delete copy;
+        }
+
+        delete molecule;
+    }
+
+    chemkit::Molecule a("C1CC1.C1CCCCC1", "smiles");
+    chemkit::Molecule b("C1CCCCC1.C1CC1", "smiles");
+    QCOMPARE(format->write(&a), format->write(&b));
+
+    // canonical output can be read back
+    chemkit::Molecule *molecule = format->read(format->write(&phenol1));
+    QVERIFY(molecule);
+    QCOMPARE(molecule->formula(), phenol1.formula());
+    delete molecule;
+
+    delete format;
+}
+
 void SmilesTest::quadrupleBond()
 {
     chemkit::LineFormat *format = chemkit::LineFormat::create("smiles");
@@ -161,6 +161,7 @@ class SmilesTest : public QObject
         void addHydrogens();
         void isotope();
         void kekulize();
+        void canonical();
         void quadrupleBond();
 
         // invalid tests
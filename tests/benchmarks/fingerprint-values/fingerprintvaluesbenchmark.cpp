@@ -0,0 +1,164 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2012 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+// This benchmark measures the performance of calculating fingerprints
+// for a large set of molecules one at a time with value() and as a
+// single block with values(). The molecules are copies of the
+// molecules in the pubchem_416_benzenes.sdf file replicated to 100000
+// records.
+
+#include "fingerprintvaluesbenchmark.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include <chemkit/bond.h>
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+#include <chemkit/moleculefile.h>
+
+const std::string dataPath = "../../data/";
+
+namespace {
+
+// number of records in the replicated data set
+const size_t recordCount = 100000;
+
+std::vector<chemkit::Molecule *> molecules;
+
+// Returns the total number of bits set in the block of fingerprints.
+size_t bitCount(const std::vector<boost::uint64_t> &words)
+{
+    size_t count = 0;
+
+    foreach(boost::uint64_t word, words){
+        for(; word; word &= word - 1){
+            count++;
+        }
+    }
+
+    return count;
+}
+
+void benchmarkValue(const std::string &name)
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create(name));
+    QVERIFY(fingerprint != 0);
+
+    size_t count = 0;
+
+    QBENCHMARK {
+        count = 0;
+
+        foreach(const chemkit::Molecule *molecule, molecules){
+            count += fingerprint->value(molecule).count();
+        }
+    }
+
+    qDebug() << name.c_str() << "bits set:" << count;
+}
+
+void benchmarkValues(const std::string &name)
+{
+    boost::scoped_ptr<chemkit::Fingerprint> fingerprint(chemkit::Fingerprint::create(name));
+    QVERIFY(fingerprint != 0);
+
+    std::vector<boost::uint64_t> words;
+
+    QBENCHMARK {
+        fingerprint->values(molecules, words, 0);
+    }
+
+    QCOMPARE(words.size(), recordCount * ((fingerprint->size() + 63) / 64));
+    qDebug() << name.c_str() << "bits set:" << bitCount(words);
+}
+
+} // end anonymous namespace
+
+void FingerprintValuesBenchmark::initTestCase()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(file.moleculeCount(), size_t(416));
+
+    // each record is a separate copy so that no lazily perceived
+    // properties (such as rings) are shared between records
+    for(size_t i = 0; i < recordCount; i++){
+        const chemkit::Molecule *molecule = file.molecule(i % file.moleculeCount()).get();
+
+        molecules.push_back(new chemkit::Molecule(*molecule));
+    }
+
+    // perceive rings and aromaticity before the benchmarks so that
+    // they only measure the fingerprint calculations
+    foreach(const chemkit::Molecule *molecule, molecules){
+        if(molecule->bondCount() > 0){
+            molecule->bond(0)->isAromatic();
+        }
+    }
+}
+
+void FingerprintValuesBenchmark::cleanupTestCase()
+{
+    foreach(chemkit::Molecule *molecule, molecules){
+        delete molecule;
+    }
+
+    molecules.clear();
+}
+
+void FingerprintValuesBenchmark::ecfpValue()
+{
+    benchmarkValue("ecfp");
+}
+
+void FingerprintValuesBenchmark::ecfpValues()
+{
+    benchmarkValues("ecfp");
+}
+
+void FingerprintValuesBenchmark::fp2Value()
+{
+    benchmarkValue("fp2");
+}
+
+void FingerprintValuesBenchmark::fp2Values()
+{
+    benchmarkValues("fp2");
+}
+
+QTEST_APPLESS_MAIN(FingerprintValuesBenchmark)
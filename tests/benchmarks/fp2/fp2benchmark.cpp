@@ -0,0 +1,99 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+// This benchmark measures the performance of calculating the FP2
+// fingerprint for a set of small molecules and for a peptide
+// containing each of the amino acids.
+
+#include "fp2benchmark.h"
+
+#include <chemkit/molecule.h>
+#include <chemkit/fingerprint.h>
+#include <chemkit/moleculefile.h>
+
+const std::string dataPath = "../../data/";
+
+// total number of bits set in the fingerprints
+const size_t moleculesBitCount = 48873;
+const size_t proteinBitCount = 270;
+
+void Fp2Benchmark::molecules()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+    QCOMPARE(file.moleculeCount(), size_t(416));
+
+    chemkit::Fingerprint *fingerprint = chemkit::Fingerprint::create("fp2");
+    QVERIFY(fingerprint != 0);
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+            count += fingerprint->value(molecule.get()).count();
+        }
+
+        QCOMPARE(count, moleculesBitCount);
+    }
+
+    delete fingerprint;
+}
+
+void Fp2Benchmark::protein()
+{
+    chemkit::MoleculeFile file(dataPath + "alphabet.mol2");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    const boost::shared_ptr<chemkit::Molecule> &protein = file.molecule();
+    QVERIFY(protein != 0);
+
+    chemkit::Fingerprint *fingerprint = chemkit::Fingerprint::create("fp2");
+    QVERIFY(fingerprint != 0);
+
+    QBENCHMARK {
+        chemkit::Bitset value = fingerprint->value(protein.get());
+        QCOMPARE(value.count(), proteinBitCount);
+    }
+
+    delete fingerprint;
+}
+
+QTEST_APPLESS_MAIN(Fp2Benchmark)
@@ -0,0 +1,147 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+// This benchmark measures the time it takes to read a file and the
+// time it takes to destroy all of the molecules read from it. Most of
+// the time spent in both is creating and destroying the atoms and
+// bonds.
+//
+// The read benchmarks only measure reading the file. The destroy
+// benchmarks read a number of copies of the file before timing and
+// then only measure destroying them, the reported time is for all
+// of the copies.
+//
+// The benzenes benchmarks read the 416 molecules in the
+// pubchem_416_benzenes.sdf file and the ubiquitin benchmarks read
+// the protein ubiquitin (PDB ID: 1UBQ) which contains 602 atoms.
+
+#include "readfilesbenchmark.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <chemkit/foreach.h>
+#include <chemkit/polymer.h>
+#include <chemkit/molecule.h>
+#include <chemkit/polymerfile.h>
+#include <chemkit/moleculefile.h>
+
+const std::string dataPath = "../../data/";
+
+// number of files destroyed by the destroy benchmarks
+const size_t destroyCount = 20;
+
+namespace {
+
+chemkit::MoleculeFile* readBenzenes()
+{
+    chemkit::MoleculeFile *file = new chemkit::MoleculeFile(dataPath + "pubchem_416_benzenes.sdf");
+    bool ok = file->read();
+    if(!ok)
+        qDebug() << file->errorString().c_str();
+
+    return file;
+}
+
+chemkit::PolymerFile* readUbiquitin()
+{
+    chemkit::PolymerFile *file = new chemkit::PolymerFile(dataPath + "1UBQ.pdb");
+    bool ok = file->read();
+    if(!ok)
+        qDebug() << file->errorString().c_str();
+
+    return file;
+}
+
+} // end anonymous namespace
+
+void ReadFilesBenchmark::benzenesRead()
+{
+    // the files are kept until after the benchmark so that
+    // destroying them is not included in the time
+    std::vector<boost::shared_ptr<chemkit::MoleculeFile> > files;
+
+    QBENCHMARK {
+        boost::shared_ptr<chemkit::MoleculeFile> file(readBenzenes());
+        QCOMPARE(file->moleculeCount(), size_t(416));
+        files.push_back(file);
+    }
+}
+
+void ReadFilesBenchmark::benzenesDestroy()
+{
+    std::vector<chemkit::MoleculeFile *> files;
+    for(size_t i = 0; i < destroyCount; i++){
+        files.push_back(readBenzenes());
+        QCOMPARE(files.back()->moleculeCount(), size_t(416));
+    }
+
+    QBENCHMARK_ONCE {
+        foreach(chemkit::MoleculeFile *file, files){
+            delete file;
+        }
+    }
+}
+
+void ReadFilesBenchmark::ubiquitinRead()
+{
+    // the files are kept until after the benchmark so that
+    // destroying them is not included in the time
+    std::vector<boost::shared_ptr<chemkit::PolymerFile> > files;
+
+    QBENCHMARK {
+        boost::shared_ptr<chemkit::PolymerFile> file(readUbiquitin());
+        QVERIFY(file->polymer());
+        QCOMPARE(file->polymer()->size(), size_t(602));
+        files.push_back(file);
+    }
+}
+
+void ReadFilesBenchmark::ubiquitinDestroy()
+{
+    std::vector<chemkit::PolymerFile *> files;
+    for(size_t i = 0; i < destroyCount; i++){
+        files.push_back(readUbiquitin());
+        QVERIFY(files.back()->polymer());
+    }
+
+    QBENCHMARK_ONCE {
+        foreach(chemkit::PolymerFile *file, files){
+            delete file;
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(ReadFilesBenchmark)
@@ -0,0 +1,195 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+// This benchmark measures the performance of substructure searching
+// with and without screening on a set of common functional groups
+// and ring systems.
+
+#include "substructurescreeningbenchmark.h"
+
+#include <boost/make_shared.hpp>
+
+#include <chemkit/molecule.h>
+#include <chemkit/moleculefile.h>
+#include <chemkit/substructurequery.h>
+#include <chemkit/substructuretarget.h>
+
+const std::string dataPath = "../../data/";
+
+namespace {
+
+const char *queryFormulas[] = {
+    "c1ccccc1O",
+    "C(=O)O",
+    "NC=O",
+    "c1ccncc1",
+    "Cl",
+    "C1CCNCC1",
+    "c1ccc2ccccc2c1",
+    "C#N",
+    "c1ccsc1",
+    "c1ccc(cc1)-c1ccccc1"
+};
+
+const size_t queryCount = sizeof(queryFormulas) / sizeof(queryFormulas[0]);
+
+// total number of molecules matched by the queries
+const size_t matchCount = 680;
+
+std::vector<chemkit::Molecule *> readMolecules(chemkit::MoleculeFile &file)
+{
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+
+    std::vector<chemkit::Molecule *> molecules;
+    foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, file.molecules()){
+        molecules.push_back(molecule.get());
+    }
+
+    return molecules;
+}
+
+} // end anonymous namespace
+
+void SubstructureScreeningBenchmark::unscreened()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    std::vector<chemkit::Molecule *> molecules = readMolecules(file);
+    QVERIFY(!molecules.empty());
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        for(size_t i = 0; i < queryCount; i++){
+            chemkit::SubstructureQuery query(queryFormulas[i], "smiles");
+            count += query.filter(molecules).size();
+        }
+
+        QCOMPARE(count, matchCount);
+    }
+}
+
+void SubstructureScreeningBenchmark::screened()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    std::vector<chemkit::Molecule *> molecules = readMolecules(file);
+    QVERIFY(!molecules.empty());
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        for(size_t i = 0; i < queryCount; i++){
+            chemkit::SubstructureQuery query(queryFormulas[i], "smiles");
+            query.setScreeningEnabled(true);
+            count += query.filter(molecules).size();
+        }
+
+        QCOMPARE(count, matchCount);
+    }
+}
+
+void SubstructureScreeningBenchmark::screenedResultCache()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    std::vector<chemkit::Molecule *> molecules = readMolecules(file);
+    QVERIFY(!molecules.empty());
+
+    // each molecule's screen is calculated once and reused by the
+    // other queries
+    foreach(chemkit::Molecule *molecule, molecules){
+        molecule->setResultCacheEnabled(true);
+    }
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        for(size_t i = 0; i < queryCount; i++){
+            chemkit::SubstructureQuery query(queryFormulas[i], "smiles");
+            query.setScreeningEnabled(true);
+            count += query.filter(molecules).size();
+        }
+
+        QCOMPARE(count, matchCount);
+    }
+}
+
+void SubstructureScreeningBenchmark::screenedTargets()
+{
+    chemkit::MoleculeFile file(dataPath + "pubchem_416_benzenes.sdf");
+    std::vector<chemkit::Molecule *> molecules = readMolecules(file);
+    QVERIFY(!molecules.empty());
+
+    std::vector<boost::shared_ptr<chemkit::SubstructureTarget> > targets;
+    foreach(const chemkit::Molecule *molecule, molecules){
+        targets.push_back(boost::make_shared<chemkit::SubstructureTarget>(molecule));
+    }
+
+    // number of targets rejected by the screens
+    size_t screenedCount = 0;
+
+    for(size_t i = 0; i < queryCount; i++){
+        chemkit::SubstructureQuery query(queryFormulas[i], "smiles");
+        chemkit::SubstructureTarget queryTarget(query.molecule().get());
+        const chemkit::Bitset &screen = queryTarget.screen(false, true);
+
+        foreach(const boost::shared_ptr<chemkit::SubstructureTarget> &target, targets){
+            if(!screen.is_subset_of(target->screen(false, true))){
+                screenedCount++;
+            }
+        }
+    }
+
+    qDebug() << "screened out" << screenedCount << "of" << queryCount * targets.size() << "searches";
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        for(size_t i = 0; i < queryCount; i++){
+            chemkit::SubstructureQuery query(queryFormulas[i], "smiles");
+            query.setScreeningEnabled(true);
+
+            foreach(const boost::shared_ptr<chemkit::SubstructureTarget> &target, targets){
+                if(query.matches(*target)){
+                    count++;
+                }
+            }
+        }
+
+        QCOMPARE(count, matchCount);
+    }
+}
+
+QTEST_APPLESS_MAIN(SubstructureScreeningBenchmark)
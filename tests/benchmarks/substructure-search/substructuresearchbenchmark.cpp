@@ -0,0 +1,143 @@
+/******************************************************************************
+**
+** Copyright (C) 2009-2011 Kyle Lutz <kyle.r.lutz@gmail.com>
+** All rights reserved.
+**
+** This file is a part of the chemkit project. For more information
+** see <http://www.chemkit.org>.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+**   * Redistributions of source code must retain the above copyright
+**     notice, this list of conditions and the following disclaimer.
+**   * Redistributions in binary form must reproduce the above copyright
+**     notice, this list of conditions and the following disclaimer in the
+**     documentation and/or other materials provided with the distribution.
+**   * Neither the name of the chemkit project nor the names of its
+**     contributors may be used to endorse or promote products derived
+**     from this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**
+******************************************************************************/
+
+
+// This benchmark measures the performance of substructure searching
+// with the molecules from the substructure-search validation test.
+// Each molecule is searched for in every other molecule and a set of
+// amino acid side chains are searched for in a protein.
+
+#include "substructuresearchbenchmark.h"
+
+#include <boost/make_shared.hpp>
+
+#include <chemkit/molecule.h>
+#include <chemkit/moleculefile.h>
+#include <chemkit/substructurequery.h>
+#include <chemkit/substructuretarget.h>
+
+const std::string dataPath = "../../data/";
+
+namespace {
+
+const char *moleculeFormulas[] = {
+    "InChI=1/C6H6/c1-2-4-6-5-3-1/h1-6H",
+    "InChI=1/C4H10/c1-3-4-2/h3-4H2,1-2H3",
+    "InChI=1/C3H6/c1-2-3-1/h1-3H2",
+    "InChI=1/C2H6/c1-2/h1-2H3",
+    "InChI=1/C2H6O/c1-2-3/h3H,2H2,1H3",
+    "InChI=1/C8H7N/c1-2-4-8-7(3-1)5-6-9-8/h1-6,9H",
+    "InChI=1/CH4/h1H4",
+    "InChI=1/CH4O/c1-2/h2H,1H3",
+    "InChI=1/C3H8/c1-3-2/h3H2,1-2H3",
+    "InChI=1/C6H6O/c7-6-4-2-1-3-5-6/h1-5,7H"
+};
+
+const size_t moleculeCount = sizeof(moleculeFormulas) / sizeof(moleculeFormulas[0]);
+
+// number of molecule pairs where the first is a substructure of the second
+const size_t moleculeMatchCount = 34;
+
+const char *sideChainFormulas[] = {
+    "InChI=1/C8H7N/c1-2-4-8-7(3-1)5-6-9-8/h1-6,9H",
+    "InChI=1/C6H6O/c7-6-4-2-1-3-5-6/h1-5,7H",
+    "InChI=1/C4H9N/c1-2-4-5-3-1/h5H,1-4H2",
+    "InChI=1/CH5N3/c2-1(3)4/h(H5,2,3,4)/f/h2H,3-4H2",
+    "InChI=1/C5H13N/c1-2-3-4-5-6/h2-6H2,1H3",
+    "InChI=1/C6H13NO/c1-3-5(2)6(7)4-8/h4-6H,3,7H2,1-2H3",
+    "InChI=1/C2H6S/c1-2-3/h3H,2H2,1H3",
+    "InChI=1/C4H10S/c1-3-4-5-2/h3-4H2,1-2H3"
+};
+
+const size_t sideChainCount = sizeof(sideChainFormulas) / sizeof(sideChainFormulas[0]);
+
+// total number of occurrences of the side chains in the protein
+const size_t sideChainOccurrenceCount = 30;
+
+} // end anonymous namespace
+
+void SubstructureSearchBenchmark::molecules()
+{
+    std::vector<boost::shared_ptr<chemkit::Molecule> > molecules;
+    for(size_t i = 0; i < moleculeCount; i++){
+        molecules.push_back(boost::make_shared<chemkit::Molecule>(moleculeFormulas[i], "inchi"));
+    }
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        foreach(const boost::shared_ptr<chemkit::Molecule> &molecule, molecules){
+            chemkit::SubstructureQuery query(molecule);
+
+            foreach(const boost::shared_ptr<chemkit::Molecule> &target, molecules){
+                if(query.matches(target.get())){
+                    count++;
+                }
+            }
+        }
+
+        QCOMPARE(count, moleculeMatchCount);
+    }
+}
+
+void SubstructureSearchBenchmark::protein()
+{
+    chemkit::MoleculeFile file(dataPath + "alphabet.mol2");
+    bool ok = file.read();
+    if(!ok)
+        qDebug() << file.errorString().c_str();
+    QVERIFY(ok);
+
+    const boost::shared_ptr<chemkit::Molecule> &molecule = file.molecule();
+    QVERIFY(molecule != 0);
+
+    chemkit::SubstructureTarget target(molecule.get());
+
+    QBENCHMARK {
+        size_t count = 0;
+
+        for(size_t i = 0; i < sideChainCount; i++){
+            chemkit::SubstructureQuery query(sideChainFormulas[i], "inchi");
+            query.setFlags(chemkit::SubstructureQuery::CompareAromaticity);
+
+            QVERIFY(query.matches(target));
+            count += query.count(target);
+        }
+
+        QCOMPARE(count, sideChainOccurrenceCount);
+    }
+}
+
+QTEST_APPLESS_MAIN(SubstructureSearchBenchmark)